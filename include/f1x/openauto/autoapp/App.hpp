@@ -20,11 +20,13 @@
 
 #include <f1x/aasdk/USB/IUSBHub.hpp>
 #include <f1x/aasdk/USB/IConnectedAccessoriesEnumerator.hpp>
-#include <f1x/aasdk/USB/USBWrapper.hpp>
+#include <f1x/aasdk/USB/IUSBWrapper.hpp>
 #include <f1x/aasdk/TCP/ITCPWrapper.hpp>
 #include <f1x/aasdk/TCP/ITCPEndpoint.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
 #include <f1x/openauto/autoapp/Service/IAndroidAutoEntityEventHandler.hpp>
 #include <f1x/openauto/autoapp/Service/IAndroidAutoEntityFactory.hpp>
+#include <f1x/openauto/autoapp/TCP/IAutoConnector.hpp>
 
 namespace f1x
 {
@@ -38,10 +40,12 @@ class App: public service::IAndroidAutoEntityEventHandler, public std::enable_sh
 public:
     typedef std::shared_ptr<App> Pointer;
 
-    App(boost::asio::io_service& ioService, aasdk::usb::USBWrapper& usbWrapper, aasdk::tcp::ITCPWrapper& tcpWrapper, service::IAndroidAutoEntityFactory& androidAutoEntityFactory,
-        aasdk::usb::IUSBHub::Pointer usbHub, aasdk::usb::IConnectedAccessoriesEnumerator::Pointer connectedAccessoriesEnumerator);
+    App(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, aasdk::usb::IUSBWrapper& usbWrapper, aasdk::tcp::ITCPWrapper& tcpWrapper, service::IAndroidAutoEntityFactory& androidAutoEntityFactory,
+        aasdk::usb::IUSBHub::Pointer usbHub, aasdk::usb::IConnectedAccessoriesEnumerator::Pointer connectedAccessoriesEnumerator,
+        tcp::IAutoConnector::Pointer autoConnector);
 
     void waitForUSBDevice();
+    void autoConnect(tcp::IAutoConnector::Addresses addresses);
     void start(aasdk::tcp::ITCPEndpoint::SocketPointer socket);
     void stop();
     void onAndroidAutoQuit() override;
@@ -52,16 +56,26 @@ private:
     void waitForDevice();
     void aoapDeviceHandler(aasdk::usb::DeviceHandle deviceHandle);
     void onUSBHubError(const aasdk::error::Error& error);
+    void startAutoConnect();
+    void cancelAutoConnect();
+    void onAutoConnectError(const aasdk::error::Error& error);
+    void onAutoConnectTimerExpired(const boost::system::error_code& error);
 
     boost::asio::io_service& ioService_;
-    aasdk::usb::USBWrapper& usbWrapper_;
+    configuration::IConfiguration::Pointer configuration_;
+    aasdk::usb::IUSBWrapper& usbWrapper_;
     aasdk::tcp::ITCPWrapper& tcpWrapper_;
     boost::asio::io_service::strand strand_;
     service::IAndroidAutoEntityFactory& androidAutoEntityFactory_;
     aasdk::usb::IUSBHub::Pointer usbHub_;
     aasdk::usb::IConnectedAccessoriesEnumerator::Pointer connectedAccessoriesEnumerator_;
+    tcp::IAutoConnector::Pointer autoConnector_;
+    tcp::IAutoConnector::Addresses autoConnectAddresses_;
+    boost::asio::deadline_timer autoConnectTimer_;
     service::IAndroidAutoEntity::Pointer androidAutoEntity_;
     bool isStopped_;
+
+    static constexpr time_t cAutoConnectRetryInterval = 5000;
 };
 
 }
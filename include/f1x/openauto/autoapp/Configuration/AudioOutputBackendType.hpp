@@ -30,7 +30,8 @@ namespace configuration
 enum class AudioOutputBackendType
 {
     RTAUDIO,
-    QT
+    QT,
+    ALSA
 };
 
 }
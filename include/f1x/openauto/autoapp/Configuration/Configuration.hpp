@@ -18,6 +18,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <boost/property_tree/ini_parser.hpp>
 #include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
 
@@ -39,6 +42,11 @@ public:
     void reset() override;
     void save() override;
 
+    void subscribe(const std::vector<std::string>& keys, IConfigurationObserver::Pointer observer) override;
+    void unsubscribe(IConfigurationObserver::Pointer observer) override;
+    ConfigurationSnapshot::Pointer getSnapshot() const override;
+    uint64_t getVersion() const override;
+
     void setHandednessOfTrafficType(HandednessOfTrafficType value) override;
     HandednessOfTrafficType getHandednessOfTrafficType() const override;
     void showClock(bool value) override;
@@ -54,11 +62,29 @@ public:
     int32_t getOMXLayerIndex() const override;
     void setVideoMargins(QRect value) override;
     QRect getVideoMargins() const override;
+    bool getVideoAdaptiveConfigs() const override;
+    void setVideoAdaptiveConfigs(bool value) override;
+    uint32_t getVideoLatencyTarget() const override;
+    void setVideoLatencyTarget(uint32_t value) override;
+    std::string getDRMDevice() const override;
+    void setDRMDevice(const std::string& value) override;
+    std::string getSharedMemoryName() const override;
+    void setSharedMemoryName(const std::string& value) override;
+    std::string getVideoDumpFile() const override;
+    void setVideoDumpFile(const std::string& value) override;
 
     bool getTouchscreenEnabled() const override;
     void setTouchscreenEnabled(bool value) override;
+    uint32_t getTouchCoalescingWindow() const override;
+    void setTouchCoalescingWindow(uint32_t value) override;
+    std::vector<std::string> getEvdevDevices() const override;
+    void setEvdevDevices(const std::vector<std::string>& value) override;
     ButtonCodes getButtonCodes() const override;
     void setButtonCodes(const ButtonCodes& value) override;
+    KeyBindings getKeyBindings() const override;
+    void setKeyBindings(const KeyBindings& value) override;
+    KeyBindings getScanCodeBindings() const override;
+    void setScanCodeBindings(const KeyBindings& value) override;
 
     BluetoothAdapterType getBluetoothAdapterType() const override;
     void setBluetoothAdapterType(BluetoothAdapterType value) override;
@@ -71,26 +97,20 @@ public:
     void setSpeechAudioChannelEnabled(bool value) override;
     AudioOutputBackendType getAudioOutputBackendType() const override;
     void setAudioOutputBackendType(AudioOutputBackendType value) override;
+    bool audioMixerEnabled() const override;
+    void setAudioMixerEnabled(bool value) override;
+    ResamplerQuality getResamplerQuality() const override;
+    void setResamplerQuality(ResamplerQuality value) override;
 
-private:
-    void readButtonCodes(boost::property_tree::ptree& iniConfig);
-    void insertButtonCode(boost::property_tree::ptree& iniConfig, const std::string& buttonCodeKey, aasdk::proto::enums::ButtonCode::Enum buttonCode);
-    void writeButtonCodes(boost::property_tree::ptree& iniConfig);
-
-    HandednessOfTrafficType handednessOfTrafficType_;
-    bool showClock_;
-    aasdk::proto::enums::VideoFPS::Enum videoFPS_;
-    aasdk::proto::enums::VideoResolution::Enum videoResolution_;
-    size_t screenDPI_;
-    int32_t omxLayerIndex_;
-    QRect videoMargins_;
-    bool enableTouchscreen_;
-    ButtonCodes buttonCodes_;
-    BluetoothAdapterType bluetoothAdapterType_;
-    std::string bluetoothRemoteAdapterAddress_;
-    bool musicAudioChannelEnabled_;
-    bool speechAudiochannelEnabled_;
-    AudioOutputBackendType audioOutputBackendType_;
+    std::string getNmeaSource() const override;
+    void setNmeaSource(const std::string& value) override;
+    std::string getAmbientLightSensor() const override;
+    void setAmbientLightSensor(const std::string& value) override;
+    std::string getCanInterface() const override;
+    void setCanInterface(const std::string& value) override;
+
+    TCPTuningProfile getTCPTuningProfile() const override;
+    void setTCPTuningProfile(const TCPTuningProfile& value) override;
 
     static const std::string cConfigFileName;
 
@@ -103,15 +123,37 @@ private:
     static const std::string cVideoOMXLayerIndexKey;
     static const std::string cVideoMarginWidth;
     static const std::string cVideoMarginHeight;
+    static const std::string cVideoAdaptiveConfigsKey;
+    static const std::string cVideoLatencyTargetKey;
+    static const std::string cVideoDRMDeviceKey;
+    static const std::string cVideoSharedMemoryNameKey;
+    static const std::string cVideoDumpFileKey;
 
     static const std::string cAudioMusicAudioChannelEnabled;
     static const std::string cAudioSpeechAudioChannelEnabled;
     static const std::string cAudioOutputBackendType;
+    static const std::string cAudioMixerEnabled;
+    static const std::string cAudioResamplerQuality;
+
+    static const std::string cSensorsNmeaSourceKey;
+    static const std::string cSensorsAmbientLightSensorKey;
+    static const std::string cSensorsCanInterfaceKey;
+
+    static const std::string cTCPNoDelayKey;
+    static const std::string cTCPQuickAckKey;
+    static const std::string cTCPReceiveBufferSizeKey;
+    static const std::string cTCPKeepAliveKey;
+    static const std::string cTCPKeepAliveIdleKey;
+    static const std::string cTCPKeepAliveIntervalKey;
+    static const std::string cTCPKeepAliveCountKey;
+    static const std::string cTCPBusyPollKey;
 
     static const std::string cBluetoothAdapterTypeKey;
     static const std::string cBluetoothRemoteAdapterAddressKey;
 
     static const std::string cInputEnableTouchscreenKey;
+    static const std::string cInputTouchCoalescingWindowKey;
+    static const std::string cInputEvdevDevicesKey;
     static const std::string cInputPlayButtonKey;
     static const std::string cInputPauseButtonKey;
     static const std::string cInputTogglePlayButtonKey;
@@ -128,6 +170,34 @@ private:
     static const std::string cInputScrollWheelButtonKey;
     static const std::string cInputBackButtonKey;
     static const std::string cInputEnterButtonKey;
+    static const std::string cKeyMapSection;
+    static const std::string cScanCodeMapSection;
+
+private:
+    static void readButtonCodes(boost::property_tree::ptree& iniConfig, ButtonCodes& buttonCodes);
+    static void insertButtonCode(boost::property_tree::ptree& iniConfig, const std::string& buttonCodeKey, aasdk::proto::enums::ButtonCode::Enum buttonCode, ButtonCodes& buttonCodes);
+    static void writeButtonCodes(boost::property_tree::ptree& iniConfig, const ButtonCodes& buttonCodes);
+    static KeyBindings readKeyBindings(boost::property_tree::ptree& iniConfig, const std::string& section);
+    static void writeKeyBindings(boost::property_tree::ptree& iniConfig, const std::string& section, const KeyBindings& keyBindings);
+
+    void update(const std::function<void(ConfigurationSnapshot&)>& modifier);
+    void publish(std::shared_ptr<ConfigurationSnapshot> snapshot);
+    void notify();
+    static void writeSnapshot(const ConfigurationSnapshot& snapshot, boost::property_tree::ptree& iniConfig);
+    static IConfigurationObserver::ChangedKeys getChangedKeys(const ConfigurationSnapshot& previous, const ConfigurationSnapshot& current);
+    static void collectChangedKeys(const boost::property_tree::ptree& tree, const boost::property_tree::ptree& otherTree, IConfigurationObserver::ChangedKeys& changedKeys);
+
+    struct Subscription
+    {
+        std::vector<std::string> keys;
+        std::weak_ptr<IConfigurationObserver> observer;
+    };
+
+    mutable std::mutex mutex_;
+    ConfigurationSnapshot::Pointer snapshot_;
+    std::atomic<uint64_t> version_;
+    ConfigurationSnapshot::Pointer notifiedSnapshot_;
+    std::vector<Subscription> subscriptions_;
 };
 
 }
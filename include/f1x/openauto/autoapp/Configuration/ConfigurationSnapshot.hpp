@@ -0,0 +1,89 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+#include <QRect>
+#include <aasdk_proto/VideoFPSEnum.pb.h>
+#include <aasdk_proto/VideoResolutionEnum.pb.h>
+#include <aasdk_proto/ButtonCodeEnum.pb.h>
+#include <f1x/openauto/autoapp/Configuration/BluetootAdapterType.hpp>
+#include <f1x/openauto/autoapp/Configuration/HandednessOfTrafficType.hpp>
+#include <f1x/openauto/autoapp/Configuration/AudioOutputBackendType.hpp>
+#include <f1x/openauto/autoapp/Configuration/ResamplerQuality.hpp>
+#include <f1x/openauto/autoapp/Configuration/TCPTuningProfile.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace configuration
+{
+
+// All settings at one point in time. A published snapshot is never modified, a change produces
+// a new snapshot with a higher version, so readers may keep and use one without any locking.
+struct ConfigurationSnapshot
+{
+    typedef std::shared_ptr<const ConfigurationSnapshot> Pointer;
+    typedef std::vector<aasdk::proto::enums::ButtonCode::Enum> ButtonCodes;
+    typedef std::map<std::string, std::string> KeyBindings;
+
+    uint64_t version = 0;
+    HandednessOfTrafficType handednessOfTrafficType = HandednessOfTrafficType::LEFT_HAND_DRIVE;
+    bool showClock = true;
+    aasdk::proto::enums::VideoFPS::Enum videoFPS = aasdk::proto::enums::VideoFPS::_60;
+    aasdk::proto::enums::VideoResolution::Enum videoResolution = aasdk::proto::enums::VideoResolution::_480p;
+    size_t screenDPI = 140;
+    int32_t omxLayerIndex = 1;
+    QRect videoMargins = QRect(0, 0, 0, 0);
+    bool videoAdaptiveConfigs = true;
+    uint32_t videoLatencyTarget = 50;
+    std::string drmDevice = "/dev/dri/card0";
+    std::string sharedMemoryName = "/openauto-video";
+    std::string videoDumpFile;
+    bool enableTouchscreen = true;
+    // unset follows the video frame duration, 0 disables coalescing
+    boost::optional<uint32_t> touchCoalescingWindow;
+    std::vector<std::string> evdevDevices;
+    ButtonCodes buttonCodes;
+    KeyBindings keyBindings;
+    KeyBindings scanCodeBindings;
+    BluetoothAdapterType bluetoothAdapterType = BluetoothAdapterType::NONE;
+    std::string bluetoothRemoteAdapterAddress;
+    bool musicAudioChannelEnabled = true;
+    bool speechAudioChannelEnabled = true;
+    AudioOutputBackendType audioOutputBackendType = AudioOutputBackendType::RTAUDIO;
+    bool audioMixerEnabled = false;
+    ResamplerQuality resamplerQuality = ResamplerQuality::MEDIUM;
+    std::string nmeaSource;
+    std::string ambientLightSensor;
+    std::string canInterface;
+    TCPTuningProfile tcpTuningProfile;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,52 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace configuration
+{
+
+// Cached snapshot for event paths. Checking for a change costs one atomic load of the version, the
+// snapshot is fetched again only after the configuration changed, and reading it allocates nothing.
+// A view is not thread safe, it belongs to one thread or strand.
+class ConfigurationView
+{
+public:
+    ConfigurationView(IConfiguration::Pointer configuration);
+
+    // returns true if a newer snapshot was taken
+    bool refresh();
+    const ConfigurationSnapshot& get() const;
+
+private:
+    IConfiguration::Pointer configuration_;
+    ConfigurationSnapshot::Pointer snapshot_;
+};
+
+}
+}
+}
+}
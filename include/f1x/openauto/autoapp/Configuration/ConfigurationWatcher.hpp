@@ -0,0 +1,80 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+#pragma once
+
+#include <array>
+#include <string>
+#include <sys/inotify.h>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace configuration
+{
+
+// Reloads the configuration when its file is rewritten. The directory is watched rather than the file itself
+// so editors that save through a temporary file and a rename are noticed as well.
+// A reload reaches a running session only through keys somebody subscribed to: Video.LatencyTarget,
+// Input.TouchCoalescingWindow and the [KeyMap] and [ScanCodeMap] sections. The [TCP] settings are read
+// at every connect. Everything else, the [Audio] section and the video mode included, is negotiated
+// with the phone at service discovery and stays session-scoped, it applies from the next connection.
+class ConfigurationWatcher: public std::enable_shared_from_this<ConfigurationWatcher>, boost::noncopyable
+{
+public:
+    typedef std::shared_ptr<ConfigurationWatcher> Pointer;
+
+    ConfigurationWatcher(boost::asio::io_service& ioService, IConfiguration::Pointer configuration, const std::string& filePath);
+
+    void start();
+    void stop();
+
+private:
+    using std::enable_shared_from_this<ConfigurationWatcher>::shared_from_this;
+
+    void read();
+    void onRead(const boost::system::error_code& error, size_t bytesTransferred);
+    void onDebounceTimerExpired(const boost::system::error_code& error);
+
+    boost::asio::io_service::strand strand_;
+    boost::asio::posix::stream_descriptor descriptor_;
+    boost::asio::deadline_timer debounceTimer_;
+    IConfiguration::Pointer configuration_;
+    std::string directory_;
+    std::string fileName_;
+    alignas(inotify_event) std::array<char, 4096> events_;
+    bool running_;
+    uint64_t reloadsCount_;
+
+    // a save usually arrives as several events (truncate, write, close or rename), one reload covers all of them
+    static constexpr uint32_t cDebounceInterval = 100;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -18,14 +18,11 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
-#include <QRect>
-#include <aasdk_proto/VideoFPSEnum.pb.h>
-#include <aasdk_proto/VideoResolutionEnum.pb.h>
-#include <aasdk_proto/ButtonCodeEnum.pb.h>
-#include <f1x/openauto/autoapp/Configuration/BluetootAdapterType.hpp>
-#include <f1x/openauto/autoapp/Configuration/HandednessOfTrafficType.hpp>
-#include <f1x/openauto/autoapp/Configuration/AudioOutputBackendType.hpp>
+#include <vector>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationSnapshot.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfigurationObserver.hpp>
 
 namespace f1x
 {
@@ -40,7 +37,8 @@ class IConfiguration
 {
 public:
     typedef std::shared_ptr<IConfiguration> Pointer;
-    typedef std::vector<aasdk::proto::enums::ButtonCode::Enum> ButtonCodes;
+    typedef ConfigurationSnapshot::ButtonCodes ButtonCodes;
+    typedef ConfigurationSnapshot::KeyBindings KeyBindings;
 
     virtual ~IConfiguration() = default;
 
@@ -48,6 +46,15 @@ public:
     virtual void reset() = 0;
     virtual void save() = 0;
 
+    // keys are "Section.Key" names or whole "Section" names, the observer is held weakly
+    virtual void subscribe(const std::vector<std::string>& keys, IConfigurationObserver::Pointer observer) = 0;
+    virtual void unsubscribe(IConfigurationObserver::Pointer observer) = 0;
+
+    // one atomic load, the returned snapshot stays valid and unchanged for as long as it is held
+    virtual ConfigurationSnapshot::Pointer getSnapshot() const = 0;
+    // lock-free, lets a cached snapshot be checked on a hot path without touching the shared pointer
+    virtual uint64_t getVersion() const = 0;
+
     virtual void setHandednessOfTrafficType(HandednessOfTrafficType value) = 0;
     virtual HandednessOfTrafficType getHandednessOfTrafficType() const = 0;
     virtual void showClock(bool value) = 0;
@@ -63,11 +70,29 @@ public:
     virtual int32_t getOMXLayerIndex() const = 0;
     virtual void setVideoMargins(QRect value) = 0;
     virtual QRect getVideoMargins() const = 0;
+    virtual bool getVideoAdaptiveConfigs() const = 0;
+    virtual void setVideoAdaptiveConfigs(bool value) = 0;
+    virtual uint32_t getVideoLatencyTarget() const = 0;
+    virtual void setVideoLatencyTarget(uint32_t value) = 0;
+    virtual std::string getDRMDevice() const = 0;
+    virtual void setDRMDevice(const std::string& value) = 0;
+    virtual std::string getSharedMemoryName() const = 0;
+    virtual void setSharedMemoryName(const std::string& value) = 0;
+    virtual std::string getVideoDumpFile() const = 0;
+    virtual void setVideoDumpFile(const std::string& value) = 0;
 
     virtual bool getTouchscreenEnabled() const = 0;
     virtual void setTouchscreenEnabled(bool value) = 0;
+    virtual uint32_t getTouchCoalescingWindow() const = 0;
+    virtual void setTouchCoalescingWindow(uint32_t value) = 0;
+    virtual std::vector<std::string> getEvdevDevices() const = 0;
+    virtual void setEvdevDevices(const std::vector<std::string>& value) = 0;
     virtual ButtonCodes getButtonCodes() const = 0;
     virtual void setButtonCodes(const ButtonCodes& value) = 0;
+    virtual KeyBindings getKeyBindings() const = 0;
+    virtual void setKeyBindings(const KeyBindings& value) = 0;
+    virtual KeyBindings getScanCodeBindings() const = 0;
+    virtual void setScanCodeBindings(const KeyBindings& value) = 0;
 
     virtual BluetoothAdapterType getBluetoothAdapterType() const = 0;
     virtual void setBluetoothAdapterType(BluetoothAdapterType value) = 0;
@@ -80,6 +105,20 @@ public:
     virtual void setSpeechAudioChannelEnabled(bool value) = 0;
     virtual AudioOutputBackendType getAudioOutputBackendType() const = 0;
     virtual void setAudioOutputBackendType(AudioOutputBackendType value) = 0;
+    virtual bool audioMixerEnabled() const = 0;
+    virtual void setAudioMixerEnabled(bool value) = 0;
+    virtual ResamplerQuality getResamplerQuality() const = 0;
+    virtual void setResamplerQuality(ResamplerQuality value) = 0;
+
+    virtual std::string getNmeaSource() const = 0;
+    virtual void setNmeaSource(const std::string& value) = 0;
+    virtual std::string getAmbientLightSensor() const = 0;
+    virtual void setAmbientLightSensor(const std::string& value) = 0;
+    virtual std::string getCanInterface() const = 0;
+    virtual void setCanInterface(const std::string& value) = 0;
+
+    virtual TCPTuningProfile getTCPTuningProfile() const = 0;
+    virtual void setTCPTuningProfile(const TCPTuningProfile& value) = 0;
 };
 
 }
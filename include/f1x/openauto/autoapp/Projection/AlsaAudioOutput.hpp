@@ -0,0 +1,98 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_ALSA
+#pragma once
+
+#include <alsa/asoundlib.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <boost/circular_buffer.hpp>
+#include <f1x/openauto/autoapp/Projection/IAudioOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioSourceReader.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class AlsaAudioOutput: public IAudioOutput
+{
+public:
+    AlsaAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference);
+    ~AlsaAudioOutput() override;
+
+    bool open() override;
+    void write(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer) override;
+    void start() override;
+    void stop() override;
+    void suspend() override;
+    void setGain(float gain) override;
+    uint32_t getSampleSize() const override;
+    uint32_t getChannelCount() const override;
+    uint32_t getSampleRate() const override;
+    void setSource(IAudioSource::Pointer source);
+
+private:
+    bool configure();
+    void doSuspend();
+    void playback();
+    bool transfer(snd_pcm_uframes_t frameCount);
+    void fill(int16_t* destination, snd_pcm_uframes_t frameCount);
+
+    uint32_t channelCount_;
+    uint32_t sampleSize_;
+    uint32_t sampleRate_;
+    uint32_t deviceSampleRate_;
+    configuration::ResamplerQuality resamplerQuality_;
+    Resampler::Pointer resampler_;
+    std::vector<int16_t> resampled_;
+    snd_pcm_t* pcm_;
+    snd_pcm_uframes_t periodSize_;
+    boost::circular_buffer<int16_t> samples_;
+    std::atomic<float> gain_;
+    float currentGain_;
+    EchoReference::Pointer echoReference_;
+    EchoReference::SourceId echoReferenceSourceId_;
+    std::weak_ptr<IAudioSource> source_;
+    AudioSourceReader::Pointer sourceReader_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::mutex samplesMutex_;
+    std::mutex mutex_;
+
+    static const std::string cDeviceName;
+    static constexpr unsigned int cPeriodTime = 5000;
+    static constexpr unsigned int cPeriodCount = 4;
+    static constexpr int cWaitTimeout = 100;
+    static constexpr float cGainRampPerFrame = 1.0f / 2400.0f;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <f1x/openauto/autoapp/Projection/IAudioInputProcessor.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class AudioInputProcessor: public IAudioInputProcessor
+{
+public:
+    AudioInputProcessor(EchoReference::Pointer echoReference, uint32_t sampleRate);
+
+    void setEchoCancellationEnabled(bool value) override;
+    void setNoiseSuppressionEnabled(bool value) override;
+    void process(aasdk::common::Data& data) override;
+    void reset() override;
+
+private:
+    void cancelEcho(size_t sampleCount);
+    void estimateDelay(size_t sampleCount);
+    void suppressNoise(size_t sampleCount);
+
+    EchoReference::Pointer echoReference_;
+    uint32_t sampleRate_;
+    bool echoCancellationEnabled_;
+    bool noiseSuppressionEnabled_;
+
+    std::vector<float> nearEnd_;
+    std::vector<float> farEndHistory_;
+    std::vector<float> filter_;
+    size_t doubleTalkHangover_;
+
+    std::vector<float> estimatorNearEnd_;
+    std::vector<float> estimatorFarEnd_;
+    float estimatorNearEndAccumulator_;
+    float estimatorFarEndAccumulator_;
+    size_t estimatorPhase_;
+    size_t samplesSinceEstimation_;
+    size_t delay_;
+    size_t delayCandidate_;
+
+    double echoEnergy_;
+    double residualEnergy_;
+    size_t measuredSamplesCount_;
+
+    float noiseFloor_;
+    float suppressionGain_;
+
+    static constexpr size_t cFilterLength = 1024;
+    static constexpr float cStepSize = 0.3f;
+    static constexpr float cDoubleTalkThreshold = 0.6f;
+    static constexpr size_t cDoubleTalkHangover = 240;
+    static constexpr size_t cMaxDelay = 8000;
+    static constexpr size_t cDelayMargin = 64;
+    static constexpr size_t cDelayTolerance = 32;
+    static constexpr size_t cEstimatorDecimation = 8;
+    static constexpr size_t cEstimatorWindow = 2000;
+    static constexpr size_t cEstimationInterval = 8000;
+    static constexpr float cEstimatorMinCorrelation = 0.3f;
+    static constexpr float cFarEndActivityEnergy = 1e-4f;
+    static constexpr size_t cSuppressionFrameSize = 160;
+    static constexpr float cMinSuppressionGain = 0.1f;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,113 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <f1x/openauto/autoapp/Projection/IAudioSource.hpp>
+#include <f1x/openauto/autoapp/Projection/IAudioOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+enum class AudioMixerChannelType
+{
+    MEDIA,
+    SPEECH,
+    SYSTEM
+};
+
+class AudioMixer: public IAudioSource
+{
+public:
+    typedef std::shared_ptr<AudioMixer> Pointer;
+    typedef size_t ChannelId;
+
+    AudioMixer(uint32_t sampleRate, float duckingGain, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference);
+    ~AudioMixer() override;
+
+    void setOutput(IAudioOutput::Pointer output);
+    ChannelId addChannel(AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, float gain);
+    bool open();
+    void write(ChannelId channelId, const int16_t* samples, size_t frameCount);
+    void start(ChannelId channelId);
+    void suspend(ChannelId channelId);
+    void stop(ChannelId channelId);
+    void setGain(ChannelId channelId, float gain);
+    void read(int16_t* samples, size_t frameCount) override;
+    uint32_t getSampleRate() const override;
+    uint32_t getChannelCount() const override;
+
+private:
+    // samples are resampled by the writing service and handed to the output thread through a single-producer,
+    // single-consumer ring, so the output thread never waits for a writer
+    struct Channel
+    {
+        Channel(AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, uint32_t mixerSampleRate, float gain, configuration::ResamplerQuality resamplerQuality);
+
+        AudioMixerChannelType type;
+        uint32_t channelCount;
+        Resampler::Pointer resampler;
+        std::vector<float> resampled;
+        boost::lockfree::spsc_queue<float> samples;
+        std::vector<float> mixed;
+        std::atomic<float> gain;
+        float currentGain;
+        std::atomic<bool> active;
+        uint64_t pushedCount;
+        uint64_t poppedCount;
+        std::atomic<uint64_t> discardedCount;
+    };
+
+    void discardChannel(Channel& channel);
+    void mixChannel(Channel& channel, float targetGain, size_t frameCount);
+    void updateOutputState();
+
+    uint32_t sampleRate_;
+    float duckingGain_;
+    configuration::ResamplerQuality resamplerQuality_;
+    size_t duckingHoldFrames_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+    std::vector<float> mixBuffer_;
+    EchoReference::Pointer echoReference_;
+    EchoReference::SourceId echoReferenceSourceId_;
+    IAudioOutput::Pointer output_;
+    bool opened_;
+    bool running_;
+    std::mutex mutex_;
+
+    static constexpr uint32_t cChannelCount = 2;
+    static constexpr float cGainRampPerFrame = 1.0f / 4800.0f;
+    static constexpr size_t cDuckingHoldFrames = 24000;
+};
+
+}
+}
+}
+}
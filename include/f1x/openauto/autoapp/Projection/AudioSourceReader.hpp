@@ -0,0 +1,57 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <f1x/openauto/autoapp/Projection/IAudioSource.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class AudioSourceReader
+{
+public:
+    typedef std::unique_ptr<AudioSourceReader> Pointer;
+
+    AudioSourceReader(std::weak_ptr<IAudioSource> source, uint32_t deviceSampleRate, configuration::ResamplerQuality resamplerQuality);
+
+    void read(int16_t* samples, size_t frameCount);
+
+private:
+    std::weak_ptr<IAudioSource> source_;
+    uint32_t channelCount_;
+    Resampler::Pointer resampler_;
+    std::vector<int16_t> chunk_;
+    std::vector<int16_t> resampled_;
+    size_t resampledOffset_;
+
+    static constexpr size_t cChunkFrames = 256;
+};
+
+}
+}
+}
+}
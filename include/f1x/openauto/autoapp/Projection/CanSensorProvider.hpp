@@ -0,0 +1,80 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+#pragma once
+
+#include <string>
+#include <linux/can.h>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProvider.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Polls the vehicle speed (OBD-II service 01, PID 0D) over a SocketCAN interface such as can0 or vcan0.
+class CanSensorProvider: public ISensorProvider, public std::enable_shared_from_this<CanSensorProvider>, boost::noncopyable
+{
+public:
+    CanSensorProvider(boost::asio::io_service& ioService, std::string interfaceName);
+
+    void start(ISensorProviderEventHandler& eventHandler) override;
+    void stop() override;
+    bool isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const override;
+    void updateLocation(const LocationData& location) override;
+
+private:
+    using std::enable_shared_from_this<CanSensorProvider>::shared_from_this;
+
+    bool open();
+    void read();
+    void onRead(const boost::system::error_code& error, size_t bytesTransferred);
+    void sendRequest();
+    void onRequestTimer(const boost::system::error_code& error);
+    void close();
+
+    boost::asio::io_service::strand strand_;
+    boost::asio::posix::stream_descriptor descriptor_;
+    boost::asio::deadline_timer requestTimer_;
+    std::string interfaceName_;
+    ISensorProviderEventHandler* eventHandler_;
+    can_frame request_;
+    can_frame response_;
+
+    static constexpr uint32_t cRequestInterval = 100;
+    static constexpr uint32_t cReopenInterval = 5000;
+    static constexpr canid_t cBroadcastRequestId = 0x7DF;
+    static constexpr canid_t cResponseId = 0x7E8;
+    static constexpr canid_t cResponseMask = 0x7F8;
+    static constexpr uint8_t cShowCurrentData = 0x01;
+    static constexpr uint8_t cVehicleSpeedPid = 0x0D;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_DRM
+#pragma once
+
+#include <xf86drmMode.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoDecoder.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Decodes with libavcodec and scans the frames out of dumb buffers straight to the primary
+// plane of the first connected display, without Qt or a compositor in the way. Three buffers
+// rotate between the screen, a queued page flip and the decoder. A frame that is ready while
+// a flip is still pending waits for the flip event and is replaced if a newer one comes first.
+class DRMVideoOutput: public VideoOutput, boost::noncopyable
+{
+public:
+    DRMVideoOutput(configuration::IConfiguration::Pointer configuration);
+
+    bool open() override;
+    bool init() override;
+    void write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer) override;
+    void stop() override;
+    uint64_t getDecodeErrorsCount() const override;
+
+private:
+    struct FrameBuffer
+    {
+        uint32_t handle;
+        uint32_t pitch;
+        uint64_t size;
+        uint32_t id;
+        uint8_t* map;
+    };
+
+    bool findDisplay();
+    bool createFrameBuffer(FrameBuffer& frameBuffer);
+    void destroyFrameBuffer(FrameBuffer& frameBuffer);
+    void drawFrame(const AVFrame* frame);
+    void present(int index);
+    void pollEvents();
+    void release();
+
+    static void onPageFlip(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, void* userData);
+
+    static constexpr int cNoBuffer = -1;
+    static constexpr size_t cFrameBuffersCount = 3;
+
+    std::mutex mutex_;
+    std::thread eventThread_;
+    std::atomic<bool> isActive_;
+    int fd_;
+    uint32_t connectorId_;
+    uint32_t crtcId_;
+    drmModeModeInfo mode_;
+    drmModeCrtc* savedCrtc_;
+    std::array<FrameBuffer, cFrameBuffersCount> frameBuffers_;
+    int frontBuffer_;
+    int pendingBuffer_;
+    int readyBuffer_;
+    bool modeSet_;
+    VideoDecoder decoder_;
+    std::atomic<uint64_t> decodeErrorsCount_;
+    uint64_t flipsCount_;
+    uint64_t replacedFramesCount_;
+};
+
+}
+}
+}
+}
+
+#endif
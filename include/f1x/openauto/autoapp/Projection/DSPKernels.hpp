@@ -0,0 +1,46 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+namespace dsp
+{
+
+float dotProduct(const float* a, const float* b, size_t count);
+void dualDotProduct(const float* coefficients, const float* a, const float* b, size_t count, float& resultA, float& resultB);
+void multiplyAccumulate(float* destination, const float* source, float gain, size_t count);
+void multiply(float* destination, float gain, size_t count);
+void convertToFloat(const int16_t* source, float* destination, size_t count);
+void convertToInt16(const float* source, int16_t* destination, size_t count);
+
+}
+}
+}
+}
+}
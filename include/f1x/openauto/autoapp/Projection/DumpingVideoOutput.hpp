@@ -0,0 +1,101 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <f1x/openauto/autoapp/Projection/IVideoOutput.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Tees the H.264 stream written to the wrapped output into a file for offline analysis and replay.
+// Every session gets a file of its own, numbered before the extension of the configured path
+// (video.oavd becomes video-1.oavd, video-2.oavd, ...), so earlier dumps are never overwritten.
+// The file starts with the magic and version, followed by one record per write: the timestamp as
+// uint64_t, the payload size as uint32_t (both little endian) and the payload. Records are written
+// by a thread of their own. A write that would overflow the queue is left out of the file rather
+// than delaying the video path, and a marker record with size cDroppedRecordsMarker, carrying the
+// number of left out writes in place of the timestamp, is written where they were.
+class DumpingVideoOutput: public IVideoOutput
+{
+public:
+    DumpingVideoOutput(IVideoOutput::Pointer videoOutput, std::string path);
+    ~DumpingVideoOutput() override;
+
+    bool open() override;
+    bool init() override;
+    void write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer) override;
+    void stop() override;
+    aasdk::proto::enums::VideoFPS::Enum getVideoFPS() const override;
+    aasdk::proto::enums::VideoResolution::Enum getVideoResolution() const override;
+    size_t getScreenDPI() const override;
+    QRect getVideoMargins() const override;
+    VideoConfigs getVideoConfigs() const override;
+    float getBacklog() const override;
+    uint64_t getDecodeErrorsCount() const override;
+
+    static constexpr uint32_t cMagic = 0x4456414f; // "OAVD"
+    static constexpr uint32_t cVersion = 2;
+    static constexpr uint32_t cDroppedRecordsMarker = 0xFFFFFFFF;
+
+private:
+    struct Record
+    {
+        uint64_t timestamp;
+        aasdk::common::Data payload;
+        uint64_t droppedRecordsCount;
+    };
+
+    FILE* createFile();
+    void run();
+    void close();
+
+    IVideoOutput::Pointer videoOutput_;
+    std::string path_;
+    std::string filePath_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+    std::deque<Record> records_;
+    size_t queuedSize_;
+    bool stopped_;
+    FILE* file_;
+    uint64_t writtenRecordsCount_;
+    uint64_t droppedRecordsCount_;
+    uint64_t pendingDroppedRecordsCount_;
+
+    static constexpr size_t cMaxQueuedSize = 8 * 1024 * 1024;
+    static constexpr uint32_t cMaxFilesCount = 1000;
+};
+
+}
+}
+}
+}
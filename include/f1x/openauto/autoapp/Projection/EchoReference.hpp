@@ -0,0 +1,75 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/lockfree/spsc_queue.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Collects what the outputs play as the far-end signal of the echo canceller. Every output writes
+// from its device callback into a single producer, single consumer queue of its own, so the audio
+// threads never wait for the capture thread, which reads and mixes all sources under its own lock.
+// Sources are added while the outputs are constructed, before any of them is written or read.
+class EchoReference
+{
+public:
+    typedef std::shared_ptr<EchoReference> Pointer;
+    typedef size_t SourceId;
+
+    EchoReference(uint32_t sampleRate);
+
+    SourceId addSource();
+    void write(SourceId sourceId, const int16_t* samples, size_t frameCount, uint32_t channelCount, uint32_t sampleRate);
+    void read(float* samples, size_t count);
+    void reset();
+    uint32_t getSampleRate() const;
+
+private:
+    struct Source
+    {
+        Source(size_t capacity);
+
+        boost::lockfree::spsc_queue<float> samples;
+        float accumulator;
+        uint32_t accumulatedCount;
+        uint32_t phase;
+    };
+
+    uint32_t sampleRate_;
+    std::vector<std::unique_ptr<Source>> sources_;
+    std::vector<float> readBuffer_;
+    std::mutex mutex_;
+
+    static constexpr size_t cWriteChunkSize = 256;
+};
+
+}
+}
+}
+}
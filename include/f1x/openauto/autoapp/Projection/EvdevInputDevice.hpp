@@ -0,0 +1,120 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+#pragma once
+
+#include <array>
+#include <linux/input.h>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
+#include <f1x/openauto/autoapp/Projection/KeyMap.hpp>
+#include <f1x/openauto/autoapp/Projection/TouchPointTracker.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfigurationObserver.hpp>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationView.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class EvdevInputDevice: public IInputDevice, public configuration::IConfigurationObserver, public std::enable_shared_from_this<EvdevInputDevice>, boost::noncopyable
+{
+public:
+    EvdevInputDevice(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, const QRect& touchscreenGeometry, const QRect& displayGeometry);
+
+    void start(IInputDeviceEventHandler& eventHandler) override;
+    void stop() override;
+    ButtonCodes getSupportedButtonCodes() const override;
+    bool isButtonCodeSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const override;
+    bool hasTouchscreen() const override;
+    QRect getTouchscreenGeometry() const override;
+    void setDisplayGeometry(const QRect& displayGeometry) override;
+    void onConfigurationChanged(const ChangedKeys& changedKeys) override;
+
+private:
+    using std::enable_shared_from_this<EvdevInputDevice>::shared_from_this;
+
+    struct Axis
+    {
+        int32_t minimum;
+        int32_t maximum;
+    };
+
+    struct Slot
+    {
+        int32_t trackingId;
+        int32_t x;
+        int32_t y;
+        bool changed;
+    };
+
+    struct Device
+    {
+        Device(boost::asio::io_service& ioService, std::string path, int fd);
+
+        std::string path;
+        boost::asio::posix::stream_descriptor descriptor;
+        std::array<input_event, 64> events;
+        size_t index;
+        Axis x;
+        Axis y;
+        bool multiTouch;
+        size_t currentSlot;
+        std::vector<Slot> slots;
+    };
+
+    typedef std::shared_ptr<Device> DevicePointer;
+
+    DevicePointer openDevice(const std::string& path, size_t index);
+    void readDevice(DevicePointer device);
+    void onDeviceRead(DevicePointer device, const boost::system::error_code& error, size_t bytesTransferred);
+    void handleEvent(Device& device, const input_event& event);
+    void handleAbsoluteEvent(Device& device, const input_event& event);
+    void handleKeyEvent(Device& device, const input_event& event);
+    void handleRelativeEvent(const input_event& event);
+    void handleSynchronization(Device& device);
+    uint32_t calibrate(int32_t value, const Axis& axis, int32_t size) const;
+    static int touchPointId(const Device& device, size_t slot);
+
+    boost::asio::io_service& ioService_;
+    boost::asio::io_service::strand strand_;
+    configuration::IConfiguration::Pointer configuration_;
+    configuration::ConfigurationView configurationView_;
+    QRect touchscreenGeometry_;
+    QRect displayGeometry_;
+    IInputDeviceEventHandler* eventHandler_;
+    std::vector<DevicePointer> devices_;
+    TouchPointTracker touchPointTracker_;
+    KeyMap keyMap_;
+
+    static constexpr size_t cMaxSlots = 10;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -44,6 +44,7 @@ public:
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual void suspend() = 0;
+    virtual void setGain(float gain) = 0;
     virtual uint32_t getSampleSize() const = 0;
     virtual uint32_t getChannelCount() const = 0;
     virtual uint32_t getSampleRate() const = 0;
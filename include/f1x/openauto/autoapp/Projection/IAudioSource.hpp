@@ -0,0 +1,51 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class IAudioSource
+{
+public:
+    typedef std::shared_ptr<IAudioSource> Pointer;
+
+    IAudioSource() = default;
+    virtual ~IAudioSource() = default;
+
+    // always fills frameCount interleaved frames, silence when nothing is queued
+    virtual void read(int16_t* samples, size_t frameCount) = 0;
+    virtual uint32_t getChannelCount() const = 0;
+    virtual uint32_t getSampleRate() const = 0;
+};
+
+}
+}
+}
+}
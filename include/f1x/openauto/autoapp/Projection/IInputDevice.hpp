@@ -43,8 +43,11 @@ public:
     virtual void start(IInputDeviceEventHandler& eventHandler) = 0;
     virtual void stop() = 0;
     virtual ButtonCodes getSupportedButtonCodes() const = 0;
+    virtual bool isButtonCodeSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const = 0;
     virtual bool hasTouchscreen() const = 0;
     virtual QRect getTouchscreenGeometry() const = 0;
+    // touches are mapped into this geometry, it follows the video config the phone selected
+    virtual void setDisplayGeometry(const QRect& displayGeometry) = 0;
 };
 
 }
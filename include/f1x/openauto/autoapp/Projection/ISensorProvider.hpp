@@ -0,0 +1,52 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <aasdk_proto/SensorTypeEnum.pb.h>
+#include <f1x/openauto/autoapp/Projection/SensorEvent.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class ISensorProviderEventHandler;
+
+class ISensorProvider
+{
+public:
+    typedef std::shared_ptr<ISensorProvider> Pointer;
+
+    virtual ~ISensorProvider() = default;
+    virtual void start(ISensorProviderEventHandler& eventHandler) = 0;
+    virtual void stop() = 0;
+    virtual bool isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const = 0;
+    // every accepted fix is fanned out, providers deriving data from the position (e.g. sun elevation) pick it up here
+    virtual void updateLocation(const LocationData& location) = 0;
+};
+
+}
+}
+}
+}
@@ -19,10 +19,9 @@
 #pragma once
 
 #include <memory>
-#include <QRect>
-#include <aasdk_proto/VideoFPSEnum.pb.h>
-#include <aasdk_proto/VideoResolutionEnum.pb.h>
+#include <vector>
 #include <f1x/aasdk/Common/Data.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoConfig.hpp>
 
 namespace f1x
 {
@@ -37,6 +36,7 @@ class IVideoOutput
 {
 public:
     typedef std::shared_ptr<IVideoOutput> Pointer;
+    typedef std::vector<VideoConfig> VideoConfigs;
 
     IVideoOutput() = default;
     virtual ~IVideoOutput() = default;
@@ -49,6 +49,9 @@ public:
     virtual aasdk::proto::enums::VideoResolution::Enum getVideoResolution() const = 0;
     virtual size_t getScreenDPI() const = 0;
     virtual QRect getVideoMargins() const = 0;
+    virtual VideoConfigs getVideoConfigs() const = 0;
+    virtual float getBacklog() const = 0;
+    virtual uint64_t getDecodeErrorsCount() const = 0;
 };
 
 }
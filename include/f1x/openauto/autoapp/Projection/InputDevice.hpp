@@ -20,8 +20,13 @@
 
 #include <QObject>
 #include <QKeyEvent>
+#include <QTouchEvent>
 #include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
+#include <f1x/openauto/autoapp/Projection/KeyMap.hpp>
+#include <f1x/openauto/autoapp/Projection/TouchPointTracker.hpp>
 #include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfigurationObserver.hpp>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationView.hpp>
 
 namespace f1x
 {
@@ -32,7 +37,7 @@ namespace autoapp
 namespace projection
 {
 
-class InputDevice: public QObject, public IInputDevice, boost::noncopyable
+class InputDevice: public QObject, public IInputDevice, public configuration::IConfigurationObserver, public std::enable_shared_from_this<InputDevice>, boost::noncopyable
 {
     Q_OBJECT
 
@@ -42,21 +47,30 @@ public:
     void start(IInputDeviceEventHandler& eventHandler) override;
     void stop() override;
     ButtonCodes getSupportedButtonCodes() const override;
+    bool isButtonCodeSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const override;
     bool eventFilter(QObject* obj, QEvent* event) override;
     bool hasTouchscreen() const override;
     QRect getTouchscreenGeometry() const override;
+    void setDisplayGeometry(const QRect& displayGeometry) override;
+    void onConfigurationChanged(const ChangedKeys& changedKeys) override;
 
 private:
     void setVideoGeometry();
     bool handleKeyEvent(QEvent* event, QKeyEvent* key);
     void dispatchKeyEvent(ButtonEvent event);
     bool handleTouchEvent(QEvent* event);
+    bool handleMultiTouchEvent(QTouchEvent* touch);
+    QPoint mapTouchPosition(const QPointF& position) const;
 
     QObject& parent_;
     configuration::IConfiguration::Pointer configuration_;
+    configuration::ConfigurationView configurationView_;
     QRect touchscreenGeometry_;
     QRect displayGeometry_;
     IInputDeviceEventHandler* eventHandler_;
+    TouchPointTracker touchPointTracker_;
+    KeyMap keyMap_;
+    bool touchEventsReceived_;
     std::mutex mutex_;
 };
 
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <vector>
 #include <aasdk_proto/ButtonCodeEnum.pb.h>
 #include <aasdk_proto/TouchActionEnum.pb.h>
 #include <f1x/aasdk/IO/Promise.hpp>
@@ -50,16 +51,24 @@ struct ButtonEvent
     ButtonEventType type;
     WheelDirection wheelDirection;
     aasdk::proto::enums::ButtonCode::Enum code;
+    // detents carried by a single wheel report
+    uint32_t wheelTicks = 1;
 };
 
-struct TouchEvent
+struct TouchLocation
 {
-    aasdk::proto::enums::TouchAction::Enum type;
     uint32_t x;
     uint32_t y;
     uint32_t pointerId;
 };
 
+struct TouchEvent
+{
+    aasdk::proto::enums::TouchAction::Enum type;
+    uint32_t actionIndex;
+    std::vector<TouchLocation> locations;
+};
+
 }
 }
 }
@@ -0,0 +1,75 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <unordered_map>
+#include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationSnapshot.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Precomputed translation of Qt keys and evdev scan codes into button codes.
+// Bindings of button codes that are disabled in the configuration are dropped while
+// the map is built, so a lookup on the event path is a single probe without allocation.
+// The set of button codes is fixed by load() for the session (it was announced to the phone),
+// reload() rebuilds only the key and scan code bindings.
+class KeyMap
+{
+public:
+    struct Binding
+    {
+        aasdk::proto::enums::ButtonCode::Enum code;
+        WheelDirection wheelDirection;
+    };
+
+    KeyMap();
+
+    void load(const configuration::ConfigurationSnapshot& configuration);
+    void reload(const configuration::ConfigurationSnapshot& configuration);
+    const Binding* findKey(int key) const;
+    const Binding* findScanCode(uint16_t scanCode) const;
+    bool isSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const;
+    const IInputDevice::ButtonCodes& getSupportedButtonCodes() const;
+
+private:
+    void loadDefaults();
+    void loadOverrides(const configuration::ConfigurationSnapshot& configuration);
+    void removeUnsupported();
+    static bool parseBinding(const std::string& value, Binding& binding);
+    static bool toBitIndex(aasdk::proto::enums::ButtonCode::Enum buttonCode, size_t& index);
+
+    std::unordered_map<int, Binding> keys_;
+    std::array<Binding, 0x300> scanCodes_;
+    std::bitset<0x200> supported_;
+    IInputDevice::ButtonCodes supportedButtonCodes_;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,74 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <f1x/aasdk/Common/Data.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+struct AccessUnit
+{
+    aasdk::common::DataConstBuffer buffer;  // Annex-B bytes including start codes, points into the parsed buffer
+    uint64_t timestamp;
+    bool hasSPS;
+    bool hasPPS;
+    bool hasSlice;
+    bool isIDR;
+    bool isReference;
+    bool hasError;      // bytes outside of a NAL unit or a NAL header with the forbidden bit set
+};
+
+// Splits Annex-B H.264 data into access units without copying it. Android Auto sends whole NAL
+// units in every media message, so the end of a buffer always closes the current access unit;
+// codec config messages come out as units with parameter sets only.
+class NalParser
+{
+public:
+    typedef std::vector<AccessUnit> AccessUnits;
+
+    static void parse(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer, AccessUnits& accessUnits);
+    static const uint8_t* findStartCode(const uint8_t* begin, const uint8_t* end);
+    // byte by byte reference, finishes the tail of findStartCode and checks its SIMD paths
+    static const uint8_t* findStartCodeScalar(const uint8_t* begin, const uint8_t* end);
+
+    static constexpr uint8_t cNalSlice = 1;
+    static constexpr uint8_t cNalIDR = 5;
+    static constexpr uint8_t cNalSEI = 6;
+    static constexpr uint8_t cNalSPS = 7;
+    static constexpr uint8_t cNalPPS = 8;
+    static constexpr uint8_t cNalAUD = 9;
+
+private:
+    static bool startsAccessUnit(uint8_t nalType, const uint8_t* nal, const uint8_t* end);
+};
+
+}
+}
+}
+}
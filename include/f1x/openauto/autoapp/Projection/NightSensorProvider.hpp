@@ -0,0 +1,77 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProvider.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Decides night mode from an ambient light sensor (e.g. an IIO illuminance attribute) when one is configured,
+// otherwise from the sun elevation at the last known position, and from the local time of day before the first fix.
+class NightSensorProvider: public ISensorProvider, public std::enable_shared_from_this<NightSensorProvider>, boost::noncopyable
+{
+public:
+    NightSensorProvider(boost::asio::io_service& ioService, std::string lightSensorPath);
+
+    void start(ISensorProviderEventHandler& eventHandler) override;
+    void stop() override;
+    bool isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const override;
+    void updateLocation(const LocationData& location) override;
+
+private:
+    using std::enable_shared_from_this<NightSensorProvider>::shared_from_this;
+
+    void schedule();
+    void onTimer(const boost::system::error_code& error);
+    void evaluate();
+    bool readIlluminance(double& illuminance) const;
+    static double getSunElevation(std::time_t time, double latitude, double longitude);
+
+    boost::asio::io_service::strand strand_;
+    boost::asio::deadline_timer timer_;
+    std::string lightSensorPath_;
+    ISensorProviderEventHandler* eventHandler_;
+    bool reported_;
+    bool isNight_;
+    bool hasLocation_;
+    double latitude_;
+    double longitude_;
+
+    static constexpr uint32_t cPollInterval = 5000;
+    static constexpr double cNightIlluminance = 30.0;
+    static constexpr double cDayIlluminance = 100.0;
+    static constexpr double cSunsetElevation = -0.833;
+    static constexpr int cDayStartHour = 7;
+    static constexpr int cDayEndHour = 19;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,86 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProvider.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Reads NMEA 0183 sentences either from a gpsd style TCP endpoint ("host:port")
+// or from a local serial device or named pipe, and reports RMC fixes merged with GGA altitude and HDOP.
+class NmeaSensorProvider: public ISensorProvider, public std::enable_shared_from_this<NmeaSensorProvider>, boost::noncopyable
+{
+public:
+    NmeaSensorProvider(boost::asio::io_service& ioService, std::string source);
+
+    void start(ISensorProviderEventHandler& eventHandler) override;
+    void stop() override;
+    bool isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const override;
+    void updateLocation(const LocationData& location) override;
+
+private:
+    using std::enable_shared_from_this<NmeaSensorProvider>::shared_from_this;
+
+    void open();
+    void openSocket(const std::string& host, const std::string& port);
+    void openDevice();
+    void read();
+    void onRead(const boost::system::error_code& error, size_t bytesTransferred);
+    void onError(const std::string& what, const boost::system::error_code& error);
+    void scheduleReconnect();
+    void handleSentence(const std::string& sentence);
+    void handleRMC();
+    void handleGGA();
+    static bool verifyChecksum(const std::string& sentence);
+    static bool parseCoordinate(const std::string& value, const std::string& hemisphere, int32_t& coordinate);
+    static bool parseTimestamp(const std::string& time, const std::string& date, uint64_t& timestamp);
+
+    boost::asio::io_service::strand strand_;
+    boost::asio::ip::tcp::resolver resolver_;
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::posix::stream_descriptor descriptor_;
+    boost::asio::deadline_timer reconnectTimer_;
+    boost::asio::streambuf buffer_;
+    std::string source_;
+    ISensorProviderEventHandler* eventHandler_;
+    std::vector<std::string> fields_;
+    int32_t altitude_;
+    uint32_t accuracy_;
+
+    static constexpr uint32_t cReconnectInterval = 5000;
+    static constexpr size_t cMaxSentenceSize = 256;
+    // NMEA GGA carries HDOP only, a user equivalent range error of 5 m turns it into an accuracy estimate
+    static constexpr float cRangeError = 5.0f;
+};
+
+}
+}
+}
+}
@@ -24,6 +24,7 @@ extern "C"
 #include <ilclient.h>
 }
 
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
@@ -48,6 +49,11 @@ public:
     bool init() override;
     void write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer) override;
     void stop() override;
+    float getBacklog() const override;
+    uint64_t getDecodeErrorsCount() const override;
+
+protected:
+    uint64_t getDecodePixelRate() const override;
 
 private:
     bool createComponents();
@@ -55,10 +61,13 @@ private:
     bool setupTunnels();
     bool enablePortBuffers();
     bool setupDisplayRegion();
+    static void onComponentError(void* userData, COMPONENT_T* component, OMX_U32 data);
 
     std::mutex mutex_;
     bool isActive_;
     bool portSettingsChanged_;
+    std::atomic<bool> dataLost_;
+    std::atomic<uint64_t> decodeErrorsCount_;
     ILCLIENT_T* client_;
     COMPONENT_T* components_[5];
     TUNNEL_T tunnels_[4];
@@ -22,6 +22,9 @@
 #include <QAudioFormat>
 #include <f1x/openauto/autoapp/Projection/IAudioOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/SequentialBuffer.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioSourceDevice.hpp>
 
 namespace f1x
 {
@@ -37,30 +40,41 @@ class QtAudioOutput: public QObject, public IAudioOutput
     Q_OBJECT
 
 public:
-    QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate);
+    QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference);
     bool open() override;
     void write(aasdk::messenger::Timestamp::ValueType, const aasdk::common::DataConstBuffer& buffer) override;
     void start() override;
     void stop() override;
     void suspend() override;
+    void setGain(float gain) override;
     uint32_t getSampleSize() const override;
     uint32_t getChannelCount() const override;
     uint32_t getSampleRate() const override;
+    void setSource(IAudioSource::Pointer source);
 
 signals:
     void startPlayback();
     void suspendPlayback();
     void stopPlayback();
+    void volumeChanged(qreal volume);
 
 protected slots:
     void createAudioOutput();
     void onStartPlayback();
     void onSuspendPlayback();
     void onStopPlayback();
+    void onVolumeChanged(qreal volume);
 
 private:
     QAudioFormat audioFormat_;
+    configuration::ResamplerQuality resamplerQuality_;
+    Resampler::Pointer resampler_;
+    std::vector<int16_t> resampled_;
     SequentialBuffer audioBuffer_;
+    EchoReference::Pointer echoReference_;
+    EchoReference::SourceId echoReferenceSourceId_;
+    std::weak_ptr<IAudioSource> source_;
+    std::unique_ptr<AudioSourceDevice> sourceDevice_;
     std::unique_ptr<QAudioOutput> audioOutput_;
     bool playbackStarted_;
 };
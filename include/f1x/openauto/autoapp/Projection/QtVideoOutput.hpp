@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <QMediaPlayer>
 #include <QVideoWidget>
 #include <boost/noncopyable.hpp>
@@ -43,6 +44,8 @@ public:
     bool init() override;
     void write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer) override;
     void stop() override;
+    float getBacklog() const override;
+    uint64_t getDecodeErrorsCount() const override;
 
 signals:
     void startPlayback();
@@ -52,11 +55,15 @@ protected slots:
     void createVideoOutput();
     void onStartPlayback();
     void onStopPlayback();
+    void onMediaPlayerError(QMediaPlayer::Error error);
 
 private:
     SequentialBuffer videoBuffer_;
     std::unique_ptr<QVideoWidget> videoWidget_;
     std::unique_ptr<QMediaPlayer> mediaPlayer_;
+    std::atomic<uint64_t> decodeErrorsCount_;
+
+    static constexpr size_t cMaxBacklog = 512 * 1024;
 };
 
 }
@@ -0,0 +1,67 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <f1x/openauto/autoapp/Configuration/ResamplerQuality.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class Resampler
+{
+public:
+    typedef std::unique_ptr<Resampler> Pointer;
+
+    Resampler(uint32_t inputSampleRate, uint32_t outputSampleRate, uint32_t channelCount, configuration::ResamplerQuality quality);
+
+    void process(const int16_t* input, size_t frameCount, std::vector<float>& output);
+    void process(const int16_t* input, size_t frameCount, std::vector<int16_t>& output);
+    void reset();
+    uint32_t getInputSampleRate() const;
+    uint32_t getOutputSampleRate() const;
+
+private:
+    void designFilter(double cutoff, double kaiserBeta);
+
+    uint32_t inputSampleRate_;
+    uint32_t outputSampleRate_;
+    uint32_t channelCount_;
+    uint32_t interpolation_;
+    uint32_t decimation_;
+    size_t tapsPerPhase_;
+    std::vector<std::vector<float>> phases_;
+    std::vector<std::vector<float>> history_;
+    std::vector<float> converted_;
+    size_t inputIndex_;
+    uint32_t phase_;
+};
+
+}
+}
+}
+}
@@ -18,9 +18,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <RtAudio.h>
 #include <f1x/openauto/autoapp/Projection/IAudioOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/SequentialBuffer.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioSourceReader.hpp>
 
 namespace f1x
 {
@@ -34,27 +38,43 @@ namespace projection
 class RtAudioOutput: public IAudioOutput
 {
 public:
-    RtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate);
+    RtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference);
     bool open() override;
     void write(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer) override;
     void start() override;
     void stop() override;
     void suspend() override;
+    void setGain(float gain) override;
     uint32_t getSampleSize() const override;
     uint32_t getChannelCount() const override;
     uint32_t getSampleRate() const override;
+    void setSource(IAudioSource::Pointer source);
 
 private:
     void doSuspend();
+    uint32_t selectDeviceSampleRate(const RtAudio::DeviceInfo& deviceInfo) const;
+    void applyGain(int16_t* samples, size_t frameCount);
     static int audioBufferReadHandler(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames,
                                       double streamTime, RtAudioStreamStatus status, void* userData);
 
     uint32_t channelCount_;
     uint32_t sampleSize_;
     uint32_t sampleRate_;
+    uint32_t deviceSampleRate_;
+    configuration::ResamplerQuality resamplerQuality_;
+    Resampler::Pointer resampler_;
+    std::vector<int16_t> resampled_;
+    std::atomic<float> gain_;
+    float currentGain_;
     SequentialBuffer audioBuffer_;
+    EchoReference::Pointer echoReference_;
+    EchoReference::SourceId echoReferenceSourceId_;
+    std::weak_ptr<IAudioSource> source_;
+    AudioSourceReader::Pointer sourceReader_;
     std::unique_ptr<RtAudio> dac_;
     std::mutex mutex_;
+
+    static constexpr float cGainRampPerFrame = 1.0f / 2400.0f;
 };
 
 }
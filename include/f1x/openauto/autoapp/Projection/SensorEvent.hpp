@@ -0,0 +1,47 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// fixed point units follow the GPSLocation message
+struct LocationData
+{
+    uint64_t timestamp;     // milliseconds since epoch
+    int32_t latitude;       // degrees * 1e7
+    int32_t longitude;      // degrees * 1e7
+    uint32_t accuracy;      // meters * 1e3
+    int32_t altitude;       // meters * 1e2
+    int32_t speed;          // meters per second * 1e3
+    int32_t bearing;        // degrees * 1e6
+};
+
+}
+}
+}
+}
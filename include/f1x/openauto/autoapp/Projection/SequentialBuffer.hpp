@@ -19,6 +19,7 @@
 #pragma once
 
 #include <QIODevice>
+#include <functional>
 #include <mutex>
 #include <boost/circular_buffer.hpp>
 #include <f1x/aasdk/Common/Data.hpp>
@@ -35,7 +36,18 @@ namespace projection
 class SequentialBuffer: public QIODevice
 {
 public:
-    SequentialBuffer();
+    typedef std::function<void(const char* data, size_t size)> ReadHandler;
+
+    // Audio keeps the newest samples, so a full buffer overwrites the oldest data. An encoded
+    // stream cannot lose bytes in the middle, so the video buffer refuses the write instead
+    // and reports it through hasOverflowed().
+    enum class OverflowPolicy
+    {
+        OVERWRITE_OLDEST,
+        REFUSE_WRITE
+    };
+
+    explicit SequentialBuffer(OverflowPolicy overflowPolicy = OverflowPolicy::OVERWRITE_OLDEST);
     bool isSequential() const override;
     qint64 size() const override;
     qint64 pos() const override;
@@ -45,6 +57,9 @@ public:
     bool canReadLine() const override;
     qint64 bytesAvailable() const override;
     bool open(OpenMode mode) override;
+    size_t getBufferedSize() const;
+    bool hasOverflowed() const;
+    void setReadHandler(ReadHandler handler);
 
 protected:
     qint64 readData(char *data, qint64 maxlen) override;
@@ -53,6 +68,9 @@ protected:
 private:
     boost::circular_buffer<aasdk::common::Data::value_type> data_;
     mutable std::mutex mutex_;
+    OverflowPolicy overflowPolicy_;
+    bool overflowed_;
+    ReadHandler readHandler_;
 };
 
 }
@@ -0,0 +1,73 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_SHM
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/shmclient/SharedMemoryLayout.h>
+#include <f1x/openauto/autoapp/Projection/VideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoDecoder.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Publishes decoded frames into a POSIX shared memory ring, see SharedMemoryLayout.h, for an
+// external HMI to composite. Nothing is shown by autoapp itself. The segment outlives sessions
+// so a client can keep it mapped across reconnections.
+class SharedMemoryVideoOutput: public VideoOutput, boost::noncopyable
+{
+public:
+    SharedMemoryVideoOutput(configuration::IConfiguration::Pointer configuration);
+
+    bool open() override;
+    bool init() override;
+    void write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer) override;
+    void stop() override;
+    uint64_t getDecodeErrorsCount() const override;
+
+private:
+    void publishFrame(const AVFrame* frame);
+    void release();
+
+    static size_t getSlotSize();
+
+    std::mutex mutex_;
+    bool isActive_;
+    uint8_t* map_;
+    size_t size_;
+    openauto_shm_header* header_;
+    VideoDecoder decoder_;
+    uint64_t timestamp_;
+    std::atomic<uint64_t> decodeErrorsCount_;
+};
+
+}
+}
+}
+}
+
+#endif
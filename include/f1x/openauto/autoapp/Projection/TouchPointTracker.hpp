@@ -0,0 +1,54 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <f1x/openauto/autoapp/Projection/InputEvent.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+class TouchPointTracker
+{
+public:
+    TouchEvent press(int touchPointId, uint32_t x, uint32_t y);
+    bool move(int touchPointId, uint32_t x, uint32_t y);
+    TouchEvent release(int touchPointId);
+    TouchEvent drag() const;
+    TouchEvent cancel();
+    bool contains(int touchPointId) const;
+    bool empty() const;
+
+private:
+    TouchEvent createEvent(aasdk::proto::enums::TouchAction::Enum type, int touchPointId) const;
+    uint32_t allocatePointerId() const;
+
+    std::map<int, TouchLocation> touchPoints_;
+};
+
+}
+}
+}
+}
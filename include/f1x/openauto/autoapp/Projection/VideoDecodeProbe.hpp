@@ -0,0 +1,69 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Estimates how many pixels per second the host can decode in software.
+// Each synthetic frame runs the per-pixel H.264 reconstruction work:
+// bilinear motion compensation of 16x16 macroblocks followed by the 4x4
+// inverse core transform and clamping of the residual.
+class VideoDecodeProbe
+{
+public:
+    VideoDecodeProbe();
+
+    uint64_t run();
+
+    // The probe runs once per process and its result is shared. startAsync() runs it on its own thread
+    // at startup, getPixelRate() waits for that result and only runs the probe itself if it was never started.
+    static void startAsync();
+    static uint64_t getPixelRate();
+
+private:
+    static void start(std::launch policy);
+    void decodeFrame(uint32_t seed);
+    void reconstructBlock(uint8_t* destination, const uint8_t* reference, size_t stride, uint32_t& seed);
+
+    std::vector<uint8_t> reference_;
+    std::vector<uint8_t> frame_;
+
+    static constexpr size_t cWidth = 800;
+    static constexpr size_t cHeight = 480;
+    static constexpr size_t cMacroblockSize = 16;
+    static constexpr int64_t cMinDuration = 50;
+    static constexpr size_t cMinFrames = 4;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,69 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_AVCODEC
+#pragma once
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+#include <functional>
+#include <boost/noncopyable.hpp>
+#include <f1x/aasdk/Common/Data.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+// Software H.264 decoding for the outputs that present frames on their own. Only slice threading
+// is used, since frame threading would hold back as many frames as there are threads.
+class VideoDecoder: boost::noncopyable
+{
+public:
+    typedef std::function<void(const AVFrame*)> FrameHandler;
+
+    VideoDecoder();
+    ~VideoDecoder();
+
+    bool open();
+    void close();
+    bool decode(const aasdk::common::DataConstBuffer& buffer, const FrameHandler& handler);
+    bool convert(const AVFrame* frame, AVPixelFormat format, int width, int height, uint8_t* const planes[], const int strides[]);
+
+private:
+    AVCodecContext* codecContext_;
+    AVPacket* packet_;
+    AVFrame* frame_;
+    SwsContext* swsContext_;
+    aasdk::common::Data packetData_;
+};
+
+}
+}
+}
+}
+
+#endif
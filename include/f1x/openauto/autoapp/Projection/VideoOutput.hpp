@@ -39,9 +39,25 @@ public:
     aasdk::proto::enums::VideoResolution::Enum getVideoResolution() const override;
     size_t getScreenDPI() const override;
     QRect getVideoMargins() const override;
+    VideoConfigs getVideoConfigs() const override;
+    float getBacklog() const override;
+    uint64_t getDecodeErrorsCount() const override;
 
 protected:
+    virtual uint64_t getDecodePixelRate() const;
+
     configuration::IConfiguration::Pointer configuration_;
+
+private:
+    VideoConfig createVideoConfig(aasdk::proto::enums::VideoResolution::Enum resolution, aasdk::proto::enums::VideoFPS::Enum fps) const;
+
+    static uint32_t getVideoWidth(aasdk::proto::enums::VideoResolution::Enum resolution);
+    static uint32_t getVideoHeight(aasdk::proto::enums::VideoResolution::Enum resolution);
+    static uint32_t getFramesPerSecond(aasdk::proto::enums::VideoFPS::Enum fps);
+    static uint64_t getPixelRate(aasdk::proto::enums::VideoResolution::Enum resolution, aasdk::proto::enums::VideoFPS::Enum fps);
+
+    // one snapshot per output, so everything reported to the phone for a session agrees
+    configuration::ConfigurationSnapshot::Pointer snapshot_;
 };
 
 }
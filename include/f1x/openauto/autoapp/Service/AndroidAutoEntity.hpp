@@ -27,6 +27,7 @@
 #include <f1x/openauto/autoapp/Service/IAndroidAutoEntity.hpp>
 #include <f1x/openauto/autoapp/Service/IService.hpp>
 #include <f1x/openauto/autoapp/Service/IPinger.hpp>
+#include <f1x/openauto/autoapp/Service/IAudioFocusArbiter.hpp>
 
 namespace f1x
 {
@@ -46,7 +47,8 @@ public:
                       aasdk::messenger::IMessenger::Pointer messenger,
                       configuration::IConfiguration::Pointer configuration,
                       ServiceList serviceList,
-                      IPinger::Pointer pinger);
+                      IPinger::Pointer pinger,
+                      IAudioFocusArbiter::Pointer audioFocusArbiter);
     ~AndroidAutoEntity() override;
 
     void start(IAndroidAutoEntityEventHandler& eventHandler) override;
@@ -75,6 +77,7 @@ private:
     configuration::IConfiguration::Pointer configuration_;
     ServiceList serviceList_;
     IPinger::Pointer pinger_;
+    IAudioFocusArbiter::Pointer audioFocusArbiter_;
     IAndroidAutoEntityEventHandler* eventHandler_;
 };
 
@@ -23,6 +23,7 @@
 #include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
 #include <f1x/openauto/autoapp/Service/IAndroidAutoEntityFactory.hpp>
 #include <f1x/openauto/autoapp/Service/IServiceFactory.hpp>
+#include <f1x/openauto/autoapp/Service/IAudioFocusArbiter.hpp>
 
 namespace f1x
 {
@@ -38,7 +39,8 @@ class AndroidAutoEntityFactory: public IAndroidAutoEntityFactory
 public:
     AndroidAutoEntityFactory(boost::asio::io_service& ioService,
                              configuration::IConfiguration::Pointer configuration,
-                             IServiceFactory& serviceFactory);
+                             IServiceFactory& serviceFactory,
+                             IAudioFocusArbiter::Pointer audioFocusArbiter);
 
     IAndroidAutoEntity::Pointer create(aasdk::usb::IAOAPDevice::Pointer aoapDevice) override;
     IAndroidAutoEntity::Pointer create(aasdk::tcp::ITCPEndpoint::Pointer tcpEndpoint) override;
@@ -49,6 +51,7 @@ private:
     boost::asio::io_service& ioService_;
     configuration::IConfiguration::Pointer configuration_;
     IServiceFactory& serviceFactory_;
+    IAudioFocusArbiter::Pointer audioFocusArbiter_;
 };
 
 }
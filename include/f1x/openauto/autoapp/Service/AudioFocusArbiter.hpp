@@ -0,0 +1,55 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <f1x/openauto/autoapp/Service/IAudioFocusArbiter.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+class AudioFocusArbiter: public IAudioFocusArbiter
+{
+public:
+    AudioFocusArbiter(float duckingGain);
+
+    void registerOutput(aasdk::messenger::ChannelId channelId, projection::FocusedAudioOutput::Pointer audioOutput) override;
+    aasdk::proto::enums::AudioFocusState::Enum requestFocus(aasdk::proto::enums::AudioFocusType::Enum audioFocusType) override;
+    void reset() override;
+
+private:
+    void applyFocus(aasdk::messenger::ChannelId channelId, projection::FocusedAudioOutput& audioOutput);
+
+    float duckingGain_;
+    aasdk::proto::enums::AudioFocusType::Enum audioFocusType_;
+    std::map<aasdk::messenger::ChannelId, std::weak_ptr<projection::FocusedAudioOutput>> audioOutputs_;
+    std::mutex mutex_;
+};
+
+}
+}
+}
+}
@@ -21,6 +21,7 @@
 #include <f1x/aasdk/Channel/AV/AVInputServiceChannel.hpp>
 #include <f1x/openauto/autoapp/Service/IService.hpp>
 #include <f1x/openauto/autoapp/Projection/IAudioInput.hpp>
+#include <f1x/openauto/autoapp/Projection/IAudioInputProcessor.hpp>
 
 namespace f1x
 {
@@ -36,7 +37,8 @@ class AudioInputService: public aasdk::channel::av::IAVInputServiceChannelEventH
 public:
     typedef std::shared_ptr<AudioInputService> Pointer;
 
-    AudioInputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IAudioInput::Pointer audioInput);
+    AudioInputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IAudioInput::Pointer audioInput,
+                      projection::IAudioInputProcessor::Pointer audioInputProcessor);
 
     void start() override;
     void stop() override;
@@ -56,6 +58,7 @@ private:
     boost::asio::io_service::strand strand_;
     aasdk::channel::av::AVInputServiceChannel::Pointer channel_;
     projection::IAudioInput::Pointer audioInput_;
+    projection::IAudioInputProcessor::Pointer audioInputProcessor_;
     int32_t session_;
 };
 
@@ -0,0 +1,102 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <f1x/aasdk/Common/Data.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+// Holds frames back by a fixed latency and releases them on the schedule given by their stream
+// timestamps (microseconds), so network jitter is absorbed here instead of showing up as judder.
+// The first frame anchors stream time to the local clock. A timestamp discontinuity re-anchors the
+// schedule. Late droppable frames are skipped. A late reference frame is released at once, because
+// the frames after it depend on it, and the schedule is re-anchored for the frames that follow.
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Frame
+    {
+        uint64_t timestamp;
+        aasdk::common::Data data;
+        bool droppable;
+        Clock::time_point deadline;
+    };
+
+    FramePacer(uint32_t latencyTarget);
+
+    bool isEnabled() const;
+    void setLatencyTarget(uint32_t latencyTarget);
+    void push(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer, bool droppable, Clock::time_point now);
+    const Frame* pop(Clock::time_point now);
+    bool isEmpty() const;
+    Clock::time_point getNextDeadline() const;
+    void reset();
+    uint64_t getPresentedFramesCount() const;
+    uint64_t getDroppedFramesCount() const;
+    uint64_t getLateFramesCount() const;
+    uint64_t getJudderCount() const;
+    double getFrameTimeMean() const;
+    double getFrameTimeVariance() const;
+
+private:
+    void anchor(uint64_t timestamp, Clock::time_point time);
+    void recordPresentation(uint64_t timestamp, Clock::time_point now);
+
+    Clock::duration latencyTarget_;
+    std::deque<Frame> frames_;
+    std::vector<aasdk::common::Data> spareBuffers_;
+    Frame currentFrame_;
+    bool anchored_;
+    uint64_t anchorTimestamp_;
+    Clock::time_point anchorTime_;
+    uint64_t lastTimestamp_;
+    Clock::duration frameInterval_;
+    bool presented_;
+    uint64_t lastPresentedTimestamp_;
+    Clock::time_point lastPresentationTime_;
+    uint64_t presentedFramesCount_;
+    uint64_t droppedFramesCount_;
+    uint64_t lateFramesCount_;
+    uint64_t judderCount_;
+    uint64_t frameTimesCount_;
+    double frameTimeMean_;
+    double frameTimeM2_;
+
+    static constexpr size_t cMaxQueueSize = 16;
+    static constexpr uint64_t cMaxTimestampGap = 1000000;
+    static constexpr uint32_t cDefaultFrameInterval = 16667;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,51 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <f1x/aasdk/Messenger/ChannelId.hpp>
+#include <aasdk_proto/AudioFocusTypeEnum.pb.h>
+#include <aasdk_proto/AudioFocusStateEnum.pb.h>
+#include <f1x/openauto/autoapp/Projection/FocusedAudioOutput.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+class IAudioFocusArbiter
+{
+public:
+    typedef std::shared_ptr<IAudioFocusArbiter> Pointer;
+
+    virtual ~IAudioFocusArbiter() = default;
+
+    virtual void registerOutput(aasdk::messenger::ChannelId channelId, projection::FocusedAudioOutput::Pointer audioOutput) = 0;
+    virtual aasdk::proto::enums::AudioFocusState::Enum requestFocus(aasdk::proto::enums::AudioFocusType::Enum audioFocusType) = 0;
+    virtual void reset() = 0;
+};
+
+}
+}
+}
+}
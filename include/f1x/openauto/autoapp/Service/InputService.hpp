@@ -20,6 +20,7 @@
 
 #include <aasdk_proto/ButtonCodeEnum.pb.h>
 #include <f1x/aasdk/Channel/Input/InputServiceChannel.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
 #include <f1x/openauto/autoapp/Service/IService.hpp>
 #include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
 #include <f1x/openauto/autoapp/Projection/IInputDeviceEventHandler.hpp>
@@ -37,10 +38,11 @@ class InputService:
         public aasdk::channel::input::IInputServiceChannelEventHandler,
         public IService,
         public projection::IInputDeviceEventHandler,
+        public configuration::IConfigurationObserver,
         public std::enable_shared_from_this<InputService>
 {
 public:
-    InputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice);
+    InputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice, configuration::IConfiguration::Pointer configuration);
 
     void start() override;
     void stop() override;
@@ -50,13 +52,42 @@ public:
     void onChannelError(const aasdk::error::Error& e) override;
     void onButtonEvent(const projection::ButtonEvent& event) override;
     void onTouchEvent(const projection::TouchEvent& event) override;
+    void onConfigurationChanged(const ChangedKeys& changedKeys) override;
 
 private:
     using std::enable_shared_from_this<InputService>::shared_from_this;
+    void sendTouchEvent(const projection::TouchEvent& event, std::chrono::microseconds timestamp);
+    void flushPendingDragEvent();
+    void onCoalescingTimerExpired(const boost::system::error_code& error);
+    void sendButtonEvent(aasdk::proto::enums::ButtonCode::Enum buttonCode, bool pressed, bool longPress, std::chrono::microseconds timestamp);
+    void sendRelativeEvent(int32_t delta, std::chrono::microseconds timestamp);
+    void flushWheelTicks();
+    void onWheelTimerExpired(const boost::system::error_code& error);
+    void onLongPressTimerExpired(const boost::system::error_code& error);
 
     boost::asio::io_service::strand strand_;
+    boost::asio::deadline_timer coalescingTimer_;
+    boost::asio::deadline_timer wheelTimer_;
+    boost::asio::deadline_timer longPressTimer_;
     aasdk::channel::input::InputServiceChannel::Pointer channel_;
     projection::IInputDevice::Pointer inputDevice_;
+    configuration::IConfiguration::Pointer configuration_;
+    uint32_t coalescingWindow_;
+    bool wheelEventPending_;
+    float wheelDelta_;
+    std::chrono::microseconds wheelTimestamp_;
+    bool buttonHeld_;
+    bool longPressTriggered_;
+    aasdk::proto::enums::ButtonCode::Enum heldButtonCode_;
+    bool dragEventPending_;
+    projection::TouchEvent pendingDragEvent_;
+    std::chrono::microseconds pendingDragTimestamp_;
+    uint64_t touchEventsCount_;
+    uint64_t touchMessagesCount_;
+
+    static constexpr uint32_t cLongPressTimeout = 800;
+    static constexpr float cAccelerationThreshold = 15.0f;
+    static constexpr float cMaxAcceleration = 4.0f;
 };
 
 }
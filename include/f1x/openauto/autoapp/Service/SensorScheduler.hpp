@@ -0,0 +1,87 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <vector>
+#include <aasdk_proto/SensorTypeEnum.pb.h>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+struct SensorPolicy
+{
+    uint32_t minInterval;   // milliseconds between two indications of the sensor, the inverse of its maximum rate
+    double minDelta;        // samples closer than this to the last sent value are not worth an indication
+    uint32_t heartbeat;     // milliseconds after which an unchanged value is repeated, 0 disables
+};
+
+// Decides which sensors are due and groups them into batches. It keeps no values and owns no timer:
+// the caller reports samples with their distance from the last sent value, sends the sensors returned
+// by collect() in one indication and waits until getNextDeadline().
+class SensorScheduler
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    typedef std::vector<aasdk::proto::enums::SensorType::Enum> SensorTypes;
+
+    SensorScheduler();
+
+    void setPolicy(aasdk::proto::enums::SensorType::Enum sensorType, const SensorPolicy& policy);
+    void start(aasdk::proto::enums::SensorType::Enum sensorType);
+    void reset();
+    bool submit(aasdk::proto::enums::SensorType::Enum sensorType, double delta);
+    bool collect(TimePoint now, SensorTypes& sensorTypes);
+    bool getNextDeadline(TimePoint& deadline) const;
+    uint64_t getSamplesCount() const;
+    uint64_t getIndicationsCount() const;
+    uint64_t getSensorEventsCount() const;
+
+private:
+    struct SensorState
+    {
+        SensorPolicy policy;
+        bool started;
+        bool pending;
+        bool hasValue;
+        TimePoint lastSent;
+    };
+
+    static TimePoint getDueTime(const SensorState& state);
+
+    std::map<aasdk::proto::enums::SensorType::Enum, SensorState> sensors_;
+    uint64_t samplesCount_;
+    uint64_t indicationsCount_;
+    uint64_t sensorEventsCount_;
+
+    // sensors falling due this soon after the first one ride along in the same indication
+    static constexpr uint32_t cBatchWindow = 20;
+};
+
+}
+}
+}
+}
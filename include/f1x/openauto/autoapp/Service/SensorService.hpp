@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <f1x/aasdk/Channel/Sensor/SensorServiceChannel.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProviderEventHandler.hpp>
 #include <f1x/openauto/autoapp/Service/IService.hpp>
+#include <f1x/openauto/autoapp/Service/SensorScheduler.hpp>
 
 namespace f1x
 {
@@ -30,10 +34,12 @@ namespace autoapp
 namespace service
 {
 
-class SensorService: public aasdk::channel::sensor::ISensorServiceChannelEventHandler, public IService, public std::enable_shared_from_this<SensorService>
+class SensorService: public aasdk::channel::sensor::ISensorServiceChannelEventHandler, public IService, public projection::ISensorProviderEventHandler, public std::enable_shared_from_this<SensorService>
 {
 public:
-    SensorService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger);
+    typedef std::vector<projection::ISensorProvider::Pointer> SensorProviders;
+
+    SensorService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, SensorProviders sensorProviders);
 
     void start() override;
     void stop() override;
@@ -41,14 +47,36 @@ public:
     void onChannelOpenRequest(const aasdk::proto::messages::ChannelOpenRequest& request) override;
     void onSensorStartRequest(const aasdk::proto::messages::SensorStartRequestMessage& request) override;
     void onChannelError(const aasdk::error::Error& e) override;
+    void onLocationUpdate(const projection::LocationData& location) override;
+    void onSpeedUpdate(int32_t speed) override;
+    void onNightModeUpdate(bool isNight) override;
 
 private:
     using std::enable_shared_from_this<SensorService>::shared_from_this;
-    void sendDrivingStatusUnrestricted();
-    void sendNightData();
+
+    bool isSensorAvailable(aasdk::proto::enums::SensorType::Enum sensorType) const;
+    void onSensorStarted(aasdk::proto::enums::SensorType::Enum sensorType);
+    void submit(aasdk::proto::enums::SensorType::Enum sensorType);
+    double getDelta(aasdk::proto::enums::SensorType::Enum sensorType) const;
+    void flush();
+    bool fillIndication(aasdk::proto::enums::SensorType::Enum sensorType, aasdk::proto::messages::SensorEventIndication& indication);
+    void armUpdateTimer();
+    void onUpdateTimerExpired(const boost::system::error_code& error);
 
     boost::asio::io_service::strand strand_;
+    boost::asio::deadline_timer updateTimer_;
     aasdk::channel::sensor::SensorServiceChannel::Pointer channel_;
+    SensorProviders sensorProviders_;
+    SensorScheduler scheduler_;
+    SensorScheduler::SensorTypes dueSensorTypes_;
+    bool updateTimerArmed_;
+    SensorScheduler::TimePoint updateTimerDeadline_;
+    boost::optional<projection::LocationData> location_;
+    boost::optional<projection::LocationData> sentLocation_;
+    boost::optional<int32_t> speed_;
+    boost::optional<int32_t> sentSpeed_;
+    bool isNight_;
+    boost::optional<bool> sentNight_;
 };
 
 }
@@ -19,7 +19,12 @@
 #pragma once
 
 #include <f1x/openauto/autoapp/Service/IServiceFactory.hpp>
+#include <f1x/openauto/autoapp/Service/IAudioFocusArbiter.hpp>
 #include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioMixer.hpp>
+#include <f1x/openauto/autoapp/Projection/IAudioOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
 
 namespace f1x
 {
@@ -33,17 +38,24 @@ namespace service
 class ServiceFactory: public IServiceFactory
 {
 public:
-    ServiceFactory(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration);
+    ServiceFactory(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, IAudioFocusArbiter::Pointer audioFocusArbiter);
     ServiceList create(aasdk::messenger::IMessenger::Pointer messenger) override;
 
 private:
-    IService::Pointer createVideoService(aasdk::messenger::IMessenger::Pointer messenger);
+    IService::Pointer createVideoService(aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice);
     IService::Pointer createBluetoothService(aasdk::messenger::IMessenger::Pointer messenger);
-    IService::Pointer createInputService(aasdk::messenger::IMessenger::Pointer messenger);
-    void createAudioServices(ServiceList& serviceList, aasdk::messenger::IMessenger::Pointer messenger);
+    projection::IInputDevice::Pointer createInputDevice();
+    IService::Pointer createSensorService(aasdk::messenger::IMessenger::Pointer messenger);
+    void createAudioServices(ServiceList& serviceList, aasdk::messenger::IMessenger::Pointer messenger, projection::EchoReference::Pointer echoReference);
+    projection::IAudioOutput::Pointer createFocusedAudioOutput(aasdk::messenger::ChannelId channelId, projection::IAudioOutput::Pointer audioOutput);
+    projection::IAudioOutput::Pointer createAudioOutput(projection::AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, projection::AudioMixer::Pointer audioMixer,
+                                                        projection::EchoReference::Pointer echoReference);
+    projection::IAudioOutput::Pointer createAudioBackendOutput(uint32_t channelCount, uint32_t sampleRate, projection::EchoReference::Pointer echoReference, projection::IAudioSource::Pointer source);
+    projection::AudioMixer::Pointer createAudioMixer(projection::EchoReference::Pointer echoReference);
 
     boost::asio::io_service& ioService_;
     configuration::IConfiguration::Pointer configuration_;
+    IAudioFocusArbiter::Pointer audioFocusArbiter_;
 };
 
 }
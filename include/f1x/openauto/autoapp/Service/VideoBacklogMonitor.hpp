@@ -0,0 +1,86 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <f1x/openauto/autoapp/Projection/NalParser.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+enum class VideoFrameType
+{
+    IDR,
+    REFERENCE,
+    NON_REFERENCE,
+    OTHER
+};
+
+// Keeps the video path from running ahead of the decoder. The caller reports each frame with the
+// output backlog (0 = drained, 1 = full or data lost) and forwards it only if submit() agrees.
+// Above the high watermark non-reference frames are dropped until an IDR arrives with the backlog
+// drained below the low watermark. After data loss everything but IDR frames is dropped, because
+// the decoder has no valid reference to build on. canAcknowledge() tells whether acking the phone
+// now is safe, or whether the ack should be held back to throttle the encoder.
+class VideoBacklogMonitor
+{
+public:
+    VideoBacklogMonitor();
+
+    bool submit(VideoFrameType frameType, float backlog);
+    bool canAcknowledge(float backlog) const;
+    void requestResync();
+    bool isResyncing() const;
+    void reset();
+    uint64_t getFramesCount() const;
+    uint64_t getDroppedFramesCount() const;
+    uint64_t getDegradationsCount() const;
+
+    static VideoFrameType getFrameType(const projection::AccessUnit& accessUnit);
+
+private:
+    enum class State
+    {
+        NORMAL,
+        DEGRADED,
+        RESYNC
+    };
+
+    void setState(State state, float backlog);
+
+    State state_;
+    uint64_t framesCount_;
+    uint64_t droppedFramesCount_;
+    uint64_t degradationsCount_;
+
+    static constexpr float cHighWatermark = 0.5f;
+    static constexpr float cLowWatermark = 0.25f;
+    static constexpr float cOverflow = 1.0f;
+};
+
+}
+}
+}
+}
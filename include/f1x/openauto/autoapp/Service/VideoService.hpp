@@ -18,11 +18,16 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <f1x/aasdk/Channel/AV/VideoServiceChannel.hpp>
 #include <f1x/aasdk/Channel/AV/IVideoServiceChannelEventHandler.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+#include <f1x/openauto/autoapp/Projection/IInputDevice.hpp>
 #include <f1x/openauto/autoapp/Projection/IVideoOutput.hpp>
 #include <f1x/openauto/autoapp/Service/IService.hpp>
+#include <f1x/openauto/autoapp/Service/VideoBacklogMonitor.hpp>
+#include <f1x/openauto/autoapp/Service/FramePacer.hpp>
 
 namespace f1x
 {
@@ -33,12 +38,13 @@ namespace autoapp
 namespace service
 {
 
-class VideoService: public aasdk::channel::av::IVideoServiceChannelEventHandler, public IService, public std::enable_shared_from_this<VideoService>
+class VideoService: public aasdk::channel::av::IVideoServiceChannelEventHandler, public IService, public configuration::IConfigurationObserver, public std::enable_shared_from_this<VideoService>
 {
 public:
     typedef std::shared_ptr<VideoService> Pointer;
 
-    VideoService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IVideoOutput::Pointer videoOutput);
+    VideoService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IVideoOutput::Pointer videoOutput, projection::IInputDevice::Pointer inputDevice,
+                 configuration::IConfiguration::Pointer configuration);
 
     void start() override;
     void stop() override;
@@ -50,15 +56,54 @@ public:
     void onAVMediaIndication(const aasdk::common::DataConstBuffer& buffer) override;
     void onVideoFocusRequest(const aasdk::proto::messages::VideoFocusRequest& request) override;
     void onChannelError(const aasdk::error::Error& e) override;
+    void onConfigurationChanged(const ChangedKeys& changedKeys) override;
 
 private:
     using std::enable_shared_from_this<VideoService>::shared_from_this;
     void sendVideoFocusIndication();
+    void sendVideoFocusModeIndication(aasdk::proto::enums::VideoFocusMode::Enum focusMode);
+    void writeFrame(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer);
+    void presentFrame(const projection::AccessUnit& accessUnit, VideoFrameType frameType);
+    void releaseFrames();
+    void onPacingTimerExpired(const boost::system::error_code& error);
+    void acknowledgeFrame();
+    void sendMediaAckIndication();
+    void onAckTimerExpired(const boost::system::error_code& error);
+    void startRecovery(const std::string& reason);
+    void requestKeyframe();
+    void finishRecovery();
+    void onRecoveryTimerExpired(const boost::system::error_code& error);
 
     boost::asio::io_service::strand strand_;
     aasdk::channel::av::VideoServiceChannel::Pointer channel_;
     projection::IVideoOutput::Pointer videoOutput_;
+    projection::IInputDevice::Pointer inputDevice_;
+    configuration::IConfiguration::Pointer configuration_;
+    projection::IVideoOutput::VideoConfigs videoConfigs_;
     int32_t session_;
+    VideoBacklogMonitor backlogMonitor_;
+    projection::NalParser::AccessUnits accessUnits_;
+    FramePacer framePacer_;
+    boost::asio::deadline_timer pacingTimer_;
+    boost::asio::deadline_timer ackTimer_;
+    uint32_t pendingAcks_;
+    std::chrono::steady_clock::time_point ackDeferredTimestamp_;
+    uint64_t deferredAcksCount_;
+    boost::asio::deadline_timer recoveryTimer_;
+    bool recovering_;
+    bool awaitingFirstIDR_;
+    uint32_t keyframeRequestsCount_;
+    std::chrono::steady_clock::time_point recoveryTimestamp_;
+    uint64_t decodeErrorsCount_;
+    uint64_t recoveriesCount_;
+    int64_t recoveryTimeTotal_;
+    int64_t recoveryTimeMax_;
+
+    static constexpr uint32_t cAckPollInterval = 5;
+    static constexpr uint32_t cMaxAckDelay = 200;
+    static constexpr uint32_t cKeyframeRequestInterval = 500;
+    static constexpr uint32_t cMaxKeyframeRequestInterval = 4000;
+    static constexpr uint32_t cMaxKeyframeRequests = 8;
 };
 
 }
@@ -0,0 +1,89 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <list>
+#include <set>
+#include <chrono>
+#include <boost/asio.hpp>
+#include <f1x/aasdk/TCP/ITCPWrapper.hpp>
+#include <f1x/openauto/autoapp/TCP/IAutoConnector.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace tcp
+{
+
+class AutoConnector: public IAutoConnector, public std::enable_shared_from_this<AutoConnector>
+{
+public:
+    AutoConnector(boost::asio::io_service& ioService, aasdk::tcp::ITCPWrapper& tcpWrapper, configuration::IConfiguration::Pointer configuration);
+
+    void connect(Addresses addresses, Promise::Pointer promise) override;
+    void addAddress(const std::string& address) override;
+    void cancel() override;
+
+private:
+    using std::enable_shared_from_this<AutoConnector>::shared_from_this;
+
+    struct Attempt
+    {
+        typedef std::shared_ptr<Attempt> Pointer;
+
+        Attempt(boost::asio::io_service& ioService, const std::string& address);
+
+        std::string address;
+        aasdk::tcp::ITCPEndpoint::SocketPointer socket;
+        boost::asio::deadline_timer timer;
+    };
+
+    void enqueueAddress(const std::string& address);
+    void startNextAttempt();
+    void onStaggerTimerExpired(const boost::system::error_code& error);
+    void onAttemptTimeout(const boost::system::error_code& error, Attempt::Pointer attempt);
+    void onConnected(const boost::system::error_code& error, Attempt::Pointer attempt);
+    void abortAttempts();
+    void rejectPromise();
+
+    boost::asio::io_service& ioService_;
+    boost::asio::io_service::strand strand_;
+    aasdk::tcp::ITCPWrapper& tcpWrapper_;
+    configuration::IConfiguration::Pointer configuration_;
+    boost::asio::deadline_timer staggerTimer_;
+    Addresses pendingAddresses_;
+    std::set<std::string> knownAddresses_;
+    std::list<Attempt::Pointer> attempts_;
+    Promise::Pointer promise_;
+    boost::system::error_code lastError_;
+    std::chrono::steady_clock::time_point startTimestamp_;
+
+    static constexpr uint16_t cPort = 5277;
+    static constexpr time_t cStaggerDelay = 250;
+    static constexpr time_t cAttemptTimeout = 3000;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,51 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <f1x/aasdk/IO/Promise.hpp>
+#include <f1x/aasdk/TCP/ITCPEndpoint.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace tcp
+{
+
+class IAutoConnector
+{
+public:
+    typedef std::shared_ptr<IAutoConnector> Pointer;
+    typedef std::deque<std::string> Addresses;
+    typedef aasdk::io::Promise<aasdk::tcp::ITCPEndpoint::SocketPointer> Promise;
+
+    virtual ~IAutoConnector() = default;
+    virtual void connect(Addresses addresses, Promise::Pointer promise) = 0;
+    virtual void addAddress(const std::string& address) = 0;
+    virtual void cancel() = 0;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,57 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <boost/asio.hpp>
+#include <f1x/openauto/autoapp/Configuration/TCPTuningProfile.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace tcp
+{
+
+// Applies a tuning profile to a projection socket. All channels share this
+// one socket, so the profile trades between input latency (no delay, quick
+// ack) and video throughput (receive buffer). prepare() runs before the
+// connect, because the receive buffer decides the window scale offered in
+// the SYN, apply() runs on the connected socket before it is wrapped into
+// an endpoint. Failing options are logged and skipped.
+class SocketTuner
+{
+public:
+    SocketTuner(const configuration::TCPTuningProfile& profile);
+
+    void prepare(boost::asio::ip::tcp::socket& socket, const std::string& address) const;
+    void apply(boost::asio::ip::tcp::socket& socket) const;
+
+private:
+    void setIntOption(boost::asio::ip::tcp::socket& socket, int level, int name, int value, const char* label) const;
+
+    configuration::TCPTuningProfile profile_;
+};
+
+}
+}
+}
+}
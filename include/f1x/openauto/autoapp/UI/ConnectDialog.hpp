@@ -4,6 +4,7 @@
 #include <QStringListModel>
 #include <f1x/aasdk/TCP/ITCPEndpoint.hpp>
 #include <f1x/aasdk/TCP/ITCPWrapper.hpp>
+#include <f1x/openauto/autoapp/Configuration/IConfiguration.hpp>
 #include <f1x/openauto/autoapp/Configuration/IRecentAddressesList.hpp>
 
 namespace Ui {
@@ -24,7 +25,7 @@ class ConnectDialog : public QDialog
     Q_OBJECT
 
 public:
-    explicit ConnectDialog(boost::asio::io_service& ioService,  aasdk::tcp::ITCPWrapper& tcpWrapper, openauto::autoapp::configuration::IRecentAddressesList& recentAddressesList, QWidget *parent = nullptr);
+    explicit ConnectDialog(boost::asio::io_service& ioService,  aasdk::tcp::ITCPWrapper& tcpWrapper, openauto::autoapp::configuration::IConfiguration::Pointer configuration, openauto::autoapp::configuration::IRecentAddressesList& recentAddressesList, QWidget *parent = nullptr);
     ~ConnectDialog() override;
 
 signals:
@@ -46,6 +47,7 @@ private:
 
     boost::asio::io_service& ioService_;
     aasdk::tcp::ITCPWrapper& tcpWrapper_;
+    openauto::autoapp::configuration::IConfiguration::Pointer configuration_;
     openauto::autoapp::configuration::IRecentAddressesList& recentAddressesList_;
     Ui::ConnectDialog *ui_;
     QStringListModel recentAddressesModel_;
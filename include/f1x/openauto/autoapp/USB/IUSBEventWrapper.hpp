@@ -0,0 +1,54 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <libusb.h>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+
+// The part of libusb the event loop drives. aasdk's IUSBWrapper only offers the blocking
+// libusb_handle_events, the descriptor based integration needs the pollfd calls as well.
+class IUSBEventWrapper
+{
+public:
+    typedef std::shared_ptr<IUSBEventWrapper> Pointer;
+    typedef std::vector<libusb_pollfd> Pollfds;
+
+    virtual ~IUSBEventWrapper() = default;
+
+    virtual void setPollfdNotifiers(libusb_pollfd_added_cb addedCallback, libusb_pollfd_removed_cb removedCallback, void* userData) = 0;
+    virtual Pollfds getPollfds() = 0;
+    virtual int handleEventsTimeoutCompleted(timeval* timeout, int* completed) = 0;
+    virtual int pollfdsHandleTimeouts() = 0;
+    virtual int getNextTimeout(timeval* timeout) = 0;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,86 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <boost/asio.hpp>
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/USB/IUSBEventLoop.hpp>
+#include <f1x/openauto/autoapp/USB/IUSBEventWrapper.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+
+// Drives libusb from the io_service: the context's file descriptors are watched by the reactor and
+// libusb_handle_events runs on one strand only when one of them is ready, so transfers and hotplug
+// callbacks are delivered without threads blocking in libusb. The pollfd notifiers are handled
+// synchronously under a mutex, a removed descriptor is detached before libusb closes it.
+class USBEventLoop: public IUSBEventLoop, public std::enable_shared_from_this<USBEventLoop>, boost::noncopyable
+{
+public:
+    USBEventLoop(boost::asio::io_service& ioService, IUSBEventWrapper::Pointer usbEventWrapper);
+
+    void start() override;
+    void stop() override;
+
+private:
+    using std::enable_shared_from_this<USBEventLoop>::shared_from_this;
+
+    struct Watch
+    {
+        Watch(boost::asio::io_service& ioService, int fd, short events);
+
+        boost::asio::posix::stream_descriptor descriptor;
+        short events;
+    };
+
+    typedef std::shared_ptr<Watch> WatchPointer;
+
+    static void onPollfdAdded(int fd, short events, void* userData);
+    static void onPollfdRemoved(int fd, void* userData);
+    // the watches and their descriptors are only touched with mutex_ held
+    void addWatch(int fd, short events);
+    void removeWatch(int fd);
+    void wait(WatchPointer watch);
+    void onReady(WatchPointer watch, const boost::system::error_code& error);
+    void handleEvents();
+    void armTimeout();
+    void onTimeout(const boost::system::error_code& error);
+
+    boost::asio::io_service& ioService_;
+    boost::asio::io_service::strand strand_;
+    boost::asio::deadline_timer timeoutTimer_;
+    IUSBEventWrapper::Pointer usbEventWrapper_;
+    std::map<int, WatchPointer> watches_;
+    bool running_;
+    std::mutex mutex_;
+    uint64_t wakeupsCount_;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,51 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <f1x/openauto/autoapp/USB/IUSBEventWrapper.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+
+class USBEventWrapper: public IUSBEventWrapper, boost::noncopyable
+{
+public:
+    USBEventWrapper(libusb_context* usbContext);
+
+    void setPollfdNotifiers(libusb_pollfd_added_cb addedCallback, libusb_pollfd_removed_cb removedCallback, void* userData) override;
+    Pollfds getPollfds() override;
+    int handleEventsTimeoutCompleted(timeval* timeout, int* completed) override;
+    int pollfdsHandleTimeouts() override;
+    int getNextTimeout(timeval* timeout) override;
+
+private:
+    libusb_context* usbContext_;
+};
+
+}
+}
+}
+}
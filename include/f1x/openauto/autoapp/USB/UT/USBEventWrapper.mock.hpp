@@ -0,0 +1,85 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <f1x/openauto/autoapp/USB/IUSBEventWrapper.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+namespace ut
+{
+
+// Stands in for libusb: the test decides which descriptors exist and calls the registered notifiers itself.
+class USBEventWrapperMock: public IUSBEventWrapper
+{
+public:
+    void setPollfdNotifiers(libusb_pollfd_added_cb addedCallback, libusb_pollfd_removed_cb removedCallback, void* userData) override
+    {
+        this->addedCallback = addedCallback;
+        this->removedCallback = removedCallback;
+        this->userData = userData;
+    }
+
+    Pollfds getPollfds() override
+    {
+        return pollfds;
+    }
+
+    int handleEventsTimeoutCompleted(timeval*, int*) override
+    {
+        ++handleEventsCount;
+
+        if(onHandleEvents)
+        {
+            onHandleEvents();
+        }
+
+        return 0;
+    }
+
+    int pollfdsHandleTimeouts() override
+    {
+        return 1;
+    }
+
+    int getNextTimeout(timeval*) override
+    {
+        return 0;
+    }
+
+    Pollfds pollfds;
+    libusb_pollfd_added_cb addedCallback = nullptr;
+    libusb_pollfd_removed_cb removedCallback = nullptr;
+    void* userData = nullptr;
+    size_t handleEventsCount = 0;
+    std::function<void()> onHandleEvents;
+};
+
+}
+}
+}
+}
+}
@@ -0,0 +1,77 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Client side of the shared memory video output (autoapp built with SHM_BUILD).
+ *
+ * Typical use, once per display refresh:
+ *
+ *     openauto_shm_frame frame;
+ *     if(openauto_shm_acquire(client, &frame) == 1)
+ *     {
+ *         upload(frame.planes, frame.strides, frame.width, frame.height);
+ *         if(!openauto_shm_validate(client, &frame))
+ *         {
+ *             discard the upload, the writer lapped us
+ *         }
+ *     }
+ *
+ * The planes point straight into the shared segment, nothing is copied.
+ */
+
+typedef struct openauto_shm_client openauto_shm_client;
+
+typedef struct openauto_shm_frame
+{
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    const uint8_t* planes[3];
+    uint32_t strides[3];
+    uint64_t frame_number;
+    uint64_t timestamp;
+    uint32_t slot;
+    uint32_t sequence;
+} openauto_shm_frame;
+
+/* Maps the segment read-only. Returns NULL if it does not exist or has an unknown layout. */
+openauto_shm_client* openauto_shm_open(const char* name);
+
+void openauto_shm_close(openauto_shm_client* client);
+
+/* Non-zero while autoapp is streaming into the segment. */
+int openauto_shm_is_active(const openauto_shm_client* client);
+
+/* Returns 1 and fills frame if a frame newer than the last acquired one is published, 0 otherwise. */
+int openauto_shm_acquire(openauto_shm_client* client, openauto_shm_frame* frame);
+
+/* Returns 1 if the acquired frame was not overwritten while it was being used. */
+int openauto_shm_validate(const openauto_shm_client* client, const openauto_shm_frame* frame);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,79 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Layout of the shared memory segment the projection video is published in.
+ *
+ * The segment starts with an openauto_shm_header followed by OPENAUTO_SHM_SLOTS frame slots of
+ * slot_size bytes each, the first one at data_offset. The writer fills the slot after `latest`,
+ * so the newest frame and the one before it stay untouched while a new frame is being written.
+ *
+ * Every slot is guarded by a seqlock: `sequence` is odd while the slot is being written and is
+ * bumped to the next even value once the frame is complete. A reader samples the sequence,
+ * uses the frame in place and samples it again; an unchanged even value means the frame it
+ * used was not overwritten in the meantime.
+ *
+ * All fields written after initialisation are accessed with the __atomic builtins.
+ */
+
+#define OPENAUTO_SHM_MAGIC 0x3156414fu /* "OAV1" */
+#define OPENAUTO_SHM_VERSION 1u
+#define OPENAUTO_SHM_SLOTS 3u
+#define OPENAUTO_SHM_MAX_WIDTH 1920u
+#define OPENAUTO_SHM_MAX_HEIGHT 1080u
+
+/* planar YUV 4:2:0, Y plane followed by the U and V planes at half resolution */
+#define OPENAUTO_SHM_FORMAT_I420 0x30323449u
+
+typedef struct openauto_shm_slot
+{
+    uint32_t sequence;
+    uint32_t width;
+    uint32_t height;
+    uint32_t strides[3];
+    uint64_t offsets[3];
+    uint64_t frame_number;
+    uint64_t timestamp;
+} openauto_shm_slot;
+
+typedef struct openauto_shm_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t slot_count;
+    uint64_t slot_size;
+    uint64_t data_offset;
+    uint32_t active;
+    uint32_t latest;
+    uint64_t frames_count;
+    openauto_shm_slot slots[OPENAUTO_SHM_SLOTS];
+} openauto_shm_header;
+
+#ifdef __cplusplus
+}
+#endif
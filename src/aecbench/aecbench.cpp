@@ -0,0 +1,178 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioInputProcessor.hpp>
+
+namespace aasdk = f1x::aasdk;
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+constexpr uint32_t cSampleRate = 16000;
+constexpr uint32_t cOutputSampleRate = 48000;
+constexpr uint32_t cOutputChannelCount = 2;
+constexpr size_t cFrameSize = cSampleRate / 100;
+constexpr size_t cDefaultSeconds = 30;
+constexpr size_t cEchoDelay = cSampleRate * 30 / 1000;
+constexpr float cEchoGain = 0.5f;
+
+struct Mode
+{
+    const char* name;
+    bool echoCancellation;
+    bool noiseSuppression;
+};
+
+// Low-passed noise gated by a syllable-rate envelope, loud enough to keep the canceller adapting
+// for most of the run and with pauses in which the noise suppressor sees only the near-end floor.
+std::vector<float> generateSpeechLikeSignal(size_t sampleCount, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> signal(sampleCount);
+    float filtered = 0.0f;
+
+    for(size_t i = 0; i < sampleCount; ++i)
+    {
+        filtered += 0.3f * (distribution(generator) - filtered);
+        const float envelope = std::max(0.0f, std::sin(2.0f * static_cast<float>(M_PI) * 4.0f * i / cSampleRate));
+        signal[i] = 0.3f * filtered * envelope;
+    }
+
+    return signal;
+}
+
+int16_t toInt16(float sample)
+{
+    return static_cast<int16_t>(std::lround(std::max(-1.0f, std::min(1.0f, sample)) * 32767.0f));
+}
+
+double getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()))];
+}
+
+// Plays the far end through the echo reference in 10 ms blocks at the mixer format, the way an output
+// callback would, and hands the processor the matching microphone frame: the far end delayed and
+// attenuated on top of faint near-end noise. Only process() is timed.
+void runBenchmark(const Mode& mode, const std::vector<float>& farEnd, const std::vector<float>& nearEnd)
+{
+    auto echoReference = std::make_shared<autoapp::projection::EchoReference>(cSampleRate);
+    const auto sourceId = echoReference->addSource();
+    autoapp::projection::AudioInputProcessor processor(echoReference, cSampleRate);
+    processor.setEchoCancellationEnabled(mode.echoCancellation);
+    processor.setNoiseSuppressionEnabled(mode.noiseSuppression);
+
+    const size_t upsampling = cOutputSampleRate / cSampleRate;
+    std::vector<int16_t> output(cFrameSize * upsampling * cOutputChannelCount);
+    aasdk::common::Data microphone(cFrameSize * sizeof(int16_t));
+    std::vector<double> frameTimes;
+    frameTimes.reserve(farEnd.size() / cFrameSize);
+    double microphoneEnergy = 0.0;
+    double processedEnergy = 0.0;
+
+    for(size_t offset = 0; offset + cFrameSize <= farEnd.size(); offset += cFrameSize)
+    {
+        // every sample repeated at the output rate folds back to exactly the far-end signal in the reference
+        for(size_t i = 0; i < cFrameSize * upsampling; ++i)
+        {
+            std::fill_n(output.data() + i * cOutputChannelCount, cOutputChannelCount, toInt16(farEnd[offset + i / upsampling]));
+        }
+        echoReference->write(sourceId, output.data(), cFrameSize * upsampling, cOutputChannelCount, cOutputSampleRate);
+
+        auto* samples = reinterpret_cast<int16_t*>(microphone.data());
+        for(size_t i = 0; i < cFrameSize; ++i)
+        {
+            const size_t index = offset + i;
+            const float echo = index >= cEchoDelay ? cEchoGain * farEnd[index - cEchoDelay] : 0.0f;
+            samples[i] = toInt16(echo + nearEnd[index]);
+        }
+
+        // the canceller converges in the first half, the attenuation is measured over the second
+        const bool measured = offset >= farEnd.size() / 2;
+        for(size_t i = 0; measured && i < cFrameSize; ++i)
+        {
+            microphoneEnergy += static_cast<double>(samples[i]) * samples[i];
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        processor.process(microphone);
+        frameTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+        for(size_t i = 0; measured && i < cFrameSize; ++i)
+        {
+            processedEnergy += static_cast<double>(samples[i]) * samples[i];
+        }
+    }
+
+    double total = 0.0;
+    for(const auto frameTime : frameTimes)
+    {
+        total += frameTime;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    const double mean = total / frameTimes.size();
+
+    printf("%-8s mean %7.1f us, p99 %7.1f us, max %7.1f us per 10 ms frame, %5.2f%% of one core, attenuation %5.1f dB\n",
+           mode.name, mean, getPercentile(frameTimes, 0.99), frameTimes.back(), mean / 100.0,
+           processedEnergy > 0.0 ? 10.0 * std::log10(microphoneEnergy / processedEnergy) : 0.0);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+    if(argc > 2)
+    {
+        printf("usage: %s [<seconds>]\n", argv[0]);
+        printf("Runs the microphone processing on synthetic 16 kHz frames: a speech-like far end played through\n");
+        printf("the echo reference at 48 kHz stereo, and a microphone picking it up 30 ms later at half the level.\n");
+        printf("Reports the CPU time of one 10 ms frame and the attenuation of the microphone signal.\n");
+        return 2;
+    }
+
+    const size_t seconds = argc == 2 ? std::stoul(argv[1]) : cDefaultSeconds;
+    const auto farEnd = generateSpeechLikeSignal(cSampleRate * seconds, 1);
+
+    std::vector<float> nearEnd(farEnd.size());
+    std::mt19937 generator(2);
+    std::normal_distribution<float> distribution(0.0f, 0.001f);
+    std::generate(nearEnd.begin(), nearEnd.end(), [&]() { return distribution(generator); });
+
+    const Mode modes[] = {{"ns", false, true}, {"aec", true, false}, {"aec+ns", true, true}};
+    for(const auto& mode : modes)
+    {
+        runBenchmark(mode, farEnd, nearEnd);
+    }
+
+    return 0;
+}
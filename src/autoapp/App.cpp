@@ -20,6 +20,7 @@
 #include <f1x/aasdk/USB/AOAPDevice.hpp>
 #include <f1x/aasdk/TCP/TCPEndpoint.hpp>
 #include <f1x/openauto/autoapp/App.hpp>
+#include <f1x/openauto/autoapp/TCP/SocketTuner.hpp>
 #include <f1x/openauto/Common/Log.hpp>
 
 namespace f1x
@@ -29,15 +30,21 @@ namespace openauto
 namespace autoapp
 {
 
-App::App(boost::asio::io_service& ioService, aasdk::usb::USBWrapper& usbWrapper, aasdk::tcp::ITCPWrapper& tcpWrapper, service::IAndroidAutoEntityFactory& androidAutoEntityFactory,
-         aasdk::usb::IUSBHub::Pointer usbHub, aasdk::usb::IConnectedAccessoriesEnumerator::Pointer connectedAccessoriesEnumerator)
+constexpr time_t App::cAutoConnectRetryInterval;
+
+App::App(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, aasdk::usb::IUSBWrapper& usbWrapper, aasdk::tcp::ITCPWrapper& tcpWrapper, service::IAndroidAutoEntityFactory& androidAutoEntityFactory,
+         aasdk::usb::IUSBHub::Pointer usbHub, aasdk::usb::IConnectedAccessoriesEnumerator::Pointer connectedAccessoriesEnumerator,
+         tcp::IAutoConnector::Pointer autoConnector)
     : ioService_(ioService)
+    , configuration_(std::move(configuration))
     , usbWrapper_(usbWrapper)
     , tcpWrapper_(tcpWrapper)
     , strand_(ioService_)
     , androidAutoEntityFactory_(androidAutoEntityFactory)
     , usbHub_(std::move(usbHub))
     , connectedAccessoriesEnumerator_(std::move(connectedAccessoriesEnumerator))
+    , autoConnector_(std::move(autoConnector))
+    , autoConnectTimer_(ioService_)
     , isStopped_(false)
 {
 
@@ -51,6 +58,14 @@ void App::waitForUSBDevice()
     });
 }
 
+void App::autoConnect(tcp::IAutoConnector::Addresses addresses)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), addresses = std::move(addresses)]() mutable {
+        autoConnectAddresses_ = std::move(addresses);
+        this->startAutoConnect();
+    });
+}
+
 void App::start(aasdk::tcp::ITCPEndpoint::SocketPointer socket)
 {
     strand_.dispatch([this, self = this->shared_from_this(), socket = std::move(socket)]() mutable {
@@ -65,7 +80,9 @@ void App::start(aasdk::tcp::ITCPEndpoint::SocketPointer socket)
         {
             usbHub_->cancel();
             connectedAccessoriesEnumerator_->cancel();
+            this->cancelAutoConnect();
 
+            tcp::SocketTuner(configuration_->getTCPTuningProfile()).apply(*socket);
             auto tcpEndpoint(std::make_shared<aasdk::tcp::TCPEndpoint>(tcpWrapper_, std::move(socket)));
             androidAutoEntity_ = androidAutoEntityFactory_.create(std::move(tcpEndpoint));
             androidAutoEntity_->start(*this);
@@ -86,6 +103,7 @@ void App::stop()
         isStopped_ = true;
         connectedAccessoriesEnumerator_->cancel();
         usbHub_->cancel();
+        this->cancelAutoConnect();
 
         if(androidAutoEntity_ != nullptr)
         {
@@ -108,6 +126,7 @@ void App::aoapDeviceHandler(aasdk::usb::DeviceHandle deviceHandle)
     try
     {
         connectedAccessoriesEnumerator_->cancel();
+        this->cancelAutoConnect();
 
         auto aoapDevice(aasdk::usb::AOAPDevice::create(usbWrapper_, ioService_, deviceHandle));
         androidAutoEntity_ = androidAutoEntityFactory_.create(std::move(aoapDevice));
@@ -156,6 +175,7 @@ void App::onAndroidAutoQuit()
         if(!isStopped_)
         {
             this->waitForDevice();
+            this->startAutoConnect();
         }
     });
 }
@@ -171,6 +191,47 @@ void App::onUSBHubError(const aasdk::error::Error& error)
     }
 }
 
+void App::startAutoConnect()
+{
+    if(autoConnectAddresses_.empty() || androidAutoEntity_ != nullptr || isStopped_)
+    {
+        return;
+    }
+
+    auto promise = tcp::IAutoConnector::Promise::defer(strand_);
+    promise->then([this, self = this->shared_from_this()](aasdk::tcp::ITCPEndpoint::SocketPointer socket) {
+            this->start(std::move(socket));
+        },
+        std::bind(&App::onAutoConnectError, this->shared_from_this(), std::placeholders::_1));
+
+    autoConnector_->connect(autoConnectAddresses_, std::move(promise));
+}
+
+void App::cancelAutoConnect()
+{
+    autoConnectTimer_.cancel();
+    autoConnector_->cancel();
+}
+
+void App::onAutoConnectError(const aasdk::error::Error& error)
+{
+    if(error != aasdk::error::ErrorCode::OPERATION_ABORTED &&
+       error != aasdk::error::ErrorCode::OPERATION_IN_PROGRESS &&
+       androidAutoEntity_ == nullptr && !isStopped_)
+    {
+        autoConnectTimer_.expires_from_now(boost::posix_time::milliseconds(cAutoConnectRetryInterval));
+        autoConnectTimer_.async_wait(strand_.wrap(std::bind(&App::onAutoConnectTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+}
+
+void App::onAutoConnectTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted)
+    {
+        this->startAutoConnect();
+    }
+}
+
 }
 }
 }
@@ -16,6 +16,8 @@
 *  along with openauto. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
 #include <f1x/openauto/Common/Log.hpp>
 
@@ -39,15 +41,37 @@ const std::string Configuration::cVideoScreenDPIKey = "Video.ScreenDPI";
 const std::string Configuration::cVideoOMXLayerIndexKey = "Video.OMXLayerIndex";
 const std::string Configuration::cVideoMarginWidth = "Video.MarginWidth";
 const std::string Configuration::cVideoMarginHeight = "Video.MarginHeight";
+const std::string Configuration::cVideoAdaptiveConfigsKey = "Video.AdaptiveConfigs";
+const std::string Configuration::cVideoLatencyTargetKey = "Video.LatencyTarget";
+const std::string Configuration::cVideoDRMDeviceKey = "Video.DRMDevice";
+const std::string Configuration::cVideoSharedMemoryNameKey = "Video.SharedMemoryName";
+const std::string Configuration::cVideoDumpFileKey = "Video.DumpFile";
 
 const std::string Configuration::cAudioMusicAudioChannelEnabled = "Audio.MusicAudioChannelEnabled";
 const std::string Configuration::cAudioSpeechAudioChannelEnabled = "Audio.SpeechAudioChannelEnabled";
 const std::string Configuration::cAudioOutputBackendType = "Audio.OutputBackendType";
+const std::string Configuration::cAudioMixerEnabled = "Audio.MixerEnabled";
+const std::string Configuration::cAudioResamplerQuality = "Audio.ResamplerQuality";
+
+const std::string Configuration::cSensorsNmeaSourceKey = "Sensors.NmeaSource";
+const std::string Configuration::cSensorsAmbientLightSensorKey = "Sensors.AmbientLightSensor";
+const std::string Configuration::cSensorsCanInterfaceKey = "Sensors.CanInterface";
+
+const std::string Configuration::cTCPNoDelayKey = "TCP.NoDelay";
+const std::string Configuration::cTCPQuickAckKey = "TCP.QuickAck";
+const std::string Configuration::cTCPReceiveBufferSizeKey = "TCP.ReceiveBufferSize";
+const std::string Configuration::cTCPKeepAliveKey = "TCP.KeepAlive";
+const std::string Configuration::cTCPKeepAliveIdleKey = "TCP.KeepAliveIdle";
+const std::string Configuration::cTCPKeepAliveIntervalKey = "TCP.KeepAliveInterval";
+const std::string Configuration::cTCPKeepAliveCountKey = "TCP.KeepAliveCount";
+const std::string Configuration::cTCPBusyPollKey = "TCP.BusyPoll";
 
 const std::string Configuration::cBluetoothAdapterTypeKey = "Bluetooth.AdapterType";
 const std::string Configuration::cBluetoothRemoteAdapterAddressKey = "Bluetooth.RemoteAdapterAddress";
 
 const std::string Configuration::cInputEnableTouchscreenKey = "Input.EnableTouchscreen";
+const std::string Configuration::cInputTouchCoalescingWindowKey = "Input.TouchCoalescingWindow";
+const std::string Configuration::cInputEvdevDevicesKey = "Input.EvdevDevices";
 const std::string Configuration::cInputPlayButtonKey = "Input.PlayButton";
 const std::string Configuration::cInputPauseButtonKey = "Input.PauseButton";
 const std::string Configuration::cInputTogglePlayButtonKey = "Input.TogglePlayButton";
@@ -64,284 +88,679 @@ const std::string Configuration::cInputDownButtonKey = "Input.DownButton";
 const std::string Configuration::cInputScrollWheelButtonKey = "Input.ScrollWheelButton";
 const std::string Configuration::cInputBackButtonKey = "Input.BackButton";
 const std::string Configuration::cInputEnterButtonKey = "Input.EnterButton";
+const std::string Configuration::cKeyMapSection = "KeyMap";
+const std::string Configuration::cScanCodeMapSection = "ScanCodeMap";
 
 Configuration::Configuration()
+    : snapshot_(std::make_shared<ConfigurationSnapshot>())
+    , version_(0)
+    , notifiedSnapshot_(snapshot_)
 {
     this->load();
 }
 
 void Configuration::load()
 {
+    auto snapshot = std::make_shared<ConfigurationSnapshot>();
     boost::property_tree::ptree iniConfig;
 
     try
     {
         boost::property_tree::ini_parser::read_ini(cConfigFileName, iniConfig);
 
-        handednessOfTrafficType_ = static_cast<HandednessOfTrafficType>(iniConfig.get<uint32_t>(cGeneralHandednessOfTrafficTypeKey,
-                                                                                                static_cast<uint32_t>(HandednessOfTrafficType::LEFT_HAND_DRIVE)));
-        showClock_ = iniConfig.get<bool>(cGeneralShowClockKey, true);
-
-        videoFPS_ = static_cast<aasdk::proto::enums::VideoFPS::Enum>(iniConfig.get<uint32_t>(cVideoFPSKey,
-                                                                                             aasdk::proto::enums::VideoFPS::_60));
-
-        videoResolution_ = static_cast<aasdk::proto::enums::VideoResolution::Enum>(iniConfig.get<uint32_t>(cVideoResolutionKey,
-                                                                                                           aasdk::proto::enums::VideoResolution::_480p));
-        screenDPI_ = iniConfig.get<size_t>(cVideoScreenDPIKey, 140);
-
-        omxLayerIndex_ = iniConfig.get<int32_t>(cVideoOMXLayerIndexKey, 1);
-        videoMargins_ = QRect(0, 0, iniConfig.get<int32_t>(cVideoMarginWidth, 0), iniConfig.get<int32_t>(cVideoMarginHeight, 0));
-
-        enableTouchscreen_ = iniConfig.get<bool>(cInputEnableTouchscreenKey, true);
-        this->readButtonCodes(iniConfig);
-
-        bluetoothAdapterType_ = static_cast<BluetoothAdapterType>(iniConfig.get<uint32_t>(cBluetoothAdapterTypeKey,
-                                                                                          static_cast<uint32_t>(BluetoothAdapterType::NONE)));
-
-        bluetoothRemoteAdapterAddress_ = iniConfig.get<std::string>(cBluetoothRemoteAdapterAddressKey, "");
-
-        musicAudioChannelEnabled_ = iniConfig.get<bool>(cAudioMusicAudioChannelEnabled, true);
-        speechAudiochannelEnabled_ = iniConfig.get<bool>(cAudioSpeechAudioChannelEnabled, true);
-        audioOutputBackendType_ = static_cast<AudioOutputBackendType>(iniConfig.get<uint32_t>(cAudioOutputBackendType, static_cast<uint32_t>(AudioOutputBackendType::RTAUDIO)));
+        snapshot->handednessOfTrafficType = static_cast<HandednessOfTrafficType>(iniConfig.get<uint32_t>(cGeneralHandednessOfTrafficTypeKey,
+                                                                                                         static_cast<uint32_t>(HandednessOfTrafficType::LEFT_HAND_DRIVE)));
+        snapshot->showClock = iniConfig.get<bool>(cGeneralShowClockKey, true);
+
+        snapshot->videoFPS = static_cast<aasdk::proto::enums::VideoFPS::Enum>(iniConfig.get<uint32_t>(cVideoFPSKey,
+                                                                                                      aasdk::proto::enums::VideoFPS::_60));
+
+        snapshot->videoResolution = static_cast<aasdk::proto::enums::VideoResolution::Enum>(iniConfig.get<uint32_t>(cVideoResolutionKey,
+                                                                                                                    aasdk::proto::enums::VideoResolution::_480p));
+        snapshot->screenDPI = iniConfig.get<size_t>(cVideoScreenDPIKey, 140);
+
+        snapshot->omxLayerIndex = iniConfig.get<int32_t>(cVideoOMXLayerIndexKey, 1);
+        snapshot->videoMargins = QRect(0, 0, iniConfig.get<int32_t>(cVideoMarginWidth, 0), iniConfig.get<int32_t>(cVideoMarginHeight, 0));
+        snapshot->videoAdaptiveConfigs = iniConfig.get<bool>(cVideoAdaptiveConfigsKey, true);
+        snapshot->videoLatencyTarget = iniConfig.get<uint32_t>(cVideoLatencyTargetKey, 50);
+        snapshot->drmDevice = iniConfig.get<std::string>(cVideoDRMDeviceKey, "/dev/dri/card0");
+        snapshot->sharedMemoryName = iniConfig.get<std::string>(cVideoSharedMemoryNameKey, "/openauto-video");
+        snapshot->videoDumpFile = iniConfig.get<std::string>(cVideoDumpFileKey, "");
+
+        snapshot->enableTouchscreen = iniConfig.get<bool>(cInputEnableTouchscreenKey, true);
+        snapshot->touchCoalescingWindow = iniConfig.get_optional<uint32_t>(cInputTouchCoalescingWindowKey);
+
+        const auto evdevDevices = iniConfig.get<std::string>(cInputEvdevDevicesKey, "");
+        snapshot->evdevDevices.clear();
+        if(!evdevDevices.empty())
+        {
+            boost::split(snapshot->evdevDevices, evdevDevices, boost::is_any_of(","));
+        }
+        readButtonCodes(iniConfig, snapshot->buttonCodes);
+        snapshot->keyBindings = readKeyBindings(iniConfig, cKeyMapSection);
+        snapshot->scanCodeBindings = readKeyBindings(iniConfig, cScanCodeMapSection);
+
+        snapshot->bluetoothAdapterType = static_cast<BluetoothAdapterType>(iniConfig.get<uint32_t>(cBluetoothAdapterTypeKey,
+                                                                                                   static_cast<uint32_t>(BluetoothAdapterType::NONE)));
+
+        snapshot->bluetoothRemoteAdapterAddress = iniConfig.get<std::string>(cBluetoothRemoteAdapterAddressKey, "");
+
+        snapshot->musicAudioChannelEnabled = iniConfig.get<bool>(cAudioMusicAudioChannelEnabled, true);
+        snapshot->speechAudioChannelEnabled = iniConfig.get<bool>(cAudioSpeechAudioChannelEnabled, true);
+        snapshot->audioOutputBackendType = static_cast<AudioOutputBackendType>(iniConfig.get<uint32_t>(cAudioOutputBackendType, static_cast<uint32_t>(AudioOutputBackendType::RTAUDIO)));
+        snapshot->audioMixerEnabled = iniConfig.get<bool>(cAudioMixerEnabled, false);
+        snapshot->resamplerQuality = static_cast<ResamplerQuality>(iniConfig.get<uint32_t>(cAudioResamplerQuality, static_cast<uint32_t>(ResamplerQuality::MEDIUM)));
+
+        snapshot->nmeaSource = iniConfig.get<std::string>(cSensorsNmeaSourceKey, "");
+        snapshot->ambientLightSensor = iniConfig.get<std::string>(cSensorsAmbientLightSensorKey, "");
+        snapshot->canInterface = iniConfig.get<std::string>(cSensorsCanInterfaceKey, "");
+
+        snapshot->tcpTuningProfile.noDelay = iniConfig.get<bool>(cTCPNoDelayKey, true);
+        snapshot->tcpTuningProfile.quickAck = iniConfig.get<bool>(cTCPQuickAckKey, true);
+        snapshot->tcpTuningProfile.receiveBufferSize = iniConfig.get<uint32_t>(cTCPReceiveBufferSizeKey, 1048576);
+        snapshot->tcpTuningProfile.keepAlive = iniConfig.get<bool>(cTCPKeepAliveKey, true);
+        snapshot->tcpTuningProfile.keepAliveIdle = iniConfig.get<uint32_t>(cTCPKeepAliveIdleKey, 5);
+        snapshot->tcpTuningProfile.keepAliveInterval = iniConfig.get<uint32_t>(cTCPKeepAliveIntervalKey, 2);
+        snapshot->tcpTuningProfile.keepAliveCount = iniConfig.get<uint32_t>(cTCPKeepAliveCountKey, 3);
+        snapshot->tcpTuningProfile.busyPoll = iniConfig.get<uint32_t>(cTCPBusyPollKey, 0);
     }
-    catch(const boost::property_tree::ini_parser_error& e)
+    catch(const boost::property_tree::ptree_error& e)
     {
         OPENAUTO_LOG(warning) << "[Configuration] failed to read configuration file: " << cConfigFileName
                             << ", error: " << e.what()
-                            << ". Using default configuration.";
-        this->reset();
+                            << ". Keeping the current configuration.";
+
+        // a syntax error or a value of the wrong type alike, at startup the current configuration is the default one,
+        // on a reload a broken file must not wipe the settings
+        return;
     }
+
+    this->publish(std::move(snapshot));
 }
 
 void Configuration::reset()
 {
-    handednessOfTrafficType_ = HandednessOfTrafficType::LEFT_HAND_DRIVE;
-    showClock_ = true;
-    videoFPS_ = aasdk::proto::enums::VideoFPS::_60;
-    videoResolution_ = aasdk::proto::enums::VideoResolution::_480p;
-    screenDPI_ = 140;
-    omxLayerIndex_ = 1;
-    videoMargins_ = QRect(0, 0, 0, 0);
-    enableTouchscreen_ = true;
-    buttonCodes_.clear();
-    bluetoothAdapterType_ = BluetoothAdapterType::NONE;
-    bluetoothRemoteAdapterAddress_ = "";
-    musicAudioChannelEnabled_ = true;
-    speechAudiochannelEnabled_ = true;
-    audioOutputBackendType_ = AudioOutputBackendType::RTAUDIO;
+    this->publish(std::make_shared<ConfigurationSnapshot>());
 }
 
 void Configuration::save()
 {
     boost::property_tree::ptree iniConfig;
-    iniConfig.put<uint32_t>(cGeneralHandednessOfTrafficTypeKey, static_cast<uint32_t>(handednessOfTrafficType_));
-    iniConfig.put<bool>(cGeneralShowClockKey, showClock_);
+    writeSnapshot(*this->getSnapshot(), iniConfig);
+    boost::property_tree::ini_parser::write_ini(cConfigFileName, iniConfig);
+    this->notify();
+}
 
-    iniConfig.put<uint32_t>(cVideoFPSKey, static_cast<uint32_t>(videoFPS_));
-    iniConfig.put<uint32_t>(cVideoResolutionKey, static_cast<uint32_t>(videoResolution_));
-    iniConfig.put<size_t>(cVideoScreenDPIKey, screenDPI_);
-    iniConfig.put<int32_t>(cVideoOMXLayerIndexKey, omxLayerIndex_);
-    iniConfig.put<uint32_t>(cVideoMarginWidth, videoMargins_.width());
-    iniConfig.put<uint32_t>(cVideoMarginHeight, videoMargins_.height());
+void Configuration::writeSnapshot(const ConfigurationSnapshot& snapshot, boost::property_tree::ptree& iniConfig)
+{
+    iniConfig.put<uint32_t>(cGeneralHandednessOfTrafficTypeKey, static_cast<uint32_t>(snapshot.handednessOfTrafficType));
+    iniConfig.put<bool>(cGeneralShowClockKey, snapshot.showClock);
 
-    iniConfig.put<bool>(cInputEnableTouchscreenKey, enableTouchscreen_);
-    this->writeButtonCodes(iniConfig);
+    iniConfig.put<uint32_t>(cVideoFPSKey, static_cast<uint32_t>(snapshot.videoFPS));
+    iniConfig.put<uint32_t>(cVideoResolutionKey, static_cast<uint32_t>(snapshot.videoResolution));
+    iniConfig.put<size_t>(cVideoScreenDPIKey, snapshot.screenDPI);
+    iniConfig.put<int32_t>(cVideoOMXLayerIndexKey, snapshot.omxLayerIndex);
+    iniConfig.put<uint32_t>(cVideoMarginWidth, snapshot.videoMargins.width());
+    iniConfig.put<uint32_t>(cVideoMarginHeight, snapshot.videoMargins.height());
+    iniConfig.put<bool>(cVideoAdaptiveConfigsKey, snapshot.videoAdaptiveConfigs);
+    iniConfig.put<uint32_t>(cVideoLatencyTargetKey, snapshot.videoLatencyTarget);
+    iniConfig.put<std::string>(cVideoDRMDeviceKey, snapshot.drmDevice);
+    iniConfig.put<std::string>(cVideoSharedMemoryNameKey, snapshot.sharedMemoryName);
+    iniConfig.put<std::string>(cVideoDumpFileKey, snapshot.videoDumpFile);
 
-    iniConfig.put<uint32_t>(cBluetoothAdapterTypeKey, static_cast<uint32_t>(bluetoothAdapterType_));
-    iniConfig.put<std::string>(cBluetoothRemoteAdapterAddressKey, bluetoothRemoteAdapterAddress_);
+    iniConfig.put<bool>(cInputEnableTouchscreenKey, snapshot.enableTouchscreen);
 
-    iniConfig.put<bool>(cAudioMusicAudioChannelEnabled, musicAudioChannelEnabled_);
-    iniConfig.put<bool>(cAudioSpeechAudioChannelEnabled, speechAudiochannelEnabled_);
-    iniConfig.put<uint32_t>(cAudioOutputBackendType, static_cast<uint32_t>(audioOutputBackendType_));
-    boost::property_tree::ini_parser::write_ini(cConfigFileName, iniConfig);
+    if(snapshot.touchCoalescingWindow)
+    {
+        iniConfig.put<uint32_t>(cInputTouchCoalescingWindowKey, *snapshot.touchCoalescingWindow);
+    }
+
+    iniConfig.put<std::string>(cInputEvdevDevicesKey, boost::algorithm::join(snapshot.evdevDevices, ","));
+    writeButtonCodes(iniConfig, snapshot.buttonCodes);
+    writeKeyBindings(iniConfig, cKeyMapSection, snapshot.keyBindings);
+    writeKeyBindings(iniConfig, cScanCodeMapSection, snapshot.scanCodeBindings);
+
+    iniConfig.put<uint32_t>(cBluetoothAdapterTypeKey, static_cast<uint32_t>(snapshot.bluetoothAdapterType));
+    iniConfig.put<std::string>(cBluetoothRemoteAdapterAddressKey, snapshot.bluetoothRemoteAdapterAddress);
+
+    iniConfig.put<bool>(cAudioMusicAudioChannelEnabled, snapshot.musicAudioChannelEnabled);
+    iniConfig.put<bool>(cAudioSpeechAudioChannelEnabled, snapshot.speechAudioChannelEnabled);
+    iniConfig.put<uint32_t>(cAudioOutputBackendType, static_cast<uint32_t>(snapshot.audioOutputBackendType));
+    iniConfig.put<bool>(cAudioMixerEnabled, snapshot.audioMixerEnabled);
+    iniConfig.put<uint32_t>(cAudioResamplerQuality, static_cast<uint32_t>(snapshot.resamplerQuality));
+
+    iniConfig.put<std::string>(cSensorsNmeaSourceKey, snapshot.nmeaSource);
+    iniConfig.put<std::string>(cSensorsAmbientLightSensorKey, snapshot.ambientLightSensor);
+    iniConfig.put<std::string>(cSensorsCanInterfaceKey, snapshot.canInterface);
+
+    iniConfig.put<bool>(cTCPNoDelayKey, snapshot.tcpTuningProfile.noDelay);
+    iniConfig.put<bool>(cTCPQuickAckKey, snapshot.tcpTuningProfile.quickAck);
+    iniConfig.put<uint32_t>(cTCPReceiveBufferSizeKey, snapshot.tcpTuningProfile.receiveBufferSize);
+    iniConfig.put<bool>(cTCPKeepAliveKey, snapshot.tcpTuningProfile.keepAlive);
+    iniConfig.put<uint32_t>(cTCPKeepAliveIdleKey, snapshot.tcpTuningProfile.keepAliveIdle);
+    iniConfig.put<uint32_t>(cTCPKeepAliveIntervalKey, snapshot.tcpTuningProfile.keepAliveInterval);
+    iniConfig.put<uint32_t>(cTCPKeepAliveCountKey, snapshot.tcpTuningProfile.keepAliveCount);
+    iniConfig.put<uint32_t>(cTCPBusyPollKey, snapshot.tcpTuningProfile.busyPoll);
+}
+
+void Configuration::subscribe(const std::vector<std::string>& keys, IConfigurationObserver::Pointer observer)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                                        [](const Subscription& subscription) { return subscription.observer.expired(); }),
+                         subscriptions_.end());
+    subscriptions_.push_back(Subscription{keys, observer});
+}
+
+void Configuration::unsubscribe(IConfigurationObserver::Pointer observer)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                                        [&observer](const Subscription& subscription) {
+                                            const auto subscribedObserver = subscription.observer.lock();
+                                            return subscribedObserver == nullptr || subscribedObserver == observer;
+                                        }),
+                         subscriptions_.end());
+}
+
+ConfigurationSnapshot::Pointer Configuration::getSnapshot() const
+{
+    return std::atomic_load(&snapshot_);
+}
+
+uint64_t Configuration::getVersion() const
+{
+    return version_.load(std::memory_order_acquire);
 }
 
 void Configuration::setHandednessOfTrafficType(HandednessOfTrafficType value)
 {
-    handednessOfTrafficType_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.handednessOfTrafficType = value; });
 }
 
 HandednessOfTrafficType Configuration::getHandednessOfTrafficType() const
 {
-    return handednessOfTrafficType_;
+    return this->getSnapshot()->handednessOfTrafficType;
 }
 
 void Configuration::showClock(bool value)
 {
-    showClock_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.showClock = value; });
 }
 
 bool Configuration::showClock() const
 {
-    return showClock_;
+    return this->getSnapshot()->showClock;
 }
 
 aasdk::proto::enums::VideoFPS::Enum Configuration::getVideoFPS() const
 {
-    return videoFPS_;
+    return this->getSnapshot()->videoFPS;
 }
 
 void Configuration::setVideoFPS(aasdk::proto::enums::VideoFPS::Enum value)
 {
-    videoFPS_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoFPS = value; });
 }
 
 aasdk::proto::enums::VideoResolution::Enum Configuration::getVideoResolution() const
 {
-    return videoResolution_;
+    return this->getSnapshot()->videoResolution;
 }
 
 void Configuration::setVideoResolution(aasdk::proto::enums::VideoResolution::Enum value)
 {
-    videoResolution_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoResolution = value; });
 }
 
 size_t Configuration::getScreenDPI() const
 {
-    return screenDPI_;
+    return this->getSnapshot()->screenDPI;
 }
 
 void Configuration::setScreenDPI(size_t value)
 {
-    screenDPI_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.screenDPI = value; });
 }
 
 void Configuration::setOMXLayerIndex(int32_t value)
 {
-    omxLayerIndex_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.omxLayerIndex = value; });
 }
 
 int32_t Configuration::getOMXLayerIndex() const
 {
-    return omxLayerIndex_;
+    return this->getSnapshot()->omxLayerIndex;
 }
 
 void Configuration::setVideoMargins(QRect value)
 {
-    videoMargins_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoMargins = value; });
 }
 
 QRect Configuration::getVideoMargins() const
 {
-    return videoMargins_;
+    return this->getSnapshot()->videoMargins;
+}
+
+bool Configuration::getVideoAdaptiveConfigs() const
+{
+    return this->getSnapshot()->videoAdaptiveConfigs;
+}
+
+void Configuration::setVideoAdaptiveConfigs(bool value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoAdaptiveConfigs = value; });
+}
+
+uint32_t Configuration::getVideoLatencyTarget() const
+{
+    return this->getSnapshot()->videoLatencyTarget;
+}
+
+void Configuration::setVideoLatencyTarget(uint32_t value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoLatencyTarget = value; });
+}
+
+std::string Configuration::getDRMDevice() const
+{
+    return this->getSnapshot()->drmDevice;
+}
+
+void Configuration::setDRMDevice(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.drmDevice = value; });
+}
+
+std::string Configuration::getSharedMemoryName() const
+{
+    return this->getSnapshot()->sharedMemoryName;
+}
+
+void Configuration::setSharedMemoryName(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.sharedMemoryName = value; });
+}
+
+std::string Configuration::getVideoDumpFile() const
+{
+    return this->getSnapshot()->videoDumpFile;
+}
+
+void Configuration::setVideoDumpFile(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.videoDumpFile = value; });
 }
 
 bool Configuration::getTouchscreenEnabled() const
 {
-    return enableTouchscreen_;
+    return this->getSnapshot()->enableTouchscreen;
 }
 
 void Configuration::setTouchscreenEnabled(bool value)
 {
-    enableTouchscreen_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.enableTouchscreen = value; });
+}
+
+uint32_t Configuration::getTouchCoalescingWindow() const
+{
+    // by default drags and wheel ticks are coalesced to one message per video frame
+    const auto snapshot = this->getSnapshot();
+    return snapshot->touchCoalescingWindow.value_or(snapshot->videoFPS == aasdk::proto::enums::VideoFPS::_60 ? 16 : 33);
+}
+
+void Configuration::setTouchCoalescingWindow(uint32_t value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.touchCoalescingWindow = value; });
+}
+
+std::vector<std::string> Configuration::getEvdevDevices() const
+{
+    return this->getSnapshot()->evdevDevices;
+}
+
+void Configuration::setEvdevDevices(const std::vector<std::string>& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.evdevDevices = value; });
 }
 
 Configuration::ButtonCodes Configuration::getButtonCodes() const
 {
-    return buttonCodes_;
+    return this->getSnapshot()->buttonCodes;
 }
 
 void Configuration::setButtonCodes(const ButtonCodes& value)
 {
-    buttonCodes_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.buttonCodes = value; });
+}
+
+Configuration::KeyBindings Configuration::getKeyBindings() const
+{
+    return this->getSnapshot()->keyBindings;
+}
+
+void Configuration::setKeyBindings(const KeyBindings& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.keyBindings = value; });
+}
+
+Configuration::KeyBindings Configuration::getScanCodeBindings() const
+{
+    return this->getSnapshot()->scanCodeBindings;
+}
+
+void Configuration::setScanCodeBindings(const KeyBindings& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.scanCodeBindings = value; });
 }
 
 BluetoothAdapterType Configuration::getBluetoothAdapterType() const
 {
-    return bluetoothAdapterType_;
+    return this->getSnapshot()->bluetoothAdapterType;
 }
 
 void Configuration::setBluetoothAdapterType(BluetoothAdapterType value)
 {
-    bluetoothAdapterType_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.bluetoothAdapterType = value; });
 }
 
 std::string Configuration::getBluetoothRemoteAdapterAddress() const
 {
-    return bluetoothRemoteAdapterAddress_;
+    return this->getSnapshot()->bluetoothRemoteAdapterAddress;
 }
 
 void Configuration::setBluetoothRemoteAdapterAddress(const std::string& value)
 {
-    bluetoothRemoteAdapterAddress_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.bluetoothRemoteAdapterAddress = value; });
 }
 
 bool Configuration::musicAudioChannelEnabled() const
 {
-    return musicAudioChannelEnabled_;
+    return this->getSnapshot()->musicAudioChannelEnabled;
 }
 
 void Configuration::setMusicAudioChannelEnabled(bool value)
 {
-    musicAudioChannelEnabled_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.musicAudioChannelEnabled = value; });
 }
 
 bool Configuration::speechAudioChannelEnabled() const
 {
-    return speechAudiochannelEnabled_;
+    return this->getSnapshot()->speechAudioChannelEnabled;
 }
 
 void Configuration::setSpeechAudioChannelEnabled(bool value)
 {
-    speechAudiochannelEnabled_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.speechAudioChannelEnabled = value; });
 }
 
 AudioOutputBackendType Configuration::getAudioOutputBackendType() const
 {
-    return audioOutputBackendType_;
+    return this->getSnapshot()->audioOutputBackendType;
 }
 
 void Configuration::setAudioOutputBackendType(AudioOutputBackendType value)
 {
-    audioOutputBackendType_ = value;
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.audioOutputBackendType = value; });
 }
 
-void Configuration::readButtonCodes(boost::property_tree::ptree& iniConfig)
+bool Configuration::audioMixerEnabled() const
 {
-    this->insertButtonCode(iniConfig, cInputPlayButtonKey, aasdk::proto::enums::ButtonCode::PLAY);
-    this->insertButtonCode(iniConfig, cInputPauseButtonKey, aasdk::proto::enums::ButtonCode::PAUSE);
-    this->insertButtonCode(iniConfig, cInputTogglePlayButtonKey, aasdk::proto::enums::ButtonCode::TOGGLE_PLAY);
-    this->insertButtonCode(iniConfig, cInputNextTrackButtonKey, aasdk::proto::enums::ButtonCode::NEXT);
-    this->insertButtonCode(iniConfig, cInputPreviousTrackButtonKey, aasdk::proto::enums::ButtonCode::PREV);
-    this->insertButtonCode(iniConfig, cInputHomeButtonKey, aasdk::proto::enums::ButtonCode::HOME);
-    this->insertButtonCode(iniConfig, cInputPhoneButtonKey, aasdk::proto::enums::ButtonCode::PHONE);
-    this->insertButtonCode(iniConfig, cInputCallEndButtonKey, aasdk::proto::enums::ButtonCode::CALL_END);
-    this->insertButtonCode(iniConfig, cInputVoiceCommandButtonKey, aasdk::proto::enums::ButtonCode::MICROPHONE_1);
-    this->insertButtonCode(iniConfig, cInputLeftButtonKey, aasdk::proto::enums::ButtonCode::LEFT);
-    this->insertButtonCode(iniConfig, cInputRightButtonKey, aasdk::proto::enums::ButtonCode::RIGHT);
-    this->insertButtonCode(iniConfig, cInputUpButtonKey, aasdk::proto::enums::ButtonCode::UP);
-    this->insertButtonCode(iniConfig, cInputDownButtonKey, aasdk::proto::enums::ButtonCode::DOWN);
-    this->insertButtonCode(iniConfig, cInputScrollWheelButtonKey, aasdk::proto::enums::ButtonCode::SCROLL_WHEEL);
-    this->insertButtonCode(iniConfig, cInputBackButtonKey, aasdk::proto::enums::ButtonCode::BACK);
-    this->insertButtonCode(iniConfig, cInputEnterButtonKey, aasdk::proto::enums::ButtonCode::ENTER);
+    return this->getSnapshot()->audioMixerEnabled;
 }
 
-void Configuration::insertButtonCode(boost::property_tree::ptree& iniConfig, const std::string& buttonCodeKey, aasdk::proto::enums::ButtonCode::Enum buttonCode)
+void Configuration::setAudioMixerEnabled(bool value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.audioMixerEnabled = value; });
+}
+
+ResamplerQuality Configuration::getResamplerQuality() const
+{
+    return this->getSnapshot()->resamplerQuality;
+}
+
+void Configuration::setResamplerQuality(ResamplerQuality value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.resamplerQuality = value; });
+}
+
+std::string Configuration::getNmeaSource() const
+{
+    return this->getSnapshot()->nmeaSource;
+}
+
+void Configuration::setNmeaSource(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.nmeaSource = value; });
+}
+
+std::string Configuration::getAmbientLightSensor() const
+{
+    return this->getSnapshot()->ambientLightSensor;
+}
+
+void Configuration::setAmbientLightSensor(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.ambientLightSensor = value; });
+}
+
+std::string Configuration::getCanInterface() const
+{
+    return this->getSnapshot()->canInterface;
+}
+
+void Configuration::setCanInterface(const std::string& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.canInterface = value; });
+}
+
+TCPTuningProfile Configuration::getTCPTuningProfile() const
+{
+    return this->getSnapshot()->tcpTuningProfile;
+}
+
+void Configuration::setTCPTuningProfile(const TCPTuningProfile& value)
+{
+    this->update([&value](ConfigurationSnapshot& snapshot) { snapshot.tcpTuningProfile = value; });
+}
+
+void Configuration::readButtonCodes(boost::property_tree::ptree& iniConfig, ButtonCodes& buttonCodes)
+{
+    insertButtonCode(iniConfig, cInputPlayButtonKey, aasdk::proto::enums::ButtonCode::PLAY, buttonCodes);
+    insertButtonCode(iniConfig, cInputPauseButtonKey, aasdk::proto::enums::ButtonCode::PAUSE, buttonCodes);
+    insertButtonCode(iniConfig, cInputTogglePlayButtonKey, aasdk::proto::enums::ButtonCode::TOGGLE_PLAY, buttonCodes);
+    insertButtonCode(iniConfig, cInputNextTrackButtonKey, aasdk::proto::enums::ButtonCode::NEXT, buttonCodes);
+    insertButtonCode(iniConfig, cInputPreviousTrackButtonKey, aasdk::proto::enums::ButtonCode::PREV, buttonCodes);
+    insertButtonCode(iniConfig, cInputHomeButtonKey, aasdk::proto::enums::ButtonCode::HOME, buttonCodes);
+    insertButtonCode(iniConfig, cInputPhoneButtonKey, aasdk::proto::enums::ButtonCode::PHONE, buttonCodes);
+    insertButtonCode(iniConfig, cInputCallEndButtonKey, aasdk::proto::enums::ButtonCode::CALL_END, buttonCodes);
+    insertButtonCode(iniConfig, cInputVoiceCommandButtonKey, aasdk::proto::enums::ButtonCode::MICROPHONE_1, buttonCodes);
+    insertButtonCode(iniConfig, cInputLeftButtonKey, aasdk::proto::enums::ButtonCode::LEFT, buttonCodes);
+    insertButtonCode(iniConfig, cInputRightButtonKey, aasdk::proto::enums::ButtonCode::RIGHT, buttonCodes);
+    insertButtonCode(iniConfig, cInputUpButtonKey, aasdk::proto::enums::ButtonCode::UP, buttonCodes);
+    insertButtonCode(iniConfig, cInputDownButtonKey, aasdk::proto::enums::ButtonCode::DOWN, buttonCodes);
+    insertButtonCode(iniConfig, cInputScrollWheelButtonKey, aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, buttonCodes);
+    insertButtonCode(iniConfig, cInputBackButtonKey, aasdk::proto::enums::ButtonCode::BACK, buttonCodes);
+    insertButtonCode(iniConfig, cInputEnterButtonKey, aasdk::proto::enums::ButtonCode::ENTER, buttonCodes);
+}
+
+void Configuration::insertButtonCode(boost::property_tree::ptree& iniConfig, const std::string& buttonCodeKey, aasdk::proto::enums::ButtonCode::Enum buttonCode, ButtonCodes& buttonCodes)
 {
     if(iniConfig.get<bool>(buttonCodeKey, false))
     {
-        buttonCodes_.push_back(buttonCode);
+        buttonCodes.push_back(buttonCode);
+    }
+}
+
+void Configuration::writeButtonCodes(boost::property_tree::ptree& iniConfig, const ButtonCodes& buttonCodes)
+{
+    iniConfig.put<bool>(cInputPlayButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::PLAY) != buttonCodes.end());
+    iniConfig.put<bool>(cInputPauseButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::PAUSE) != buttonCodes.end());
+    iniConfig.put<bool>(cInputTogglePlayButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::TOGGLE_PLAY) != buttonCodes.end());
+    iniConfig.put<bool>(cInputNextTrackButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::NEXT) != buttonCodes.end());
+    iniConfig.put<bool>(cInputPreviousTrackButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::PREV) != buttonCodes.end());
+    iniConfig.put<bool>(cInputHomeButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::HOME) != buttonCodes.end());
+    iniConfig.put<bool>(cInputPhoneButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::PHONE) != buttonCodes.end());
+    iniConfig.put<bool>(cInputCallEndButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::CALL_END) != buttonCodes.end());
+    iniConfig.put<bool>(cInputVoiceCommandButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::MICROPHONE_1) != buttonCodes.end());
+    iniConfig.put<bool>(cInputLeftButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::LEFT) != buttonCodes.end());
+    iniConfig.put<bool>(cInputRightButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::RIGHT) != buttonCodes.end());
+    iniConfig.put<bool>(cInputUpButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::UP) != buttonCodes.end());
+    iniConfig.put<bool>(cInputDownButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::DOWN) != buttonCodes.end());
+    iniConfig.put<bool>(cInputScrollWheelButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::SCROLL_WHEEL) != buttonCodes.end());
+    iniConfig.put<bool>(cInputBackButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::BACK) != buttonCodes.end());
+    iniConfig.put<bool>(cInputEnterButtonKey, std::find(buttonCodes.begin(), buttonCodes.end(), aasdk::proto::enums::ButtonCode::ENTER) != buttonCodes.end());
+}
+
+Configuration::KeyBindings Configuration::readKeyBindings(boost::property_tree::ptree& iniConfig, const std::string& section)
+{
+    KeyBindings keyBindings;
+    const auto sectionTree = iniConfig.get_child_optional(section);
+
+    if(sectionTree)
+    {
+        // entries are iterated rather than looked up, a key name such as "." would otherwise be taken for a path
+        for(const auto& entry : *sectionTree)
+        {
+            keyBindings[entry.first] = entry.second.data();
+        }
+    }
+
+    return keyBindings;
+}
+
+void Configuration::writeKeyBindings(boost::property_tree::ptree& iniConfig, const std::string& section, const KeyBindings& keyBindings)
+{
+    if(keyBindings.empty())
+    {
+        return;
+    }
+
+    boost::property_tree::ptree sectionTree;
+    for(const auto& keyBinding : keyBindings)
+    {
+        sectionTree.push_back(std::make_pair(keyBinding.first, boost::property_tree::ptree(keyBinding.second)));
+    }
+
+    iniConfig.put_child(section, sectionTree);
+}
+
+void Configuration::update(const std::function<void(ConfigurationSnapshot&)>& modifier)
+{
+    // writers are serialized so concurrent setters do not lose each other's changes, readers never take the lock
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto snapshot = std::make_shared<ConfigurationSnapshot>(*snapshot_);
+    modifier(*snapshot);
+    snapshot->version = snapshot_->version + 1;
+    std::atomic_store(&snapshot_, ConfigurationSnapshot::Pointer(std::move(snapshot)));
+
+    // the version is published last, whoever sees it can already load a snapshot at least that new
+    version_.store(snapshot_->version, std::memory_order_release);
+}
+
+void Configuration::publish(std::shared_ptr<ConfigurationSnapshot> snapshot)
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        snapshot->version = snapshot_->version + 1;
+        std::atomic_store(&snapshot_, ConfigurationSnapshot::Pointer(std::move(snapshot)));
+        version_.store(snapshot_->version, std::memory_order_release);
     }
+
+    this->notify();
 }
 
-void Configuration::writeButtonCodes(boost::property_tree::ptree& iniConfig)
-{
-    iniConfig.put<bool>(cInputPlayButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::PLAY) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputPauseButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::PAUSE) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputTogglePlayButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::TOGGLE_PLAY) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputNextTrackButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::NEXT) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputPreviousTrackButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::PREV) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputHomeButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::HOME) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputPhoneButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::PHONE) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputCallEndButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::CALL_END) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputVoiceCommandButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::MICROPHONE_1) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputLeftButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::LEFT) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputRightButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::RIGHT) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputUpButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::UP) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputDownButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::DOWN) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputScrollWheelButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::SCROLL_WHEEL) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputBackButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::BACK) != buttonCodes_.end());
-    iniConfig.put<bool>(cInputEnterButtonKey, std::find(buttonCodes_.begin(), buttonCodes_.end(), aasdk::proto::enums::ButtonCode::ENTER) != buttonCodes_.end());
+void Configuration::notify()
+{
+    IConfigurationObserver::ChangedKeys changedKeys;
+    std::vector<Subscription> subscriptions;
+
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        const auto previousSnapshot = notifiedSnapshot_;
+        notifiedSnapshot_ = snapshot_;
+
+        if(previousSnapshot == notifiedSnapshot_)
+        {
+            return;
+        }
+
+        changedKeys = getChangedKeys(*previousSnapshot, *notifiedSnapshot_);
+        subscriptions = subscriptions_;
+    }
+
+    if(changedKeys.empty())
+    {
+        return;
+    }
+
+    OPENAUTO_LOG(info) << "[Configuration] changed: " << boost::algorithm::join(changedKeys, ", ");
+
+    // observers are called outside of the lock, they may read the configuration or (un)subscribe from the callback
+    for(const auto& subscription : subscriptions)
+    {
+        const auto observer = subscription.observer.lock();
+        if(observer == nullptr)
+        {
+            continue;
+        }
+
+        IConfigurationObserver::ChangedKeys observedKeys;
+        for(const auto& changedKey : changedKeys)
+        {
+            const bool observed = std::any_of(subscription.keys.begin(), subscription.keys.end(),
+                                              [&changedKey](const std::string& key) {
+                                                  return changedKey == key || boost::algorithm::starts_with(changedKey, key + ".");
+                                              });
+            if(observed)
+            {
+                observedKeys.insert(changedKey);
+            }
+        }
+
+        if(!observedKeys.empty())
+        {
+            observer->onConfigurationChanged(observedKeys);
+        }
+    }
+}
+
+IConfigurationObserver::ChangedKeys Configuration::getChangedKeys(const ConfigurationSnapshot& previous, const ConfigurationSnapshot& current)
+{
+    // both snapshots are rendered exactly as they would be saved, so a key is reported as changed only if its ini value differs
+    boost::property_tree::ptree previousConfig;
+    writeSnapshot(previous, previousConfig);
+    boost::property_tree::ptree currentConfig;
+    writeSnapshot(current, currentConfig);
+
+    IConfigurationObserver::ChangedKeys changedKeys;
+    collectChangedKeys(previousConfig, currentConfig, changedKeys);
+    collectChangedKeys(currentConfig, previousConfig, changedKeys);
+    return changedKeys;
+}
+
+void Configuration::collectChangedKeys(const boost::property_tree::ptree& tree, const boost::property_tree::ptree& otherTree, IConfigurationObserver::ChangedKeys& changedKeys)
+{
+    for(const auto& section : tree)
+    {
+        const auto otherSection = otherTree.find(section.first);
+
+        for(const auto& entry : section.second)
+        {
+            bool changed = otherSection == otherTree.not_found();
+            if(!changed)
+            {
+                const auto otherEntry = otherSection->second.find(entry.first);
+                changed = otherEntry == otherSection->second.not_found() || otherEntry->second.data() != entry.second.data();
+            }
+
+            if(changed)
+            {
+                changedKeys.insert(section.first + "." + entry.first);
+            }
+        }
+    }
 }
 
 }
@@ -0,0 +1,56 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/Configuration/ConfigurationView.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace configuration
+{
+
+ConfigurationView::ConfigurationView(IConfiguration::Pointer configuration)
+    : configuration_(std::move(configuration))
+    , snapshot_(configuration_->getSnapshot())
+{
+
+}
+
+bool ConfigurationView::refresh()
+{
+    if(configuration_->getVersion() == snapshot_->version)
+    {
+        return false;
+    }
+
+    snapshot_ = configuration_->getSnapshot();
+    return true;
+}
+
+const ConfigurationSnapshot& ConfigurationView::get() const
+{
+    return *snapshot_;
+}
+
+}
+}
+}
+}
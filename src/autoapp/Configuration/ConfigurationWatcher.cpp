@@ -0,0 +1,152 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <cstring>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationWatcher.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace configuration
+{
+
+constexpr uint32_t ConfigurationWatcher::cDebounceInterval;
+
+ConfigurationWatcher::ConfigurationWatcher(boost::asio::io_service& ioService, IConfiguration::Pointer configuration, const std::string& filePath)
+    : strand_(ioService)
+    , descriptor_(ioService)
+    , debounceTimer_(ioService)
+    , configuration_(std::move(configuration))
+    , running_(false)
+    , reloadsCount_(0)
+{
+    const auto separator = filePath.find_last_of('/');
+    directory_ = separator == std::string::npos ? "." : filePath.substr(0, separator + 1);
+    fileName_ = separator == std::string::npos ? filePath : filePath.substr(separator + 1);
+}
+
+void ConfigurationWatcher::start()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(fd < 0)
+        {
+            OPENAUTO_LOG(error) << "[ConfigurationWatcher] cannot create inotify instance, error: " << std::strerror(errno);
+            return;
+        }
+
+        if(inotify_add_watch(fd, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            OPENAUTO_LOG(error) << "[ConfigurationWatcher] cannot watch directory: " << directory_ << ", error: " << std::strerror(errno);
+            ::close(fd);
+            return;
+        }
+
+        OPENAUTO_LOG(info) << "[ConfigurationWatcher] start, file: " << fileName_ << ", directory: " << directory_;
+        descriptor_.assign(fd);
+        running_ = true;
+        this->read();
+    });
+}
+
+void ConfigurationWatcher::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[ConfigurationWatcher] stop, reloads: " << reloadsCount_;
+        running_ = false;
+        debounceTimer_.cancel();
+
+        boost::system::error_code ec;
+        descriptor_.close(ec);
+    });
+}
+
+void ConfigurationWatcher::read()
+{
+    descriptor_.async_read_some(boost::asio::buffer(events_),
+                                strand_.wrap(std::bind(&ConfigurationWatcher::onRead, this->shared_from_this(), std::placeholders::_1, std::placeholders::_2)));
+}
+
+void ConfigurationWatcher::onRead(const boost::system::error_code& error, size_t bytesTransferred)
+{
+    if(error || !running_)
+    {
+        if(error && error != boost::asio::error::operation_aborted && error != boost::asio::error::bad_descriptor)
+        {
+            OPENAUTO_LOG(error) << "[ConfigurationWatcher] read failed, what: " << error.message();
+        }
+
+        return;
+    }
+
+    bool changed = false;
+    size_t offset = 0;
+
+    while(offset + sizeof(inotify_event) <= bytesTransferred)
+    {
+        const auto* event = reinterpret_cast<const inotify_event*>(events_.data() + offset);
+
+        // an overflowed queue may have lost the event for our file
+        changed = changed || (event->mask & IN_Q_OVERFLOW) != 0 || (event->len > 0 && fileName_ == event->name);
+        offset += sizeof(inotify_event) + event->len;
+    }
+
+    if(changed)
+    {
+        debounceTimer_.expires_from_now(boost::posix_time::milliseconds(cDebounceInterval));
+        debounceTimer_.async_wait(strand_.wrap(std::bind(&ConfigurationWatcher::onDebounceTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+
+    this->read();
+}
+
+void ConfigurationWatcher::onDebounceTimerExpired(const boost::system::error_code& error)
+{
+    if(error == boost::asio::error::operation_aborted || !running_)
+    {
+        return;
+    }
+
+    // a file written by save() parses back to the same settings, so it is reloaded without any notification
+    ++reloadsCount_;
+    OPENAUTO_LOG(info) << "[ConfigurationWatcher] " << fileName_ << " changed, reloading.";
+
+    try
+    {
+        configuration_->load();
+    }
+    catch(const std::exception& e)
+    {
+        // the io_service thread must survive whatever an observer or the parser throws
+        OPENAUTO_LOG(error) << "[ConfigurationWatcher] reload failed, what: " << e.what();
+    }
+}
+
+}
+}
+}
+}
+
+#endif
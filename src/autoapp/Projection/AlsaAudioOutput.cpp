@@ -0,0 +1,349 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_ALSA
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/AlsaAudioOutput.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+const std::string AlsaAudioOutput::cDeviceName = "default";
+
+AlsaAudioOutput::AlsaAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference)
+    : channelCount_(channelCount)
+    , sampleSize_(sampleSize)
+    , sampleRate_(sampleRate)
+    , deviceSampleRate_(sampleRate)
+    , resamplerQuality_(resamplerQuality)
+    , pcm_(nullptr)
+    , periodSize_(0)
+    , samples_(sampleRate * channelCount)
+    , gain_(1.0f)
+    , currentGain_(1.0f)
+    , echoReference_(std::move(echoReference))
+    , echoReferenceSourceId_(echoReference_ != nullptr ? echoReference_->addSource() : 0)
+    , running_(false)
+{
+
+}
+
+AlsaAudioOutput::~AlsaAudioOutput()
+{
+    this->stop();
+}
+
+bool AlsaAudioOutput::open()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    if(pcm_ != nullptr)
+    {
+        return true;
+    }
+
+    const auto result = snd_pcm_open(&pcm_, cDeviceName.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+    if(result < 0)
+    {
+        OPENAUTO_LOG(error) << "[AlsaAudioOutput] Failed to open device " << cDeviceName << ", what: " << snd_strerror(result);
+        pcm_ = nullptr;
+        return false;
+    }
+
+    if(!this->configure())
+    {
+        snd_pcm_close(pcm_);
+        pcm_ = nullptr;
+        return false;
+    }
+
+    resampler_ = deviceSampleRate_ != sampleRate_ ? std::make_unique<Resampler>(sampleRate_, deviceSampleRate_, channelCount_, resamplerQuality_) : nullptr;
+    sourceReader_ = !source_.expired() ? std::make_unique<AudioSourceReader>(source_, deviceSampleRate_, resamplerQuality_) : nullptr;
+
+    std::lock_guard<decltype(samplesMutex_)> samplesLock(samplesMutex_);
+    samples_.set_capacity(deviceSampleRate_ * channelCount_);
+    return true;
+}
+
+bool AlsaAudioOutput::configure()
+{
+    snd_pcm_hw_params_t* hwParams;
+    snd_pcm_hw_params_alloca(&hwParams);
+    snd_pcm_hw_params_any(pcm_, hwParams);
+
+    unsigned int deviceSampleRate = sampleRate_;
+    unsigned int periodTime = cPeriodTime;
+    unsigned int periodCount = cPeriodCount;
+    int result = 0;
+
+    // mmap access lets the playback thread copy straight from our ring into the hardware buffer
+    if((result = snd_pcm_hw_params_set_access(pcm_, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0 ||
+       (result = snd_pcm_hw_params_set_format(pcm_, hwParams, SND_PCM_FORMAT_S16_LE)) < 0 ||
+       (result = snd_pcm_hw_params_set_channels(pcm_, hwParams, channelCount_)) < 0 ||
+       (result = snd_pcm_hw_params_set_rate_resample(pcm_, hwParams, 0)) < 0 ||
+       (result = snd_pcm_hw_params_set_rate_near(pcm_, hwParams, &deviceSampleRate, nullptr)) < 0 ||
+       (result = snd_pcm_hw_params_set_period_time_near(pcm_, hwParams, &periodTime, nullptr)) < 0 ||
+       (result = snd_pcm_hw_params_set_periods_near(pcm_, hwParams, &periodCount, nullptr)) < 0 ||
+       (result = snd_pcm_hw_params(pcm_, hwParams)) < 0)
+    {
+        OPENAUTO_LOG(error) << "[AlsaAudioOutput] Failed to set hardware parameters, what: " << snd_strerror(result);
+        return false;
+    }
+
+    snd_pcm_hw_params_get_period_size(hwParams, &periodSize_, nullptr);
+    deviceSampleRate_ = deviceSampleRate;
+
+    snd_pcm_sw_params_t* swParams;
+    snd_pcm_sw_params_alloca(&swParams);
+    snd_pcm_sw_params_current(pcm_, swParams);
+
+    if((result = snd_pcm_sw_params_set_avail_min(pcm_, swParams, periodSize_)) < 0 ||
+       (result = snd_pcm_sw_params_set_start_threshold(pcm_, swParams, periodSize_)) < 0 ||
+       (result = snd_pcm_sw_params(pcm_, swParams)) < 0)
+    {
+        OPENAUTO_LOG(error) << "[AlsaAudioOutput] Failed to set software parameters, what: " << snd_strerror(result);
+        return false;
+    }
+
+    OPENAUTO_LOG(info) << "[AlsaAudioOutput] Device " << cDeviceName << " opened, sample rate: " << deviceSampleRate_
+                       << ", period size: " << periodSize_
+                       << ", periods: " << periodCount;
+
+    return true;
+}
+
+void AlsaAudioOutput::write(aasdk::messenger::Timestamp::ValueType, const aasdk::common::DataConstBuffer& buffer)
+{
+    const int16_t* samples = reinterpret_cast<const int16_t*>(buffer.cdata);
+    size_t sampleCount = buffer.size / sizeof(int16_t);
+
+    if(resampler_ != nullptr)
+    {
+        resampled_.clear();
+        resampler_->process(samples, sampleCount / channelCount_, resampled_);
+        samples = resampled_.data();
+        sampleCount = resampled_.size();
+    }
+
+    std::lock_guard<decltype(samplesMutex_)> lock(samplesMutex_);
+    samples_.insert(samples_.end(), samples, samples + sampleCount);
+}
+
+void AlsaAudioOutput::start()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    if(pcm_ != nullptr && !running_)
+    {
+        snd_pcm_prepare(pcm_);
+        running_ = true;
+        thread_ = std::thread(&AlsaAudioOutput::playback, this);
+    }
+}
+
+void AlsaAudioOutput::stop()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    this->doSuspend();
+
+    if(pcm_ != nullptr)
+    {
+        snd_pcm_close(pcm_);
+        pcm_ = nullptr;
+    }
+
+    if(resampler_ != nullptr)
+    {
+        resampler_->reset();
+    }
+}
+
+void AlsaAudioOutput::suspend()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    this->doSuspend();
+}
+
+void AlsaAudioOutput::setGain(float gain)
+{
+    gain_ = gain;
+}
+
+uint32_t AlsaAudioOutput::getSampleSize() const
+{
+    return sampleSize_;
+}
+
+uint32_t AlsaAudioOutput::getChannelCount() const
+{
+    return channelCount_;
+}
+
+uint32_t AlsaAudioOutput::getSampleRate() const
+{
+    return sampleRate_;
+}
+
+void AlsaAudioOutput::setSource(IAudioSource::Pointer source)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    // with a source the playback thread pulls from it instead of the ring filled by write()
+    source_ = source;
+}
+
+void AlsaAudioOutput::doSuspend()
+{
+    if(running_)
+    {
+        running_ = false;
+        thread_.join();
+        snd_pcm_drop(pcm_);
+    }
+
+    std::lock_guard<decltype(samplesMutex_)> lock(samplesMutex_);
+    samples_.clear();
+}
+
+void AlsaAudioOutput::playback()
+{
+    while(running_)
+    {
+        auto avail = snd_pcm_avail_update(pcm_);
+
+        if(avail < 0)
+        {
+            OPENAUTO_LOG(warning) << "[AlsaAudioOutput] Recovering from " << snd_strerror(avail);
+            if(snd_pcm_recover(pcm_, avail, 1) < 0)
+            {
+                break;
+            }
+            continue;
+        }
+
+        if(static_cast<snd_pcm_uframes_t>(avail) < periodSize_)
+        {
+            if(snd_pcm_state(pcm_) == SND_PCM_STATE_PREPARED)
+            {
+                snd_pcm_start(pcm_);
+            }
+
+            snd_pcm_wait(pcm_, cWaitTimeout);
+            continue;
+        }
+
+        if(!this->transfer(avail))
+        {
+            break;
+        }
+    }
+}
+
+bool AlsaAudioOutput::transfer(snd_pcm_uframes_t frameCount)
+{
+    while(frameCount > 0)
+    {
+        const snd_pcm_channel_area_t* areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = frameCount;
+
+        auto result = snd_pcm_mmap_begin(pcm_, &areas, &offset, &frames);
+        if(result < 0)
+        {
+            return snd_pcm_recover(pcm_, result, 1) >= 0;
+        }
+
+        // interleaved layout, all channels share the first area
+        auto destination = reinterpret_cast<int16_t*>(static_cast<uint8_t*>(areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8);
+        this->fill(destination, frames);
+
+        if(echoReference_ != nullptr)
+        {
+            echoReference_->write(echoReferenceSourceId_, destination, frames, channelCount_, deviceSampleRate_);
+        }
+
+        const auto committed = snd_pcm_mmap_commit(pcm_, offset, frames);
+        if(committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames)
+        {
+            return snd_pcm_recover(pcm_, committed >= 0 ? -EPIPE : committed, 1) >= 0;
+        }
+
+        frameCount -= frames;
+    }
+
+    return true;
+}
+
+void AlsaAudioOutput::fill(int16_t* destination, snd_pcm_uframes_t frameCount)
+{
+    const size_t sampleCount = frameCount * channelCount_;
+
+    if(sourceReader_ != nullptr)
+    {
+        sourceReader_->read(destination, frameCount);
+    }
+    else
+    {
+        std::lock_guard<decltype(samplesMutex_)> lock(samplesMutex_);
+
+        const size_t available = std::min(sampleCount, samples_.size());
+        std::copy(samples_.begin(), samples_.begin() + available, destination);
+        std::fill(destination + available, destination + sampleCount, 0);
+        samples_.erase_begin(available);
+    }
+
+    const float targetGain = gain_;
+
+    if(currentGain_ == 1.0f && targetGain == 1.0f)
+    {
+        return;
+    }
+
+    const float maxChange = cGainRampPerFrame * frameCount;
+    const float gainStep = std::max(-maxChange, std::min(maxChange, targetGain - currentGain_)) / frameCount;
+
+    for(snd_pcm_uframes_t frame = 0; frame < frameCount; ++frame)
+    {
+        const float gain = currentGain_ + gainStep * frame;
+
+        for(uint32_t channel = 0; channel < channelCount_; ++channel)
+        {
+            auto& sample = destination[frame * channelCount_ + channel];
+            sample = static_cast<int16_t>(sample * gain);
+        }
+    }
+
+    currentGain_ += gainStep * frameCount;
+}
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,342 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <f1x/openauto/autoapp/Projection/AudioInputProcessor.hpp>
+#include <f1x/openauto/autoapp/Projection/DSPKernels.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr size_t AudioInputProcessor::cFilterLength;
+constexpr float AudioInputProcessor::cStepSize;
+constexpr float AudioInputProcessor::cDoubleTalkThreshold;
+constexpr size_t AudioInputProcessor::cDoubleTalkHangover;
+constexpr size_t AudioInputProcessor::cMaxDelay;
+constexpr size_t AudioInputProcessor::cDelayMargin;
+constexpr size_t AudioInputProcessor::cDelayTolerance;
+constexpr size_t AudioInputProcessor::cEstimatorDecimation;
+constexpr size_t AudioInputProcessor::cEstimatorWindow;
+constexpr size_t AudioInputProcessor::cEstimationInterval;
+constexpr float AudioInputProcessor::cEstimatorMinCorrelation;
+constexpr float AudioInputProcessor::cFarEndActivityEnergy;
+constexpr size_t AudioInputProcessor::cSuppressionFrameSize;
+constexpr float AudioInputProcessor::cMinSuppressionGain;
+
+AudioInputProcessor::AudioInputProcessor(EchoReference::Pointer echoReference, uint32_t sampleRate)
+    : echoReference_(std::move(echoReference))
+    , sampleRate_(sampleRate)
+    , echoCancellationEnabled_(false)
+    , noiseSuppressionEnabled_(false)
+    , farEndHistory_(cMaxDelay + cFilterLength - 1, 0.0f)
+    , filter_(cFilterLength, 0.0f)
+    , doubleTalkHangover_(0)
+    , estimatorNearEndAccumulator_(0.0f)
+    , estimatorFarEndAccumulator_(0.0f)
+    , estimatorPhase_(0)
+    , samplesSinceEstimation_(0)
+    , delay_(0)
+    , delayCandidate_(std::numeric_limits<size_t>::max())
+    , echoEnergy_(0.0)
+    , residualEnergy_(0.0)
+    , measuredSamplesCount_(0)
+    , noiseFloor_(0.0f)
+    , suppressionGain_(1.0f)
+{
+
+}
+
+void AudioInputProcessor::setEchoCancellationEnabled(bool value)
+{
+    echoCancellationEnabled_ = value && echoReference_ != nullptr && echoReference_->getSampleRate() == sampleRate_;
+}
+
+void AudioInputProcessor::setNoiseSuppressionEnabled(bool value)
+{
+    noiseSuppressionEnabled_ = value;
+}
+
+void AudioInputProcessor::process(aasdk::common::Data& data)
+{
+    if(!echoCancellationEnabled_ && !noiseSuppressionEnabled_)
+    {
+        return;
+    }
+
+    const size_t sampleCount = data.size() / sizeof(int16_t);
+    auto* samples = reinterpret_cast<int16_t*>(data.data());
+
+    nearEnd_.resize(sampleCount);
+    dsp::convertToFloat(samples, nearEnd_.data(), sampleCount);
+
+    if(echoCancellationEnabled_)
+    {
+        this->cancelEcho(sampleCount);
+    }
+
+    if(noiseSuppressionEnabled_)
+    {
+        this->suppressNoise(sampleCount);
+    }
+
+    dsp::convertToInt16(nearEnd_.data(), samples, sampleCount);
+}
+
+void AudioInputProcessor::reset()
+{
+    if(measuredSamplesCount_ > 0 && residualEnergy_ > 0.0)
+    {
+        // echo return loss enhancement, measured only where the far end was active and the near end was silent
+        OPENAUTO_LOG(info) << "[AudioInputProcessor] ERLE: " << 10.0 * std::log10(echoEnergy_ / residualEnergy_) << " dB"
+                           << " over " << measuredSamplesCount_ * 1000 / sampleRate_ << " ms of far-end only audio"
+                           << ", echo delay: " << delay_ * 1000 / sampleRate_ << " ms";
+    }
+
+    if(echoReference_ != nullptr)
+    {
+        echoReference_->reset();
+    }
+
+    farEndHistory_.assign(cMaxDelay + cFilterLength - 1, 0.0f);
+    std::fill(filter_.begin(), filter_.end(), 0.0f);
+    doubleTalkHangover_ = 0;
+    estimatorNearEnd_.clear();
+    estimatorFarEnd_.clear();
+    estimatorNearEndAccumulator_ = 0.0f;
+    estimatorFarEndAccumulator_ = 0.0f;
+    estimatorPhase_ = 0;
+    samplesSinceEstimation_ = 0;
+    delay_ = 0;
+    delayCandidate_ = std::numeric_limits<size_t>::max();
+    echoEnergy_ = 0.0;
+    residualEnergy_ = 0.0;
+    measuredSamplesCount_ = 0;
+    noiseFloor_ = 0.0f;
+    suppressionGain_ = 1.0f;
+}
+
+void AudioInputProcessor::cancelEcho(size_t sampleCount)
+{
+    // farEndHistory_ holds cMaxDelay + cFilterLength - 1 samples of the previous blocks followed by the current block,
+    // the normalised LMS window for near-end sample i ends delay_ samples before the far-end sample played at the same time
+    const size_t historyLength = cMaxDelay + cFilterLength - 1;
+    farEndHistory_.resize(historyLength + sampleCount);
+    echoReference_->read(farEndHistory_.data() + historyLength, sampleCount);
+
+    this->estimateDelay(sampleCount);
+
+    const float* windows = farEndHistory_.data() + cMaxDelay - delay_;
+
+    float farEndPeak = 0.0f;
+    for(size_t i = 0; i < cFilterLength - 1 + sampleCount; ++i)
+    {
+        farEndPeak = std::max(farEndPeak, std::abs(windows[i]));
+    }
+
+    float windowEnergy = dsp::dotProduct(windows, windows, cFilterLength);
+
+    for(size_t i = 0; i < sampleCount; ++i)
+    {
+        const float* window = windows + i;
+
+        if(i > 0)
+        {
+            windowEnergy += window[cFilterLength - 1] * window[cFilterLength - 1] - window[-1] * window[-1];
+            windowEnergy = std::max(0.0f, windowEnergy);
+        }
+
+        const float error = nearEnd_[i] - dsp::dotProduct(filter_.data(), window, cFilterLength);
+
+        if(std::abs(nearEnd_[i]) > cDoubleTalkThreshold * farEndPeak)
+        {
+            doubleTalkHangover_ = cDoubleTalkHangover;
+        }
+        else if(doubleTalkHangover_ > 0)
+        {
+            --doubleTalkHangover_;
+        }
+
+        if(doubleTalkHangover_ == 0 && windowEnergy > 1e-6f)
+        {
+            dsp::multiplyAccumulate(filter_.data(), window, cStepSize * error / (windowEnergy + 1e-3f), cFilterLength);
+        }
+
+        if(doubleTalkHangover_ == 0 && windowEnergy > cFarEndActivityEnergy * cFilterLength)
+        {
+            echoEnergy_ += nearEnd_[i] * nearEnd_[i];
+            residualEnergy_ += error * error;
+            ++measuredSamplesCount_;
+        }
+
+        nearEnd_[i] = error;
+    }
+
+    std::copy(farEndHistory_.end() - historyLength, farEndHistory_.end(), farEndHistory_.begin());
+    farEndHistory_.resize(historyLength);
+}
+
+void AudioInputProcessor::estimateDelay(size_t sampleCount)
+{
+    // the reference is tapped when the output device takes it, the device and capture buffering in between
+    // is unknown and usually longer than the filter, so the bulk delay is found by cross-correlating
+    // decimated near-end and far-end signals and the filter only models the room response after it
+    const size_t maxLag = cMaxDelay / cEstimatorDecimation;
+    const float* farEnd = farEndHistory_.data() + cMaxDelay + cFilterLength - 1;
+
+    for(size_t i = 0; i < sampleCount; ++i)
+    {
+        estimatorNearEndAccumulator_ += nearEnd_[i];
+        estimatorFarEndAccumulator_ += farEnd[i];
+
+        if(++estimatorPhase_ == cEstimatorDecimation)
+        {
+            estimatorNearEnd_.push_back(estimatorNearEndAccumulator_);
+            estimatorFarEnd_.push_back(estimatorFarEndAccumulator_);
+            estimatorNearEndAccumulator_ = 0.0f;
+            estimatorFarEndAccumulator_ = 0.0f;
+            estimatorPhase_ = 0;
+        }
+    }
+
+    if(estimatorNearEnd_.size() > cEstimatorWindow)
+    {
+        estimatorNearEnd_.erase(estimatorNearEnd_.begin(), estimatorNearEnd_.end() - cEstimatorWindow);
+    }
+
+    if(estimatorFarEnd_.size() > cEstimatorWindow + maxLag)
+    {
+        estimatorFarEnd_.erase(estimatorFarEnd_.begin(), estimatorFarEnd_.end() - (cEstimatorWindow + maxLag));
+    }
+
+    samplesSinceEstimation_ += sampleCount;
+    if(samplesSinceEstimation_ < cEstimationInterval || estimatorFarEnd_.size() < cEstimatorWindow + maxLag)
+    {
+        return;
+    }
+
+    samplesSinceEstimation_ = 0;
+
+    // estimatorFarEnd_[maxLag + k] was played at the time estimatorNearEnd_[k] was captured
+    const float minEnergy = cFarEndActivityEnergy * cEstimatorDecimation * cEstimatorDecimation * cEstimatorWindow;
+    const float nearEndEnergy = dsp::dotProduct(estimatorNearEnd_.data(), estimatorNearEnd_.data(), cEstimatorWindow);
+    float farEndEnergy = dsp::dotProduct(estimatorFarEnd_.data() + maxLag, estimatorFarEnd_.data() + maxLag, cEstimatorWindow);
+
+    if(nearEndEnergy < minEnergy)
+    {
+        return;
+    }
+
+    float bestCorrelation = 0.0f;
+    size_t bestLag = 0;
+
+    for(size_t lag = 0; lag <= maxLag; ++lag)
+    {
+        const float* farEndWindow = estimatorFarEnd_.data() + maxLag - lag;
+
+        if(lag > 0)
+        {
+            farEndEnergy += farEndWindow[0] * farEndWindow[0] - farEndWindow[cEstimatorWindow] * farEndWindow[cEstimatorWindow];
+            farEndEnergy = std::max(0.0f, farEndEnergy);
+        }
+
+        if(farEndEnergy < minEnergy)
+        {
+            continue;
+        }
+
+        const float correlation = std::abs(dsp::dotProduct(estimatorNearEnd_.data(), farEndWindow, cEstimatorWindow)) / std::sqrt(nearEndEnergy * farEndEnergy);
+
+        if(correlation > bestCorrelation)
+        {
+            bestCorrelation = correlation;
+            bestLag = lag;
+        }
+    }
+
+    if(bestCorrelation < cEstimatorMinCorrelation)
+    {
+        return;
+    }
+
+    // a delay is taken over only when two consecutive estimates agree, the margin keeps the direct path inside the filter
+    const auto distance = [](size_t a, size_t b) { return a > b ? a - b : b - a; };
+    const size_t candidate = bestLag * cEstimatorDecimation;
+
+    if(delayCandidate_ != std::numeric_limits<size_t>::max() && distance(candidate, delayCandidate_) <= cDelayTolerance)
+    {
+        const size_t delay = candidate > cDelayMargin ? candidate - cDelayMargin : 0;
+
+        if(distance(delay, delay_) > cDelayTolerance)
+        {
+            OPENAUTO_LOG(debug) << "[AudioInputProcessor] echo delay: " << delay * 1000 / sampleRate_ << " ms, correlation: " << bestCorrelation;
+            delay_ = delay;
+            std::fill(filter_.begin(), filter_.end(), 0.0f);
+
+            // the measurement restarts with the filter so that it reflects the aligned canceller
+            echoEnergy_ = 0.0;
+            residualEnergy_ = 0.0;
+            measuredSamplesCount_ = 0;
+        }
+    }
+
+    delayCandidate_ = candidate;
+}
+
+void AudioInputProcessor::suppressNoise(size_t sampleCount)
+{
+    // per-frame spectral subtraction in the energy domain with a minimum-tracking noise floor
+    for(size_t offset = 0; offset < sampleCount; offset += cSuppressionFrameSize)
+    {
+        const size_t frameSize = std::min(cSuppressionFrameSize, sampleCount - offset);
+        float* frame = nearEnd_.data() + offset;
+        const float energy = dsp::dotProduct(frame, frame, frameSize) / frameSize;
+
+        if(noiseFloor_ == 0.0f || energy < noiseFloor_)
+        {
+            noiseFloor_ = noiseFloor_ == 0.0f ? energy : 0.9f * noiseFloor_ + 0.1f * energy;
+        }
+        else
+        {
+            noiseFloor_ *= 1.002f;
+        }
+
+        const float targetGain = energy > 0.0f ? std::max(cMinSuppressionGain, 1.0f - 2.0f * noiseFloor_ / energy) : cMinSuppressionGain;
+        const float startGain = suppressionGain_;
+        suppressionGain_ = 0.7f * suppressionGain_ + 0.3f * targetGain;
+
+        const float gainStep = (suppressionGain_ - startGain) / frameSize;
+        for(size_t i = 0; i < frameSize; ++i)
+        {
+            frame[i] *= startGain + gainStep * i;
+        }
+    }
+}
+
+}
+}
+}
+}
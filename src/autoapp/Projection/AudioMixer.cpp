@@ -0,0 +1,258 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/AudioMixer.hpp>
+#include <f1x/openauto/autoapp/Projection/DSPKernels.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr size_t AudioMixer::cDuckingHoldFrames;
+
+AudioMixer::Channel::Channel(AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, uint32_t mixerSampleRate, float gain, configuration::ResamplerQuality resamplerQuality)
+    : type(type)
+    , channelCount(channelCount)
+    , resampler(sampleRate != mixerSampleRate ? std::make_unique<Resampler>(sampleRate, mixerSampleRate, channelCount, resamplerQuality) : nullptr)
+    , samples(mixerSampleRate * channelCount)
+    , gain(gain)
+    , currentGain(gain)
+    , active(false)
+    , pushedCount(0)
+    , poppedCount(0)
+    , discardedCount(0)
+{
+
+}
+
+AudioMixer::AudioMixer(uint32_t sampleRate, float duckingGain, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference)
+    : sampleRate_(sampleRate)
+    , duckingGain_(duckingGain)
+    , resamplerQuality_(resamplerQuality)
+    , duckingHoldFrames_(0)
+    , echoReference_(std::move(echoReference))
+    , echoReferenceSourceId_(echoReference_ != nullptr ? echoReference_->addSource() : 0)
+    , opened_(false)
+    , running_(false)
+{
+
+}
+
+AudioMixer::~AudioMixer()
+{
+    if(output_ != nullptr)
+    {
+        output_->stop();
+    }
+}
+
+void AudioMixer::setOutput(IAudioOutput::Pointer output)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    output_ = std::move(output);
+}
+
+AudioMixer::ChannelId AudioMixer::addChannel(AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, float gain)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    // channels are added while the services are created, before the output is opened and starts pulling
+    channels_.emplace_back(std::make_unique<Channel>(type, channelCount, sampleRate, sampleRate_, gain, resamplerQuality_));
+    return channels_.size() - 1;
+}
+
+bool AudioMixer::open()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    if(!opened_)
+    {
+        opened_ = output_ != nullptr && output_->open();
+
+        if(!opened_)
+        {
+            OPENAUTO_LOG(error) << "[AudioMixer] Failed to open audio output.";
+        }
+    }
+
+    return opened_;
+}
+
+void AudioMixer::write(ChannelId channelId, const int16_t* samples, size_t frameCount)
+{
+    // each channel is written by a single service, so resampling runs on its thread without any lock
+    auto& channel = *channels_.at(channelId);
+    channel.resampled.clear();
+
+    if(channel.resampler != nullptr)
+    {
+        channel.resampler->process(samples, frameCount, channel.resampled);
+    }
+    else
+    {
+        channel.resampled.resize(frameCount * channel.channelCount);
+        dsp::convertToFloat(samples, channel.resampled.data(), channel.resampled.size());
+    }
+
+    // whole frames only, whatever does not fit into a full ring is dropped
+    const size_t writable = channel.samples.write_available() / channel.channelCount * channel.channelCount;
+    channel.pushedCount += channel.samples.push(channel.resampled.data(), std::min(writable, channel.resampled.size()));
+}
+
+void AudioMixer::start(ChannelId channelId)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    channels_.at(channelId)->active = true;
+    this->updateOutputState();
+}
+
+void AudioMixer::suspend(ChannelId channelId)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    channels_.at(channelId)->active = false;
+    this->updateOutputState();
+}
+
+void AudioMixer::stop(ChannelId channelId)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    auto& channel = *channels_.at(channelId);
+    channel.active = false;
+
+    // the ring can only be emptied by its reader, it skips everything written up to this point
+    channel.discardedCount = channel.pushedCount;
+
+    if(channel.resampler != nullptr)
+    {
+        channel.resampler->reset();
+    }
+
+    this->updateOutputState();
+}
+
+void AudioMixer::setGain(ChannelId channelId, float gain)
+{
+    channels_.at(channelId)->gain = gain;
+}
+
+uint32_t AudioMixer::getSampleRate() const
+{
+    return sampleRate_;
+}
+
+uint32_t AudioMixer::getChannelCount() const
+{
+    return cChannelCount;
+}
+
+void AudioMixer::updateOutputState()
+{
+    const bool active = std::any_of(channels_.begin(), channels_.end(), [](const auto& channel) { return channel->active.load(); });
+
+    if(active && opened_ && !running_)
+    {
+        output_->start();
+        running_ = true;
+    }
+    else if(!active && running_)
+    {
+        output_->suspend();
+        running_ = false;
+    }
+}
+
+void AudioMixer::read(int16_t* samples, size_t frameCount)
+{
+    mixBuffer_.assign(frameCount * cChannelCount, 0.0f);
+
+    for(auto& channel : channels_)
+    {
+        this->discardChannel(*channel);
+    }
+
+    const bool duckingSourceActive = std::any_of(channels_.begin(), channels_.end(), [](const auto& channel) {
+        return channel->type != AudioMixerChannelType::MEDIA && channel->active && channel->samples.read_available() > 0;
+    });
+
+    // hold the ducking for a while so that gaps between speech packets do not pump the media volume
+    duckingHoldFrames_ = duckingSourceActive ? cDuckingHoldFrames : duckingHoldFrames_ - std::min(duckingHoldFrames_, frameCount);
+    const bool duck = duckingHoldFrames_ > 0;
+
+    for(auto& channel : channels_)
+    {
+        const float gain = channel->gain;
+        const float targetGain = duck && channel->type == AudioMixerChannelType::MEDIA ? gain * duckingGain_ : gain;
+        this->mixChannel(*channel, targetGain, frameCount);
+    }
+
+    dsp::convertToInt16(mixBuffer_.data(), samples, mixBuffer_.size());
+
+    if(echoReference_ != nullptr)
+    {
+        echoReference_->write(echoReferenceSourceId_, samples, frameCount, cChannelCount, sampleRate_);
+    }
+}
+
+void AudioMixer::discardChannel(Channel& channel)
+{
+    const uint64_t discardedCount = channel.discardedCount;
+
+    if(channel.poppedCount < discardedCount)
+    {
+        channel.mixed.resize(std::min<uint64_t>(discardedCount - channel.poppedCount, channel.samples.read_available()));
+        channel.poppedCount += channel.samples.pop(channel.mixed.data(), channel.mixed.size());
+    }
+}
+
+void AudioMixer::mixChannel(Channel& channel, float targetGain, size_t frameCount)
+{
+    const size_t availableFrames = std::min(frameCount, channel.samples.read_available() / channel.channelCount);
+    const float rampStep = std::max(-cGainRampPerFrame * availableFrames, std::min(cGainRampPerFrame * availableFrames, targetGain - channel.currentGain)) / std::max<size_t>(1, availableFrames);
+
+    channel.mixed.resize(availableFrames * channel.channelCount);
+    channel.poppedCount += channel.samples.pop(channel.mixed.data(), channel.mixed.size());
+
+    for(size_t frame = 0; frame < availableFrames; ++frame)
+    {
+        const float gain = channel.currentGain + rampStep * frame;
+
+        for(uint32_t i = 0; i < cChannelCount; ++i)
+        {
+            // mono sources are duplicated to both output channels
+            mixBuffer_[frame * cChannelCount + i] += channel.mixed[frame * channel.channelCount + std::min(i, channel.channelCount - 1)] * gain;
+        }
+    }
+
+    channel.currentGain += rampStep * availableFrames;
+}
+
+}
+}
+}
+}
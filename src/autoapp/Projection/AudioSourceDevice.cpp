@@ -0,0 +1,63 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/Projection/AudioSourceDevice.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+AudioSourceDevice::AudioSourceDevice(AudioSourceReader::Pointer sourceReader, uint32_t channelCount)
+    : sourceReader_(std::move(sourceReader))
+    , frameSize_(sizeof(int16_t) * channelCount)
+{
+
+}
+
+bool AudioSourceDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 AudioSourceDevice::bytesAvailable() const
+{
+    // the source never runs dry, it pads with silence
+    return QIODevice::bytesAvailable() + frameSize_;
+}
+
+qint64 AudioSourceDevice::readData(char *data, qint64 maxlen)
+{
+    const auto frameCount = static_cast<size_t>(maxlen) / frameSize_;
+    sourceReader_->read(reinterpret_cast<int16_t*>(data), frameCount);
+    return frameCount * frameSize_;
+}
+
+qint64 AudioSourceDevice::writeData(const char*, qint64)
+{
+    return -1;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,88 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/AudioSourceReader.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr size_t AudioSourceReader::cChunkFrames;
+
+AudioSourceReader::AudioSourceReader(std::weak_ptr<IAudioSource> source, uint32_t deviceSampleRate, configuration::ResamplerQuality resamplerQuality)
+    : source_(std::move(source))
+    , channelCount_(0)
+    , resampledOffset_(0)
+{
+    auto lockedSource = source_.lock();
+
+    if(lockedSource != nullptr)
+    {
+        channelCount_ = lockedSource->getChannelCount();
+
+        if(lockedSource->getSampleRate() != deviceSampleRate)
+        {
+            resampler_ = std::make_unique<Resampler>(lockedSource->getSampleRate(), deviceSampleRate, channelCount_, resamplerQuality);
+            chunk_.resize(cChunkFrames * channelCount_);
+        }
+    }
+}
+
+void AudioSourceReader::read(int16_t* samples, size_t frameCount)
+{
+    auto source = source_.lock();
+    const size_t sampleCount = frameCount * channelCount_;
+
+    if(source == nullptr)
+    {
+        std::fill(samples, samples + sampleCount, 0);
+    }
+    else if(resampler_ == nullptr)
+    {
+        source->read(samples, frameCount);
+    }
+    else
+    {
+        // the source runs on its own rate, so it is pulled in fixed chunks until the resampled backlog covers the request
+        while(resampled_.size() - resampledOffset_ < sampleCount)
+        {
+            source->read(chunk_.data(), cChunkFrames);
+            resampler_->process(chunk_.data(), cChunkFrames, resampled_);
+        }
+
+        std::copy(resampled_.begin() + resampledOffset_, resampled_.begin() + resampledOffset_ + sampleCount, samples);
+        resampledOffset_ += sampleCount;
+
+        if(resampledOffset_ >= resampled_.size() / 2)
+        {
+            resampled_.erase(resampled_.begin(), resampled_.begin() + resampledOffset_);
+            resampledOffset_ = 0;
+        }
+    }
+}
+
+}
+}
+}
+}
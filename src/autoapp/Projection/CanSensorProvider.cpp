@@ -0,0 +1,215 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <linux/can/raw.h>
+#include <f1x/openauto/autoapp/Projection/CanSensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProviderEventHandler.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr uint32_t CanSensorProvider::cRequestInterval;
+constexpr uint32_t CanSensorProvider::cReopenInterval;
+
+CanSensorProvider::CanSensorProvider(boost::asio::io_service& ioService, std::string interfaceName)
+    : strand_(ioService)
+    , descriptor_(ioService)
+    , requestTimer_(ioService)
+    , interfaceName_(std::move(interfaceName))
+    , eventHandler_(nullptr)
+{
+    // single frame ISO-TP request: length, service, pid, padding
+    std::memset(&request_, 0, sizeof(request_));
+    request_.can_id = cBroadcastRequestId;
+    request_.can_dlc = 8;
+    request_.data[0] = 0x02;
+    request_.data[1] = cShowCurrentData;
+    request_.data[2] = cVehicleSpeedPid;
+    std::memset(request_.data + 3, 0x55, 5);
+}
+
+void CanSensorProvider::start(ISensorProviderEventHandler& eventHandler)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), eventHandler = &eventHandler]() {
+        OPENAUTO_LOG(info) << "[CanSensorProvider] start, interface: " << interfaceName_;
+        eventHandler_ = eventHandler;
+
+        if(this->open())
+        {
+            this->read();
+            this->sendRequest();
+        }
+        else
+        {
+            requestTimer_.expires_from_now(boost::posix_time::milliseconds(cReopenInterval));
+            requestTimer_.async_wait(strand_.wrap(std::bind(&CanSensorProvider::onRequestTimer, this->shared_from_this(), std::placeholders::_1)));
+        }
+    });
+}
+
+void CanSensorProvider::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[CanSensorProvider] stop.";
+        eventHandler_ = nullptr;
+        requestTimer_.cancel();
+        this->close();
+    });
+}
+
+bool CanSensorProvider::isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const
+{
+    return sensorType == aasdk::proto::enums::SensorType::CAR_SPEED;
+}
+
+void CanSensorProvider::updateLocation(const LocationData&)
+{
+
+}
+
+bool CanSensorProvider::open()
+{
+    const int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if(fd < 0)
+    {
+        OPENAUTO_LOG(error) << "[CanSensorProvider] cannot create socket, error: " << std::strerror(errno);
+        return false;
+    }
+
+    ifreq interfaceRequest;
+    std::memset(&interfaceRequest, 0, sizeof(interfaceRequest));
+    std::strncpy(interfaceRequest.ifr_name, interfaceName_.c_str(), IFNAMSIZ - 1);
+
+    // only ECU responses reach user space, the bus may carry thousands of unrelated frames per second
+    can_filter filter;
+    filter.can_id = cResponseId;
+    filter.can_mask = cResponseMask | CAN_EFF_FLAG | CAN_RTR_FLAG;
+
+    sockaddr_can address;
+    std::memset(&address, 0, sizeof(address));
+    address.can_family = AF_CAN;
+
+    const bool opened = ioctl(fd, SIOCGIFINDEX, &interfaceRequest) >= 0
+                        && setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) >= 0;
+
+    address.can_ifindex = interfaceRequest.ifr_ifindex;
+
+    if(!opened || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        OPENAUTO_LOG(error) << "[CanSensorProvider] cannot open interface: " << interfaceName_ << ", error: " << std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    descriptor_.assign(fd);
+    return true;
+}
+
+void CanSensorProvider::read()
+{
+    descriptor_.async_read_some(boost::asio::buffer(&response_, sizeof(response_)),
+                                strand_.wrap(std::bind(&CanSensorProvider::onRead, this->shared_from_this(), std::placeholders::_1, std::placeholders::_2)));
+}
+
+void CanSensorProvider::onRead(const boost::system::error_code& error, size_t bytesTransferred)
+{
+    if(eventHandler_ == nullptr || error == boost::asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    if(error)
+    {
+        OPENAUTO_LOG(error) << "[CanSensorProvider] read failed, interface: " << interfaceName_ << ", error: " << error.message();
+        this->close();
+        return;
+    }
+
+    // positive response: length, service + 0x40, pid, speed in km/h
+    if(bytesTransferred == sizeof(response_) && response_.can_dlc >= 4
+       && response_.data[1] == (cShowCurrentData | 0x40) && response_.data[2] == cVehicleSpeedPid)
+    {
+        eventHandler_->onSpeedUpdate(static_cast<int32_t>(response_.data[3]) * 2500 / 9);
+    }
+
+    this->read();
+}
+
+void CanSensorProvider::sendRequest()
+{
+    boost::system::error_code ec;
+    descriptor_.write_some(boost::asio::buffer(&request_, sizeof(request_)), ec);
+
+    // a full transmit queue only delays the next sample
+    if(ec && ec != boost::asio::error::would_block && ec != boost::asio::error::no_buffer_space)
+    {
+        OPENAUTO_LOG(error) << "[CanSensorProvider] request failed, interface: " << interfaceName_ << ", error: " << ec.message();
+    }
+
+    requestTimer_.expires_from_now(boost::posix_time::milliseconds(cRequestInterval));
+    requestTimer_.async_wait(strand_.wrap(std::bind(&CanSensorProvider::onRequestTimer, this->shared_from_this(), std::placeholders::_1)));
+}
+
+void CanSensorProvider::onRequestTimer(const boost::system::error_code& error)
+{
+    if(error == boost::asio::error::operation_aborted || eventHandler_ == nullptr)
+    {
+        return;
+    }
+
+    if(!descriptor_.is_open())
+    {
+        if(!this->open())
+        {
+            requestTimer_.expires_from_now(boost::posix_time::milliseconds(cReopenInterval));
+            requestTimer_.async_wait(strand_.wrap(std::bind(&CanSensorProvider::onRequestTimer, this->shared_from_this(), std::placeholders::_1)));
+            return;
+        }
+
+        this->read();
+    }
+
+    this->sendRequest();
+}
+
+void CanSensorProvider::close()
+{
+    boost::system::error_code ec;
+    descriptor_.close(ec);
+}
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,450 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_DRM
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <xf86drm.h>
+#include <drm_fourcc.h>
+#include <cerrno>
+#include <cstring>
+#include <f1x/openauto/autoapp/Projection/DRMVideoOutput.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr int DRMVideoOutput::cNoBuffer;
+constexpr size_t DRMVideoOutput::cFrameBuffersCount;
+
+DRMVideoOutput::DRMVideoOutput(configuration::IConfiguration::Pointer configuration)
+    : VideoOutput(std::move(configuration))
+    , isActive_(false)
+    , fd_(-1)
+    , connectorId_(0)
+    , crtcId_(0)
+    , savedCrtc_(nullptr)
+    , frontBuffer_(cNoBuffer)
+    , pendingBuffer_(cNoBuffer)
+    , readyBuffer_(cNoBuffer)
+    , modeSet_(false)
+    , decodeErrorsCount_(0)
+    , flipsCount_(0)
+    , replacedFramesCount_(0)
+{
+    memset(&mode_, 0, sizeof(mode_));
+    memset(frameBuffers_.data(), 0, sizeof(frameBuffers_));
+}
+
+bool DRMVideoOutput::open()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    const auto device = configuration_->getDRMDevice();
+    OPENAUTO_LOG(info) << "[DRMVideoOutput] open, device: " << device;
+
+    fd_ = ::open(device.c_str(), O_RDWR | O_CLOEXEC);
+    if(fd_ < 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] cannot open " << device << ": " << strerror(errno);
+        return false;
+    }
+
+    uint64_t hasDumbBuffers = 0;
+    if(drmGetCap(fd_, DRM_CAP_DUMB_BUFFER, &hasDumbBuffers) != 0 || hasDumbBuffers == 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] device does not support dumb buffers.";
+        this->release();
+        return false;
+    }
+
+    if(drmSetMaster(fd_) != 0)
+    {
+        OPENAUTO_LOG(warning) << "[DRMVideoOutput] cannot become DRM master, mode setting may fail: " << strerror(errno);
+    }
+
+    if(!this->findDisplay())
+    {
+        this->release();
+        return false;
+    }
+
+    for(auto& frameBuffer : frameBuffers_)
+    {
+        if(!this->createFrameBuffer(frameBuffer))
+        {
+            this->release();
+            return false;
+        }
+    }
+
+    if(!decoder_.open())
+    {
+        this->release();
+        return false;
+    }
+
+    isActive_ = true;
+    eventThread_ = std::thread(&DRMVideoOutput::pollEvents, this);
+    return true;
+}
+
+bool DRMVideoOutput::init()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    OPENAUTO_LOG(info) << "[DRMVideoOutput] init, state: " << isActive_ << ", mode: " << mode_.hdisplay << "x" << mode_.vdisplay << "@" << mode_.vrefresh;
+    return isActive_;
+}
+
+void DRMVideoOutput::write(uint64_t, const aasdk::common::DataConstBuffer& buffer)
+{
+    if(!isActive_)
+    {
+        return;
+    }
+
+    if(!decoder_.decode(buffer, std::bind(&DRMVideoOutput::drawFrame, this, std::placeholders::_1)))
+    {
+        ++decodeErrorsCount_;
+    }
+}
+
+void DRMVideoOutput::stop()
+{
+    OPENAUTO_LOG(info) << "[DRMVideoOutput] stop, flips: " << flipsCount_ << ", replaced frames: " << replacedFramesCount_;
+
+    isActive_ = false;
+
+    if(eventThread_.joinable())
+    {
+        eventThread_.join();
+    }
+
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    this->release();
+}
+
+uint64_t DRMVideoOutput::getDecodeErrorsCount() const
+{
+    return decodeErrorsCount_;
+}
+
+bool DRMVideoOutput::findDisplay()
+{
+    drmModeRes* resources = drmModeGetResources(fd_);
+    if(resources == nullptr)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] cannot get mode resources: " << strerror(errno);
+        return false;
+    }
+
+    for(int i = 0; i < resources->count_connectors && crtcId_ == 0; ++i)
+    {
+        drmModeConnector* connector = drmModeGetConnector(fd_, resources->connectors[i]);
+        if(connector == nullptr)
+        {
+            continue;
+        }
+
+        if(connector->connection == DRM_MODE_CONNECTED && connector->count_modes > 0)
+        {
+            mode_ = connector->modes[0];
+            for(int j = 0; j < connector->count_modes; ++j)
+            {
+                if(connector->modes[j].type & DRM_MODE_TYPE_PREFERRED)
+                {
+                    mode_ = connector->modes[j];
+                    break;
+                }
+            }
+
+            // keep the CRTC already driving the connector, otherwise take the first one it can use
+            drmModeEncoder* encoder = connector->encoder_id != 0 ? drmModeGetEncoder(fd_, connector->encoder_id) : nullptr;
+            if(encoder != nullptr && encoder->crtc_id != 0)
+            {
+                crtcId_ = encoder->crtc_id;
+            }
+            drmModeFreeEncoder(encoder);
+
+            for(int j = 0; j < connector->count_encoders && crtcId_ == 0; ++j)
+            {
+                encoder = drmModeGetEncoder(fd_, connector->encoders[j]);
+                if(encoder == nullptr)
+                {
+                    continue;
+                }
+
+                for(int k = 0; k < resources->count_crtcs; ++k)
+                {
+                    if(encoder->possible_crtcs & (1 << k))
+                    {
+                        crtcId_ = resources->crtcs[k];
+                        break;
+                    }
+                }
+                drmModeFreeEncoder(encoder);
+            }
+
+            connectorId_ = connector->connector_id;
+        }
+
+        drmModeFreeConnector(connector);
+    }
+
+    drmModeFreeResources(resources);
+
+    if(crtcId_ == 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] no connected display found.";
+        return false;
+    }
+
+    savedCrtc_ = drmModeGetCrtc(fd_, crtcId_);
+    OPENAUTO_LOG(info) << "[DRMVideoOutput] connector: " << connectorId_ << ", crtc: " << crtcId_ << ", mode: " << mode_.name;
+    return true;
+}
+
+bool DRMVideoOutput::createFrameBuffer(FrameBuffer& frameBuffer)
+{
+    drm_mode_create_dumb createRequest;
+    memset(&createRequest, 0, sizeof(createRequest));
+    createRequest.width = mode_.hdisplay;
+    createRequest.height = mode_.vdisplay;
+    createRequest.bpp = 32;
+
+    if(drmIoctl(fd_, DRM_IOCTL_MODE_CREATE_DUMB, &createRequest) != 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] dumb buffer creation failed: " << strerror(errno);
+        return false;
+    }
+
+    frameBuffer.handle = createRequest.handle;
+    frameBuffer.pitch = createRequest.pitch;
+    frameBuffer.size = createRequest.size;
+
+    const uint32_t handles[4] = {frameBuffer.handle, 0, 0, 0};
+    const uint32_t pitches[4] = {frameBuffer.pitch, 0, 0, 0};
+    const uint32_t offsets[4] = {0, 0, 0, 0};
+
+    if(drmModeAddFB2(fd_, mode_.hdisplay, mode_.vdisplay, DRM_FORMAT_XRGB8888, handles, pitches, offsets, &frameBuffer.id, 0) != 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] framebuffer creation failed: " << strerror(errno);
+        return false;
+    }
+
+    drm_mode_map_dumb mapRequest;
+    memset(&mapRequest, 0, sizeof(mapRequest));
+    mapRequest.handle = frameBuffer.handle;
+
+    if(drmIoctl(fd_, DRM_IOCTL_MODE_MAP_DUMB, &mapRequest) != 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] dumb buffer mapping failed: " << strerror(errno);
+        return false;
+    }
+
+    void* map = mmap(nullptr, frameBuffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, mapRequest.offset);
+    if(map == MAP_FAILED)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] mmap failed: " << strerror(errno);
+        return false;
+    }
+
+    frameBuffer.map = static_cast<uint8_t*>(map);
+    memset(frameBuffer.map, 0, frameBuffer.size);
+    return true;
+}
+
+void DRMVideoOutput::destroyFrameBuffer(FrameBuffer& frameBuffer)
+{
+    if(frameBuffer.map != nullptr)
+    {
+        munmap(frameBuffer.map, frameBuffer.size);
+    }
+
+    if(frameBuffer.id != 0)
+    {
+        drmModeRmFB(fd_, frameBuffer.id);
+    }
+
+    if(frameBuffer.handle != 0)
+    {
+        drm_mode_destroy_dumb destroyRequest;
+        memset(&destroyRequest, 0, sizeof(destroyRequest));
+        destroyRequest.handle = frameBuffer.handle;
+        drmIoctl(fd_, DRM_IOCTL_MODE_DESTROY_DUMB, &destroyRequest);
+    }
+
+    memset(&frameBuffer, 0, sizeof(frameBuffer));
+}
+
+void DRMVideoOutput::drawFrame(const AVFrame* frame)
+{
+    int index = cNoBuffer;
+
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+        for(int i = 0; i < static_cast<int>(cFrameBuffersCount); ++i)
+        {
+            if(i != frontBuffer_ && i != pendingBuffer_)
+            {
+                index = i;
+                break;
+            }
+        }
+
+        // a frame still waiting for its flip is overwritten by the newer one
+        if(index == readyBuffer_)
+        {
+            readyBuffer_ = cNoBuffer;
+            ++replacedFramesCount_;
+        }
+    }
+
+    auto& frameBuffer = frameBuffers_[index];
+    uint8_t* const planes[4] = {frameBuffer.map, nullptr, nullptr, nullptr};
+    const int strides[4] = {static_cast<int>(frameBuffer.pitch), 0, 0, 0};
+
+    if(!decoder_.convert(frame, AV_PIX_FMT_BGR0, mode_.hdisplay, mode_.vdisplay, planes, strides))
+    {
+        ++decodeErrorsCount_;
+        return;
+    }
+
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    if(pendingBuffer_ == cNoBuffer)
+    {
+        this->present(index);
+    }
+    else
+    {
+        readyBuffer_ = index;
+    }
+}
+
+void DRMVideoOutput::present(int index)
+{
+    if(!modeSet_)
+    {
+        if(drmModeSetCrtc(fd_, crtcId_, frameBuffers_[index].id, 0, 0, &connectorId_, 1, &mode_) != 0)
+        {
+            OPENAUTO_LOG(error) << "[DRMVideoOutput] mode set failed: " << strerror(errno);
+            return;
+        }
+
+        modeSet_ = true;
+        frontBuffer_ = index;
+        return;
+    }
+
+    if(drmModePageFlip(fd_, crtcId_, frameBuffers_[index].id, DRM_MODE_PAGE_FLIP_EVENT, this) != 0)
+    {
+        OPENAUTO_LOG(error) << "[DRMVideoOutput] page flip failed: " << strerror(errno);
+        return;
+    }
+
+    pendingBuffer_ = index;
+}
+
+void DRMVideoOutput::pollEvents()
+{
+    drmEventContext eventContext;
+    memset(&eventContext, 0, sizeof(eventContext));
+    eventContext.version = 2;
+    eventContext.page_flip_handler = &DRMVideoOutput::onPageFlip;
+
+    pollfd descriptor;
+    descriptor.fd = fd_;
+    descriptor.events = POLLIN;
+
+    // the timeout only bounds how long stop() waits for this thread
+    while(isActive_)
+    {
+        if(poll(&descriptor, 1, 100) > 0 && (descriptor.revents & POLLIN))
+        {
+            drmHandleEvent(fd_, &eventContext);
+        }
+    }
+}
+
+void DRMVideoOutput::onPageFlip(int, unsigned int, unsigned int, unsigned int, void* userData)
+{
+    auto self = static_cast<DRMVideoOutput*>(userData);
+    std::lock_guard<decltype(self->mutex_)> lock(self->mutex_);
+
+    ++self->flipsCount_;
+    self->frontBuffer_ = self->pendingBuffer_;
+    self->pendingBuffer_ = cNoBuffer;
+
+    if(self->readyBuffer_ != cNoBuffer)
+    {
+        const auto index = self->readyBuffer_;
+        self->readyBuffer_ = cNoBuffer;
+        self->present(index);
+    }
+}
+
+void DRMVideoOutput::release()
+{
+    decoder_.close();
+
+    if(fd_ < 0)
+    {
+        return;
+    }
+
+    if(savedCrtc_ != nullptr)
+    {
+        drmModeSetCrtc(fd_, savedCrtc_->crtc_id, savedCrtc_->buffer_id, savedCrtc_->x, savedCrtc_->y, &connectorId_, 1, &savedCrtc_->mode);
+        drmModeFreeCrtc(savedCrtc_);
+        savedCrtc_ = nullptr;
+    }
+
+    for(auto& frameBuffer : frameBuffers_)
+    {
+        this->destroyFrameBuffer(frameBuffer);
+    }
+
+    drmDropMaster(fd_);
+    close(fd_);
+    fd_ = -1;
+    connectorId_ = 0;
+    crtcId_ = 0;
+    frontBuffer_ = cNoBuffer;
+    pendingBuffer_ = cNoBuffer;
+    readyBuffer_ = cNoBuffer;
+    modeSet_ = false;
+}
+
+}
+}
+}
+}
+
+#endif
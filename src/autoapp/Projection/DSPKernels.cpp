@@ -0,0 +1,204 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/DSPKernels.hpp>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OPENAUTO_DSP_NEON
+#endif
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+namespace dsp
+{
+
+float dotProduct(const float* a, const float* b, size_t count)
+{
+    size_t i = 0;
+    float result = 0.0f;
+
+#if defined(__SSE__)
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+
+    for(; i + 8 <= count; i += 8)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    float partial[4];
+    _mm_storeu_ps(partial, _mm_add_ps(sum0, sum1));
+    result = partial[0] + partial[1] + partial[2] + partial[3];
+#elif defined(OPENAUTO_DSP_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+
+    for(; i + 8 <= count; i += 8)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+
+    float partial[4];
+    vst1q_f32(partial, vaddq_f32(sum0, sum1));
+    result = partial[0] + partial[1] + partial[2] + partial[3];
+#endif
+
+    for(; i < count; ++i)
+    {
+        result += a[i] * b[i];
+    }
+
+    return result;
+}
+
+void dualDotProduct(const float* coefficients, const float* a, const float* b, size_t count, float& resultA, float& resultB)
+{
+    // filters two channels with the same coefficients, halving the coefficient loads of two dotProduct calls
+    size_t i = 0;
+    resultA = 0.0f;
+    resultB = 0.0f;
+
+#if defined(__SSE__)
+    __m128 sumA = _mm_setzero_ps();
+    __m128 sumB = _mm_setzero_ps();
+
+    for(; i + 4 <= count; i += 4)
+    {
+        const __m128 coefficients4 = _mm_loadu_ps(coefficients + i);
+        sumA = _mm_add_ps(sumA, _mm_mul_ps(coefficients4, _mm_loadu_ps(a + i)));
+        sumB = _mm_add_ps(sumB, _mm_mul_ps(coefficients4, _mm_loadu_ps(b + i)));
+    }
+
+    float partialA[4];
+    float partialB[4];
+    _mm_storeu_ps(partialA, sumA);
+    _mm_storeu_ps(partialB, sumB);
+    resultA = partialA[0] + partialA[1] + partialA[2] + partialA[3];
+    resultB = partialB[0] + partialB[1] + partialB[2] + partialB[3];
+#elif defined(OPENAUTO_DSP_NEON)
+    float32x4_t sumA = vdupq_n_f32(0.0f);
+    float32x4_t sumB = vdupq_n_f32(0.0f);
+
+    for(; i + 4 <= count; i += 4)
+    {
+        const float32x4_t coefficients4 = vld1q_f32(coefficients + i);
+        sumA = vmlaq_f32(sumA, coefficients4, vld1q_f32(a + i));
+        sumB = vmlaq_f32(sumB, coefficients4, vld1q_f32(b + i));
+    }
+
+    float partialA[4];
+    float partialB[4];
+    vst1q_f32(partialA, sumA);
+    vst1q_f32(partialB, sumB);
+    resultA = partialA[0] + partialA[1] + partialA[2] + partialA[3];
+    resultB = partialB[0] + partialB[1] + partialB[2] + partialB[3];
+#endif
+
+    for(; i < count; ++i)
+    {
+        resultA += coefficients[i] * a[i];
+        resultB += coefficients[i] * b[i];
+    }
+}
+
+void multiplyAccumulate(float* destination, const float* source, float gain, size_t count)
+{
+    size_t i = 0;
+
+#if defined(__SSE__)
+    const __m128 gain4 = _mm_set1_ps(gain);
+
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain4)));
+    }
+#elif defined(OPENAUTO_DSP_NEON)
+    const float32x4_t gain4 = vdupq_n_f32(gain);
+
+    for(; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(destination + i, vmlaq_f32(vld1q_f32(destination + i), vld1q_f32(source + i), gain4));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        destination[i] += source[i] * gain;
+    }
+}
+
+void multiply(float* destination, float gain, size_t count)
+{
+    size_t i = 0;
+
+#if defined(__SSE__)
+    const __m128 gain4 = _mm_set1_ps(gain);
+
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_loadu_ps(destination + i), gain4));
+    }
+#elif defined(OPENAUTO_DSP_NEON)
+    const float32x4_t gain4 = vdupq_n_f32(gain);
+
+    for(; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(destination + i, vmulq_f32(vld1q_f32(destination + i), gain4));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        destination[i] *= gain;
+    }
+}
+
+void convertToFloat(const int16_t* source, float* destination, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        destination[i] = static_cast<float>(source[i]) * (1.0f / 32768.0f);
+    }
+}
+
+void convertToInt16(const float* source, int16_t* destination, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float sample = std::min(1.0f, std::max(-1.0f, source[i]));
+        destination[i] = static_cast<int16_t>(sample * 32767.0f);
+    }
+}
+
+}
+}
+}
+}
+}
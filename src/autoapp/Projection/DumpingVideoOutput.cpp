@@ -0,0 +1,271 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cerrno>
+#include <f1x/openauto/autoapp/Projection/DumpingVideoOutput.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr uint32_t DumpingVideoOutput::cMagic;
+constexpr uint32_t DumpingVideoOutput::cVersion;
+constexpr uint32_t DumpingVideoOutput::cDroppedRecordsMarker;
+constexpr size_t DumpingVideoOutput::cMaxQueuedSize;
+constexpr uint32_t DumpingVideoOutput::cMaxFilesCount;
+
+namespace
+{
+
+void putLittleEndian(uint8_t* destination, uint64_t value, size_t size)
+{
+    for(size_t i = 0; i < size; ++i)
+    {
+        destination[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+bool writeRecord(FILE* file, uint64_t timestamp, uint32_t size, const uint8_t* payload, size_t payloadSize)
+{
+    uint8_t header[12];
+    putLittleEndian(header, timestamp, 8);
+    putLittleEndian(header + 8, size, 4);
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+           (payloadSize == 0 || fwrite(payload, 1, payloadSize, file) == payloadSize);
+}
+
+}
+
+DumpingVideoOutput::DumpingVideoOutput(IVideoOutput::Pointer videoOutput, std::string path)
+    : videoOutput_(std::move(videoOutput))
+    , path_(std::move(path))
+    , queuedSize_(0)
+    , stopped_(true)
+    , file_(nullptr)
+    , writtenRecordsCount_(0)
+    , droppedRecordsCount_(0)
+    , pendingDroppedRecordsCount_(0)
+{
+
+}
+
+DumpingVideoOutput::~DumpingVideoOutput()
+{
+    this->close();
+}
+
+bool DumpingVideoOutput::open()
+{
+    this->close();
+
+    file_ = this->createFile();
+    if(file_ == nullptr)
+    {
+        OPENAUTO_LOG(error) << "[DumpingVideoOutput] cannot create a dump file for " << path_ << ", video is not dumped.";
+    }
+    else
+    {
+        uint8_t header[8];
+        putLittleEndian(header, cMagic, 4);
+        putLittleEndian(header + 4, cVersion, 4);
+        fwrite(header, 1, sizeof(header), file_);
+
+        OPENAUTO_LOG(info) << "[DumpingVideoOutput] dumping video to " << filePath_;
+        writtenRecordsCount_ = 0;
+        droppedRecordsCount_ = 0;
+        pendingDroppedRecordsCount_ = 0;
+        stopped_ = false;
+        thread_ = std::thread(&DumpingVideoOutput::run, this);
+    }
+
+    return videoOutput_->open();
+}
+
+bool DumpingVideoOutput::init()
+{
+    return videoOutput_->init();
+}
+
+void DumpingVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer)
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+        if(!stopped_)
+        {
+            if(queuedSize_ + buffer.size > cMaxQueuedSize)
+            {
+                ++droppedRecordsCount_;
+                ++pendingDroppedRecordsCount_;
+            }
+            else
+            {
+                queuedSize_ += buffer.size;
+                records_.push_back(Record{timestamp, aasdk::common::Data(buffer.cdata, buffer.cdata + buffer.size), pendingDroppedRecordsCount_});
+                pendingDroppedRecordsCount_ = 0;
+                condition_.notify_one();
+            }
+        }
+    }
+
+    videoOutput_->write(timestamp, buffer);
+}
+
+void DumpingVideoOutput::stop()
+{
+    videoOutput_->stop();
+    this->close();
+}
+
+aasdk::proto::enums::VideoFPS::Enum DumpingVideoOutput::getVideoFPS() const
+{
+    return videoOutput_->getVideoFPS();
+}
+
+aasdk::proto::enums::VideoResolution::Enum DumpingVideoOutput::getVideoResolution() const
+{
+    return videoOutput_->getVideoResolution();
+}
+
+size_t DumpingVideoOutput::getScreenDPI() const
+{
+    return videoOutput_->getScreenDPI();
+}
+
+QRect DumpingVideoOutput::getVideoMargins() const
+{
+    return videoOutput_->getVideoMargins();
+}
+
+IVideoOutput::VideoConfigs DumpingVideoOutput::getVideoConfigs() const
+{
+    return videoOutput_->getVideoConfigs();
+}
+
+float DumpingVideoOutput::getBacklog() const
+{
+    return videoOutput_->getBacklog();
+}
+
+uint64_t DumpingVideoOutput::getDecodeErrorsCount() const
+{
+    return videoOutput_->getDecodeErrorsCount();
+}
+
+FILE* DumpingVideoOutput::createFile()
+{
+    const auto slash = path_.find_last_of('/');
+    const auto dot = path_.find_last_of('.');
+    const bool hasExtension = dot != std::string::npos && dot > 0 && (slash == std::string::npos || dot > slash + 1);
+    const auto split = hasExtension ? dot : path_.size();
+
+    for(uint32_t index = 1; index <= cMaxFilesCount; ++index)
+    {
+        filePath_ = path_.substr(0, split) + "-" + std::to_string(index) + path_.substr(split);
+
+        // "x" refuses an existing file, so the first free number is taken without a race
+        FILE* file = fopen(filePath_.c_str(), "wbx");
+        if(file != nullptr || errno != EEXIST)
+        {
+            return file;
+        }
+    }
+
+    return nullptr;
+}
+
+void DumpingVideoOutput::run()
+{
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    bool failed = false;
+
+    while(!stopped_ || !records_.empty())
+    {
+        if(records_.empty())
+        {
+            condition_.wait(lock);
+            continue;
+        }
+
+        Record record = std::move(records_.front());
+        records_.pop_front();
+        lock.unlock();
+
+        // after a failed write the file ends in a partial record, nothing may follow it
+        const bool written = !failed &&
+                             (record.droppedRecordsCount == 0 || writeRecord(file_, record.droppedRecordsCount, cDroppedRecordsMarker, nullptr, 0)) &&
+                             writeRecord(file_, record.timestamp, record.payload.size(), record.payload.data(), record.payload.size());
+
+        if(!written && !failed)
+        {
+            failed = true;
+            OPENAUTO_LOG(error) << "[DumpingVideoOutput] cannot write to " << filePath_ << ", dumping stopped.";
+        }
+
+        lock.lock();
+        queuedSize_ -= record.payload.size();
+
+        if(written)
+        {
+            ++writtenRecordsCount_;
+        }
+        else
+        {
+            ++droppedRecordsCount_;
+        }
+    }
+
+    if(!failed && pendingDroppedRecordsCount_ > 0)
+    {
+        writeRecord(file_, pendingDroppedRecordsCount_, cDroppedRecordsMarker, nullptr, 0);
+    }
+}
+
+void DumpingVideoOutput::close()
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        stopped_ = true;
+        condition_.notify_one();
+    }
+
+    if(thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    if(file_ != nullptr)
+    {
+        fclose(file_);
+        file_ = nullptr;
+
+        OPENAUTO_LOG(info) << "[DumpingVideoOutput] dump closed, records: " << writtenRecordsCount_
+                           << ", dropped: " << droppedRecordsCount_;
+    }
+}
+
+}
+}
+}
+}
@@ -0,0 +1,137 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/EchoReference.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr size_t EchoReference::cWriteChunkSize;
+
+EchoReference::Source::Source(size_t capacity)
+    : samples(capacity)
+    , accumulator(0.0f)
+    , accumulatedCount(0)
+    , phase(0)
+{
+
+}
+
+EchoReference::EchoReference(uint32_t sampleRate)
+    : sampleRate_(sampleRate)
+{
+
+}
+
+EchoReference::SourceId EchoReference::addSource()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    sources_.emplace_back(new Source(sampleRate_));
+    return sources_.size() - 1;
+}
+
+void EchoReference::write(SourceId sourceId, const int16_t* samples, size_t frameCount, uint32_t channelCount, uint32_t sampleRate)
+{
+    // no lock here, every source has exactly one writer and the queue is the only state shared with read()
+    if(sourceId >= sources_.size() || channelCount == 0 || sampleRate < sampleRate_)
+    {
+        return;
+    }
+
+    // written from the output device callbacks, so the reference follows the playout and not the arrival of packets.
+    // Audio is folded down to mono and box-filtered to the reference rate, the phase accumulator keeps
+    // non-integer ratios (e.g. 44.1 kHz devices) on the reference clock.
+    // Echo paths are dominated by speech band energy so this is sufficient for the canceller.
+    auto& source = *sources_[sourceId];
+    float chunk[cWriteChunkSize];
+    size_t chunkSize = 0;
+
+    for(size_t frame = 0; frame < frameCount; ++frame)
+    {
+        for(uint32_t channel = 0; channel < channelCount; ++channel)
+        {
+            source.accumulator += samples[frame * channelCount + channel];
+        }
+
+        ++source.accumulatedCount;
+        source.phase += sampleRate_;
+
+        if(source.phase >= sampleRate)
+        {
+            source.phase -= sampleRate;
+            chunk[chunkSize++] = source.accumulator / (32768.0f * channelCount * source.accumulatedCount);
+            source.accumulator = 0.0f;
+            source.accumulatedCount = 0;
+
+            if(chunkSize == cWriteChunkSize)
+            {
+                source.samples.push(chunk, chunkSize);
+                chunkSize = 0;
+            }
+        }
+    }
+
+    // a full queue means the capture side is not reading, the surplus is dropped
+    source.samples.push(chunk, chunkSize);
+}
+
+void EchoReference::read(float* samples, size_t count)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    std::fill(samples, samples + count, 0.0f);
+    readBuffer_.resize(count);
+
+    for(auto& source : sources_)
+    {
+        const auto available = source->samples.pop(readBuffer_.data(), count);
+        for(size_t i = 0; i < available; ++i)
+        {
+            samples[i] += readBuffer_[i];
+        }
+    }
+}
+
+void EchoReference::reset()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    // only the consumer side can be reset from here, the fold-down state of the writers is at most one sample old
+    for(auto& source : sources_)
+    {
+        source->samples.consume_all([](float) {});
+    }
+}
+
+uint32_t EchoReference::getSampleRate() const
+{
+    return sampleRate_;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,405 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <f1x/openauto/autoapp/Projection/EvdevInputDevice.hpp>
+#include <f1x/openauto/autoapp/Projection/IInputDeviceEventHandler.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+namespace
+{
+
+bool testBit(const std::vector<unsigned long>& bits, size_t bit)
+{
+    const size_t bitsPerWord = sizeof(unsigned long) * 8;
+    return (bits[bit / bitsPerWord] >> (bit % bitsPerWord)) & 1UL;
+}
+
+}
+
+EvdevInputDevice::Device::Device(boost::asio::io_service& ioService, std::string path, int fd)
+    : path(std::move(path))
+    , descriptor(ioService, fd)
+    , index(0)
+    , x{0, 1}
+    , y{0, 1}
+    , multiTouch(false)
+    , currentSlot(0)
+    , slots(cMaxSlots, Slot{-1, 0, 0, false})
+{
+
+}
+
+EvdevInputDevice::EvdevInputDevice(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, const QRect& touchscreenGeometry, const QRect& displayGeometry)
+    : ioService_(ioService)
+    , strand_(ioService)
+    , configuration_(std::move(configuration))
+    , configurationView_(configuration_)
+    , touchscreenGeometry_(touchscreenGeometry)
+    , displayGeometry_(displayGeometry)
+    , eventHandler_(nullptr)
+{
+    keyMap_.load(configurationView_.get());
+}
+
+void EvdevInputDevice::start(IInputDeviceEventHandler& eventHandler)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), eventHandler = &eventHandler]() {
+        OPENAUTO_LOG(info) << "[EvdevInputDevice] start.";
+        eventHandler_ = eventHandler;
+
+        configuration_->subscribe({configuration::Configuration::cKeyMapSection, configuration::Configuration::cScanCodeMapSection}, this->shared_from_this());
+
+        const auto& devicePaths = configuration_->getEvdevDevices();
+        for(size_t i = 0; i < devicePaths.size(); ++i)
+        {
+            auto device = this->openDevice(devicePaths[i], i);
+
+            if(device != nullptr)
+            {
+                devices_.push_back(device);
+                this->readDevice(std::move(device));
+            }
+        }
+    });
+}
+
+void EvdevInputDevice::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[EvdevInputDevice] stop.";
+        configuration_->unsubscribe(this->shared_from_this());
+        eventHandler_ = nullptr;
+
+        for(auto& device : devices_)
+        {
+            boost::system::error_code ec;
+            device->descriptor.close(ec);
+        }
+
+        devices_.clear();
+        touchPointTracker_ = TouchPointTracker();
+    });
+}
+
+IInputDevice::ButtonCodes EvdevInputDevice::getSupportedButtonCodes() const
+{
+    return keyMap_.getSupportedButtonCodes();
+}
+
+bool EvdevInputDevice::isButtonCodeSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const
+{
+    return keyMap_.isSupported(buttonCode);
+}
+
+void EvdevInputDevice::onConfigurationChanged(const ChangedKeys&)
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        configurationView_.refresh();
+        keyMap_.reload(configurationView_.get());
+    });
+}
+
+void EvdevInputDevice::setDisplayGeometry(const QRect& displayGeometry)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), displayGeometry]() {
+        displayGeometry_ = displayGeometry;
+    });
+}
+
+bool EvdevInputDevice::hasTouchscreen() const
+{
+    return configuration_->getTouchscreenEnabled();
+}
+
+QRect EvdevInputDevice::getTouchscreenGeometry() const
+{
+    return touchscreenGeometry_;
+}
+
+EvdevInputDevice::DevicePointer EvdevInputDevice::openDevice(const std::string& path, size_t index)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if(fd < 0)
+    {
+        OPENAUTO_LOG(error) << "[EvdevInputDevice] Failed to open " << path << ", errno: " << errno;
+        return nullptr;
+    }
+
+    // exclusive access keeps the same events from reaching the window system
+    if(ioctl(fd, EVIOCGRAB, 1) < 0)
+    {
+        OPENAUTO_LOG(warning) << "[EvdevInputDevice] Failed to grab " << path << ", errno: " << errno;
+    }
+
+    auto device = std::make_shared<Device>(ioService_, path, fd);
+    device->index = index;
+
+    std::vector<unsigned long> absoluteBits(ABS_CNT / (sizeof(unsigned long) * 8) + 1, 0);
+    ioctl(fd, EVIOCGBIT(EV_ABS, absoluteBits.size() * sizeof(unsigned long)), absoluteBits.data());
+    device->multiTouch = testBit(absoluteBits, ABS_MT_SLOT) && testBit(absoluteBits, ABS_MT_POSITION_X);
+
+    const int xAxis = device->multiTouch ? ABS_MT_POSITION_X : ABS_X;
+    const int yAxis = device->multiTouch ? ABS_MT_POSITION_Y : ABS_Y;
+    input_absinfo absoluteInfo;
+
+    if(testBit(absoluteBits, xAxis) && ioctl(fd, EVIOCGABS(xAxis), &absoluteInfo) == 0 && absoluteInfo.maximum > absoluteInfo.minimum)
+    {
+        device->x = {absoluteInfo.minimum, absoluteInfo.maximum};
+    }
+
+    if(testBit(absoluteBits, yAxis) && ioctl(fd, EVIOCGABS(yAxis), &absoluteInfo) == 0 && absoluteInfo.maximum > absoluteInfo.minimum)
+    {
+        device->y = {absoluteInfo.minimum, absoluteInfo.maximum};
+    }
+
+    OPENAUTO_LOG(info) << "[EvdevInputDevice] Opened " << path
+                       << ", multi-touch: " << device->multiTouch
+                       << ", x range: " << device->x.minimum << "-" << device->x.maximum
+                       << ", y range: " << device->y.minimum << "-" << device->y.maximum;
+
+    return device;
+}
+
+void EvdevInputDevice::readDevice(DevicePointer device)
+{
+    auto buffer = boost::asio::buffer(device->events);
+    device->descriptor.async_read_some(buffer, strand_.wrap(std::bind(&EvdevInputDevice::onDeviceRead, this->shared_from_this(), std::move(device), std::placeholders::_1, std::placeholders::_2)));
+}
+
+void EvdevInputDevice::onDeviceRead(DevicePointer device, const boost::system::error_code& error, size_t bytesTransferred)
+{
+    if(error || eventHandler_ == nullptr)
+    {
+        if(error != boost::asio::error::operation_aborted && error != boost::asio::error::bad_descriptor)
+        {
+            OPENAUTO_LOG(error) << "[EvdevInputDevice] Failed to read " << device->path << ", what: " << error.message();
+        }
+
+        return;
+    }
+
+    const size_t eventCount = bytesTransferred / sizeof(input_event);
+    for(size_t i = 0; i < eventCount; ++i)
+    {
+        this->handleEvent(*device, device->events[i]);
+    }
+
+    this->readDevice(std::move(device));
+}
+
+void EvdevInputDevice::handleEvent(Device& device, const input_event& event)
+{
+    switch(event.type)
+    {
+    case EV_ABS:
+        this->handleAbsoluteEvent(device, event);
+        break;
+
+    case EV_KEY:
+        this->handleKeyEvent(device, event);
+        break;
+
+    case EV_REL:
+        this->handleRelativeEvent(event);
+        break;
+
+    case EV_SYN:
+        if(event.code == SYN_REPORT)
+        {
+            this->handleSynchronization(device);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void EvdevInputDevice::handleAbsoluteEvent(Device& device, const input_event& event)
+{
+    if(device.multiTouch)
+    {
+        if(event.code == ABS_MT_SLOT)
+        {
+            device.currentSlot = event.value >= 0 && static_cast<size_t>(event.value) < cMaxSlots ? event.value : cMaxSlots - 1;
+            return;
+        }
+
+        auto& slot = device.slots[device.currentSlot];
+
+        switch(event.code)
+        {
+        case ABS_MT_TRACKING_ID:
+            slot.trackingId = event.value;
+            slot.changed = true;
+            break;
+
+        case ABS_MT_POSITION_X:
+            slot.x = event.value;
+            slot.changed = true;
+            break;
+
+        case ABS_MT_POSITION_Y:
+            slot.y = event.value;
+            slot.changed = true;
+            break;
+
+        default:
+            break;
+        }
+    }
+    else if(event.code == ABS_X || event.code == ABS_Y)
+    {
+        auto& slot = device.slots[0];
+        (event.code == ABS_X ? slot.x : slot.y) = event.value;
+        slot.changed = true;
+    }
+}
+
+void EvdevInputDevice::handleKeyEvent(Device& device, const input_event& event)
+{
+    // single-touch panels report contact through BTN_TOUCH instead of tracking ids
+    if(event.code == BTN_TOUCH || event.code == BTN_LEFT)
+    {
+        if(!device.multiTouch)
+        {
+            device.slots[0].trackingId = event.value != 0 ? 0 : -1;
+            device.slots[0].changed = true;
+        }
+
+        return;
+    }
+
+    // autorepeat (value 2) is not forwarded, the phone handles long presses itself
+    if(event.value == 2)
+    {
+        return;
+    }
+
+    const auto* binding = keyMap_.findScanCode(event.code);
+
+    if(binding != nullptr)
+    {
+        if(binding->code != aasdk::proto::enums::ButtonCode::SCROLL_WHEEL)
+        {
+            eventHandler_->onButtonEvent({event.value != 0 ? ButtonEventType::PRESS : ButtonEventType::RELEASE, WheelDirection::NONE, binding->code});
+        }
+        else if(event.value == 0)
+        {
+            eventHandler_->onButtonEvent({ButtonEventType::NONE, binding->wheelDirection, binding->code});
+        }
+    }
+}
+
+void EvdevInputDevice::handleRelativeEvent(const input_event& event)
+{
+    // rotary encoders report as relative wheels
+    if((event.code == REL_WHEEL || event.code == REL_HWHEEL || event.code == REL_DIAL) && event.value != 0
+       && keyMap_.isSupported(aasdk::proto::enums::ButtonCode::SCROLL_WHEEL))
+    {
+        // a report is forwarded as one event so the acceleration follows the rate of reports, not of detents
+        const auto wheelDirection = event.value < 0 ? WheelDirection::LEFT : WheelDirection::RIGHT;
+        eventHandler_->onButtonEvent({ButtonEventType::NONE, wheelDirection, aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, static_cast<uint32_t>(std::abs(event.value))});
+    }
+}
+
+void EvdevInputDevice::handleSynchronization(Device& device)
+{
+    configurationView_.refresh();
+    if(!configurationView_.get().enableTouchscreen)
+    {
+        return;
+    }
+
+    bool moved = false;
+
+    // same ordering as the Qt backend: pointer downs, one drag with every pointer, pointer ups
+    for(size_t i = 0; i < device.slots.size(); ++i)
+    {
+        const auto& slot = device.slots[i];
+        const auto id = touchPointId(device, i);
+
+        if(slot.changed && slot.trackingId >= 0 && !touchPointTracker_.contains(id))
+        {
+            eventHandler_->onTouchEvent(touchPointTracker_.press(id, this->calibrate(slot.x, device.x, displayGeometry_.width()),
+                                                                this->calibrate(slot.y, device.y, displayGeometry_.height())));
+        }
+    }
+
+    for(size_t i = 0; i < device.slots.size(); ++i)
+    {
+        const auto& slot = device.slots[i];
+
+        if(slot.changed && slot.trackingId >= 0)
+        {
+            moved = touchPointTracker_.move(touchPointId(device, i), this->calibrate(slot.x, device.x, displayGeometry_.width()),
+                                            this->calibrate(slot.y, device.y, displayGeometry_.height())) || moved;
+        }
+    }
+
+    if(moved)
+    {
+        eventHandler_->onTouchEvent(touchPointTracker_.drag());
+    }
+
+    for(size_t i = 0; i < device.slots.size(); ++i)
+    {
+        auto& slot = device.slots[i];
+        const auto id = touchPointId(device, i);
+
+        if(slot.changed && slot.trackingId < 0 && touchPointTracker_.contains(id))
+        {
+            eventHandler_->onTouchEvent(touchPointTracker_.release(id));
+        }
+
+        slot.changed = false;
+    }
+}
+
+uint32_t EvdevInputDevice::calibrate(int32_t value, const Axis& axis, int32_t size) const
+{
+    const int32_t clamped = std::max(axis.minimum, std::min(axis.maximum, value));
+    return static_cast<uint32_t>(static_cast<int64_t>(clamped - axis.minimum) * (size - 1) / (axis.maximum - axis.minimum));
+}
+
+int EvdevInputDevice::touchPointId(const Device& device, size_t slot)
+{
+    return static_cast<int>(device.index * cMaxSlots + slot);
+}
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/Projection/FocusedAudioOutput.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+FocusedAudioOutput::FocusedAudioOutput(IAudioOutput::Pointer audioOutput)
+    : audioOutput_(std::move(audioOutput))
+    , started_(false)
+    , focus_(true)
+    , running_(false)
+{
+
+}
+
+bool FocusedAudioOutput::open()
+{
+    return audioOutput_->open();
+}
+
+void FocusedAudioOutput::write(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    // stream without focus is suspended, buffering its data would only add latency once focus is back
+    if(running_)
+    {
+        audioOutput_->write(timestamp, buffer);
+    }
+}
+
+void FocusedAudioOutput::start()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    started_ = true;
+    this->updateStreamState();
+}
+
+void FocusedAudioOutput::stop()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    started_ = false;
+    running_ = false;
+    audioOutput_->stop();
+}
+
+void FocusedAudioOutput::suspend()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    started_ = false;
+    this->updateStreamState();
+}
+
+void FocusedAudioOutput::setGain(float gain)
+{
+    audioOutput_->setGain(gain);
+}
+
+uint32_t FocusedAudioOutput::getSampleSize() const
+{
+    return audioOutput_->getSampleSize();
+}
+
+uint32_t FocusedAudioOutput::getChannelCount() const
+{
+    return audioOutput_->getChannelCount();
+}
+
+uint32_t FocusedAudioOutput::getSampleRate() const
+{
+    return audioOutput_->getSampleRate();
+}
+
+void FocusedAudioOutput::setFocus(bool focus, float gain)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    audioOutput_->setGain(gain);
+    focus_ = focus;
+    this->updateStreamState();
+}
+
+void FocusedAudioOutput::updateStreamState()
+{
+    const bool running = started_ && focus_;
+
+    if(running != running_)
+    {
+        running_ = running;
+
+        if(running_)
+        {
+            audioOutput_->start();
+        }
+        else
+        {
+            audioOutput_->suspend();
+        }
+    }
+}
+
+}
+}
+}
+}
@@ -19,6 +19,7 @@
 #include <f1x/openauto/Common/Log.hpp>
 #include <f1x/openauto/autoapp/Projection/IInputDeviceEventHandler.hpp>
 #include <f1x/openauto/autoapp/Projection/InputDevice.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
 
 namespace f1x
 {
@@ -32,10 +33,13 @@ namespace projection
 InputDevice::InputDevice(QObject& parent, configuration::IConfiguration::Pointer configuration, const QRect& touchscreenGeometry, const QRect& displayGeometry)
     : parent_(parent)
     , configuration_(std::move(configuration))
+    , configurationView_(configuration_)
     , touchscreenGeometry_(touchscreenGeometry)
     , displayGeometry_(displayGeometry)
     , eventHandler_(nullptr)
+    , touchEventsReceived_(false)
 {
+    keyMap_.load(configurationView_.get());
     this->moveToThread(parent.thread());
 }
 
@@ -45,6 +49,7 @@ void InputDevice::start(IInputDeviceEventHandler& eventHandler)
 
     OPENAUTO_LOG(info) << "[InputDevice] start.";
     eventHandler_ = &eventHandler;
+    configuration_->subscribe({configuration::Configuration::cKeyMapSection, configuration::Configuration::cScanCodeMapSection}, this->shared_from_this());
     parent_.installEventFilter(this);
 }
 
@@ -53,8 +58,10 @@ void InputDevice::stop()
     std::lock_guard<decltype(mutex_)> lock(mutex_);
 
     OPENAUTO_LOG(info) << "[InputDevice] stop.";
+    configuration_->unsubscribe(this->shared_from_this());
     parent_.removeEventFilter(this);
     eventHandler_ = nullptr;
+    touchPointTracker_ = TouchPointTracker();
 }
 
 bool InputDevice::eventFilter(QObject* obj, QEvent* event)
@@ -75,6 +82,10 @@ bool InputDevice::eventFilter(QObject* obj, QEvent* event)
         {
             return this->handleTouchEvent(event);
         }
+        else if(event->type() == QEvent::TouchBegin || event->type() == QEvent::TouchUpdate || event->type() == QEvent::TouchEnd || event->type() == QEvent::TouchCancel)
+        {
+            return this->handleMultiTouchEvent(static_cast<QTouchEvent*>(event));
+        }
     }
 
     return QObject::eventFilter(obj, event);
@@ -82,98 +93,17 @@ bool InputDevice::eventFilter(QObject* obj, QEvent* event)
 
 bool InputDevice::handleKeyEvent(QEvent* event, QKeyEvent* key)
 {
-    auto eventType = event->type() == QEvent::KeyPress ? ButtonEventType::PRESS : ButtonEventType::RELEASE;
-    aasdk::proto::enums::ButtonCode::Enum buttonCode;
-    WheelDirection wheelDirection = WheelDirection::NONE;
+    const auto* binding = keyMap_.findKey(key->key());
 
-    switch(key->key())
+    if(binding != nullptr)
     {
-    case Qt::Key_Return:
-    case Qt::Key_Enter:
-        buttonCode = aasdk::proto::enums::ButtonCode::ENTER;
-        break;
-
-    case Qt::Key_Left:
-        buttonCode = aasdk::proto::enums::ButtonCode::LEFT;
-        break;
-
-    case Qt::Key_Right:
-        buttonCode = aasdk::proto::enums::ButtonCode::RIGHT;
-        break;
-
-    case Qt::Key_Up:
-        buttonCode = aasdk::proto::enums::ButtonCode::UP;
-        break;
-
-    case Qt::Key_Down:
-        buttonCode = aasdk::proto::enums::ButtonCode::DOWN;
-        break;
-
-    case Qt::Key_Escape:
-        buttonCode = aasdk::proto::enums::ButtonCode::BACK;
-        break;
-
-    case Qt::Key_H:
-        buttonCode = aasdk::proto::enums::ButtonCode::HOME;
-        break;
-
-    case Qt::Key_P:
-        buttonCode = aasdk::proto::enums::ButtonCode::PHONE;
-        break;
-
-    case Qt::Key_O:
-        buttonCode = aasdk::proto::enums::ButtonCode::CALL_END;
-        break;
-
-    case Qt::Key_X:
-        buttonCode = aasdk::proto::enums::ButtonCode::PLAY;
-        break;
-
-    case Qt::Key_C:
-        buttonCode = aasdk::proto::enums::ButtonCode::PAUSE;
-        break;
-
-    case Qt::Key_MediaPrevious:
-    case Qt::Key_V:
-        buttonCode = aasdk::proto::enums::ButtonCode::PREV;
-        break;
-
-    case Qt::Key_MediaPlay:
-    case Qt::Key_B:
-        buttonCode = aasdk::proto::enums::ButtonCode::TOGGLE_PLAY;
-        break;
-
-    case Qt::Key_MediaNext:
-    case Qt::Key_N:
-        buttonCode = aasdk::proto::enums::ButtonCode::NEXT;
-        break;
-
-    case Qt::Key_M:
-        buttonCode = aasdk::proto::enums::ButtonCode::MICROPHONE_1;
-        break;
-
-    case Qt::Key_1:
-        wheelDirection = WheelDirection::LEFT;
-        eventType = ButtonEventType::NONE;
-        buttonCode = aasdk::proto::enums::ButtonCode::SCROLL_WHEEL;
-        break;
-
-    case Qt::Key_2:
-        wheelDirection = WheelDirection::RIGHT;
-        eventType = ButtonEventType::NONE;
-        buttonCode = aasdk::proto::enums::ButtonCode::SCROLL_WHEEL;
-        break;
-
-    default:
-        return true;
-    }
-
-    const auto& buttonCodes = this->getSupportedButtonCodes();
-    if(std::find(buttonCodes.begin(), buttonCodes.end(), buttonCode) != buttonCodes.end())
-    {
-        if(buttonCode != aasdk::proto::enums::ButtonCode::SCROLL_WHEEL || event->type() == QEvent::KeyRelease)
+        if(binding->code != aasdk::proto::enums::ButtonCode::SCROLL_WHEEL)
+        {
+            eventHandler_->onButtonEvent({event->type() == QEvent::KeyPress ? ButtonEventType::PRESS : ButtonEventType::RELEASE, WheelDirection::NONE, binding->code});
+        }
+        else if(event->type() == QEvent::KeyRelease)
         {
-            eventHandler_->onButtonEvent({eventType, wheelDirection, buttonCode});
+            eventHandler_->onButtonEvent({ButtonEventType::NONE, binding->wheelDirection, binding->code});
         }
     }
 
@@ -182,7 +112,8 @@ bool InputDevice::handleKeyEvent(QEvent* event, QKeyEvent* key)
 
 bool InputDevice::handleTouchEvent(QEvent* event)
 {
-    if(!configuration_->getTouchscreenEnabled())
+    configurationView_.refresh();
+    if(!configurationView_.get().enableTouchscreen)
     {
         return true;
     }
@@ -205,16 +136,87 @@ bool InputDevice::handleTouchEvent(QEvent* event)
     };
 
     QMouseEvent* mouse = static_cast<QMouseEvent*>(event);
+
+    // once touch events arrive, mouse events synthesized from them would duplicate the input
+    if(touchEventsReceived_ && mouse->source() != Qt::MouseEventNotSynthesized)
+    {
+        return true;
+    }
+
     if(event->type() == QEvent::MouseButtonRelease || mouse->buttons().testFlag(Qt::LeftButton))
     {
-        const uint32_t x = (static_cast<float>(mouse->pos().x()) / touchscreenGeometry_.width()) * displayGeometry_.width();
-        const uint32_t y = (static_cast<float>(mouse->pos().y()) / touchscreenGeometry_.height()) * displayGeometry_.height();
-        eventHandler_->onTouchEvent({type, x, y, 0});
+        const auto position = this->mapTouchPosition(mouse->pos());
+        eventHandler_->onTouchEvent({type, 0, {{static_cast<uint32_t>(position.x()), static_cast<uint32_t>(position.y()), 0}}});
     }
 
     return true;
 }
 
+bool InputDevice::handleMultiTouchEvent(QTouchEvent* touch)
+{
+    configurationView_.refresh();
+    if(!configurationView_.get().enableTouchscreen)
+    {
+        return true;
+    }
+
+    touchEventsReceived_ = true;
+
+    if(touch->type() == QEvent::TouchCancel)
+    {
+        if(!touchPointTracker_.empty())
+        {
+            eventHandler_->onTouchEvent(touchPointTracker_.cancel());
+        }
+
+        return true;
+    }
+
+    const auto& points = touch->touchPoints();
+    bool moved = false;
+
+    // pointer downs first, then a single drag carrying every active pointer, then pointer ups
+    for(const auto& point : points)
+    {
+        if(point.state() == Qt::TouchPointPressed && !touchPointTracker_.contains(point.id()))
+        {
+            const auto position = this->mapTouchPosition(point.pos());
+            eventHandler_->onTouchEvent(touchPointTracker_.press(point.id(), position.x(), position.y()));
+        }
+    }
+
+    for(const auto& point : points)
+    {
+        if(point.state() != Qt::TouchPointStationary)
+        {
+            const auto position = this->mapTouchPosition(point.pos());
+            moved = touchPointTracker_.move(point.id(), position.x(), position.y()) || moved;
+        }
+    }
+
+    if(moved)
+    {
+        eventHandler_->onTouchEvent(touchPointTracker_.drag());
+    }
+
+    for(const auto& point : points)
+    {
+        if(point.state() == Qt::TouchPointReleased && touchPointTracker_.contains(point.id()))
+        {
+            eventHandler_->onTouchEvent(touchPointTracker_.release(point.id()));
+        }
+    }
+
+    return true;
+}
+
+QPoint InputDevice::mapTouchPosition(const QPointF& position) const
+{
+    const uint32_t x = (static_cast<float>(position.x()) / touchscreenGeometry_.width()) * displayGeometry_.width();
+    const uint32_t y = (static_cast<float>(position.y()) / touchscreenGeometry_.height()) * displayGeometry_.height();
+    return QPoint(x, y);
+}
+
 bool InputDevice::hasTouchscreen() const
 {
     return configuration_->getTouchscreenEnabled();
@@ -225,9 +227,28 @@ QRect InputDevice::getTouchscreenGeometry() const
     return touchscreenGeometry_;
 }
 
+void InputDevice::setDisplayGeometry(const QRect& displayGeometry)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    displayGeometry_ = displayGeometry;
+}
+
+void InputDevice::onConfigurationChanged(const ChangedKeys&)
+{
+    // the key map and the view are only touched under the mutex, the same one the event filter holds
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    configurationView_.refresh();
+    keyMap_.reload(configurationView_.get());
+}
+
 IInputDevice::ButtonCodes InputDevice::getSupportedButtonCodes() const
 {
-    return configuration_->getButtonCodes();
+    return keyMap_.getSupportedButtonCodes();
+}
+
+bool InputDevice::isButtonCodeSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const
+{
+    return keyMap_.isSupported(buttonCode);
 }
 
 }
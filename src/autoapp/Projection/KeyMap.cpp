@@ -0,0 +1,231 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QKeySequence>
+#ifdef __linux__
+#include <linux/input.h>
+#endif
+#include <boost/lexical_cast.hpp>
+#include <f1x/openauto/autoapp/Projection/KeyMap.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+KeyMap::KeyMap()
+{
+    scanCodes_.fill({aasdk::proto::enums::ButtonCode::NONE, WheelDirection::NONE});
+}
+
+void KeyMap::load(const configuration::ConfigurationSnapshot& configuration)
+{
+    supported_.reset();
+    supportedButtonCodes_ = configuration.buttonCodes;
+
+    for(const auto& buttonCode : supportedButtonCodes_)
+    {
+        size_t index;
+        if(toBitIndex(buttonCode, index))
+        {
+            supported_.set(index);
+        }
+    }
+
+    this->reload(configuration);
+}
+
+void KeyMap::reload(const configuration::ConfigurationSnapshot& configuration)
+{
+    keys_.clear();
+    scanCodes_.fill({aasdk::proto::enums::ButtonCode::NONE, WheelDirection::NONE});
+
+    this->loadDefaults();
+    this->loadOverrides(configuration);
+    this->removeUnsupported();
+
+    OPENAUTO_LOG(info) << "[KeyMap] loaded, keys: " << keys_.size()
+                       << ", supported button codes: " << supportedButtonCodes_.size();
+}
+
+const KeyMap::Binding* KeyMap::findKey(int key) const
+{
+    const auto it = keys_.find(key);
+    return it != keys_.end() ? &it->second : nullptr;
+}
+
+const KeyMap::Binding* KeyMap::findScanCode(uint16_t scanCode) const
+{
+    if(scanCode < scanCodes_.size() && scanCodes_[scanCode].code != aasdk::proto::enums::ButtonCode::NONE)
+    {
+        return &scanCodes_[scanCode];
+    }
+
+    return nullptr;
+}
+
+bool KeyMap::isSupported(aasdk::proto::enums::ButtonCode::Enum buttonCode) const
+{
+    size_t index;
+    return toBitIndex(buttonCode, index) && supported_.test(index);
+}
+
+const IInputDevice::ButtonCodes& KeyMap::getSupportedButtonCodes() const
+{
+    return supportedButtonCodes_;
+}
+
+void KeyMap::loadDefaults()
+{
+    keys_[Qt::Key_Return] = {aasdk::proto::enums::ButtonCode::ENTER, WheelDirection::NONE};
+    keys_[Qt::Key_Enter] = {aasdk::proto::enums::ButtonCode::ENTER, WheelDirection::NONE};
+    keys_[Qt::Key_Left] = {aasdk::proto::enums::ButtonCode::LEFT, WheelDirection::NONE};
+    keys_[Qt::Key_Right] = {aasdk::proto::enums::ButtonCode::RIGHT, WheelDirection::NONE};
+    keys_[Qt::Key_Up] = {aasdk::proto::enums::ButtonCode::UP, WheelDirection::NONE};
+    keys_[Qt::Key_Down] = {aasdk::proto::enums::ButtonCode::DOWN, WheelDirection::NONE};
+    keys_[Qt::Key_Escape] = {aasdk::proto::enums::ButtonCode::BACK, WheelDirection::NONE};
+    keys_[Qt::Key_H] = {aasdk::proto::enums::ButtonCode::HOME, WheelDirection::NONE};
+    keys_[Qt::Key_P] = {aasdk::proto::enums::ButtonCode::PHONE, WheelDirection::NONE};
+    keys_[Qt::Key_O] = {aasdk::proto::enums::ButtonCode::CALL_END, WheelDirection::NONE};
+    keys_[Qt::Key_X] = {aasdk::proto::enums::ButtonCode::PLAY, WheelDirection::NONE};
+    keys_[Qt::Key_C] = {aasdk::proto::enums::ButtonCode::PAUSE, WheelDirection::NONE};
+    keys_[Qt::Key_MediaPrevious] = {aasdk::proto::enums::ButtonCode::PREV, WheelDirection::NONE};
+    keys_[Qt::Key_V] = {aasdk::proto::enums::ButtonCode::PREV, WheelDirection::NONE};
+    keys_[Qt::Key_MediaPlay] = {aasdk::proto::enums::ButtonCode::TOGGLE_PLAY, WheelDirection::NONE};
+    keys_[Qt::Key_B] = {aasdk::proto::enums::ButtonCode::TOGGLE_PLAY, WheelDirection::NONE};
+    keys_[Qt::Key_MediaNext] = {aasdk::proto::enums::ButtonCode::NEXT, WheelDirection::NONE};
+    keys_[Qt::Key_N] = {aasdk::proto::enums::ButtonCode::NEXT, WheelDirection::NONE};
+    keys_[Qt::Key_M] = {aasdk::proto::enums::ButtonCode::MICROPHONE_1, WheelDirection::NONE};
+    keys_[Qt::Key_1] = {aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, WheelDirection::LEFT};
+    keys_[Qt::Key_2] = {aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, WheelDirection::RIGHT};
+
+#ifdef __linux__
+    scanCodes_[KEY_ENTER] = {aasdk::proto::enums::ButtonCode::ENTER, WheelDirection::NONE};
+    scanCodes_[KEY_KPENTER] = {aasdk::proto::enums::ButtonCode::ENTER, WheelDirection::NONE};
+    scanCodes_[KEY_OK] = {aasdk::proto::enums::ButtonCode::ENTER, WheelDirection::NONE};
+    scanCodes_[KEY_LEFT] = {aasdk::proto::enums::ButtonCode::LEFT, WheelDirection::NONE};
+    scanCodes_[KEY_RIGHT] = {aasdk::proto::enums::ButtonCode::RIGHT, WheelDirection::NONE};
+    scanCodes_[KEY_UP] = {aasdk::proto::enums::ButtonCode::UP, WheelDirection::NONE};
+    scanCodes_[KEY_DOWN] = {aasdk::proto::enums::ButtonCode::DOWN, WheelDirection::NONE};
+    scanCodes_[KEY_ESC] = {aasdk::proto::enums::ButtonCode::BACK, WheelDirection::NONE};
+    scanCodes_[KEY_BACK] = {aasdk::proto::enums::ButtonCode::BACK, WheelDirection::NONE};
+    scanCodes_[KEY_H] = {aasdk::proto::enums::ButtonCode::HOME, WheelDirection::NONE};
+    scanCodes_[KEY_HOMEPAGE] = {aasdk::proto::enums::ButtonCode::HOME, WheelDirection::NONE};
+    scanCodes_[KEY_P] = {aasdk::proto::enums::ButtonCode::PHONE, WheelDirection::NONE};
+    scanCodes_[KEY_PHONE] = {aasdk::proto::enums::ButtonCode::PHONE, WheelDirection::NONE};
+    scanCodes_[KEY_O] = {aasdk::proto::enums::ButtonCode::CALL_END, WheelDirection::NONE};
+    scanCodes_[KEY_X] = {aasdk::proto::enums::ButtonCode::PLAY, WheelDirection::NONE};
+    scanCodes_[KEY_PLAYCD] = {aasdk::proto::enums::ButtonCode::PLAY, WheelDirection::NONE};
+    scanCodes_[KEY_C] = {aasdk::proto::enums::ButtonCode::PAUSE, WheelDirection::NONE};
+    scanCodes_[KEY_PAUSECD] = {aasdk::proto::enums::ButtonCode::PAUSE, WheelDirection::NONE};
+    scanCodes_[KEY_V] = {aasdk::proto::enums::ButtonCode::PREV, WheelDirection::NONE};
+    scanCodes_[KEY_PREVIOUSSONG] = {aasdk::proto::enums::ButtonCode::PREV, WheelDirection::NONE};
+    scanCodes_[KEY_B] = {aasdk::proto::enums::ButtonCode::TOGGLE_PLAY, WheelDirection::NONE};
+    scanCodes_[KEY_PLAYPAUSE] = {aasdk::proto::enums::ButtonCode::TOGGLE_PLAY, WheelDirection::NONE};
+    scanCodes_[KEY_N] = {aasdk::proto::enums::ButtonCode::NEXT, WheelDirection::NONE};
+    scanCodes_[KEY_NEXTSONG] = {aasdk::proto::enums::ButtonCode::NEXT, WheelDirection::NONE};
+    scanCodes_[KEY_M] = {aasdk::proto::enums::ButtonCode::MICROPHONE_1, WheelDirection::NONE};
+    scanCodes_[KEY_MICMUTE] = {aasdk::proto::enums::ButtonCode::MICROPHONE_1, WheelDirection::NONE};
+    scanCodes_[KEY_1] = {aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, WheelDirection::LEFT};
+    scanCodes_[KEY_2] = {aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, WheelDirection::RIGHT};
+#endif
+}
+
+void KeyMap::loadOverrides(const configuration::ConfigurationSnapshot& configuration)
+{
+    for(const auto& keyBinding : configuration.keyBindings)
+    {
+        const auto sequence = QKeySequence::fromString(QString::fromStdString(keyBinding.first), QKeySequence::PortableText);
+        Binding binding;
+
+        if(sequence.count() != 1 || !parseBinding(keyBinding.second, binding))
+        {
+            OPENAUTO_LOG(warning) << "[KeyMap] invalid key binding: " << keyBinding.first << " = " << keyBinding.second;
+            continue;
+        }
+
+        keys_[sequence[0]] = binding;
+    }
+
+    for(const auto& scanCodeBinding : configuration.scanCodeBindings)
+    {
+        Binding binding;
+        uint16_t scanCode;
+
+        if(!boost::conversion::try_lexical_convert(scanCodeBinding.first, scanCode) || scanCode >= scanCodes_.size() || !parseBinding(scanCodeBinding.second, binding))
+        {
+            OPENAUTO_LOG(warning) << "[KeyMap] invalid scan code binding: " << scanCodeBinding.first << " = " << scanCodeBinding.second;
+            continue;
+        }
+
+        scanCodes_[scanCode] = binding;
+    }
+}
+
+void KeyMap::removeUnsupported()
+{
+    for(auto it = keys_.begin(); it != keys_.end();)
+    {
+        it = this->isSupported(it->second.code) ? std::next(it) : keys_.erase(it);
+    }
+
+    for(auto& binding : scanCodes_)
+    {
+        if(!this->isSupported(binding.code))
+        {
+            binding = {aasdk::proto::enums::ButtonCode::NONE, WheelDirection::NONE};
+        }
+    }
+}
+
+bool KeyMap::parseBinding(const std::string& value, Binding& binding)
+{
+    // the wheel needs a direction, every other value is a button code name, NONE removes a default binding
+    if(value == "WHEEL_LEFT" || value == "WHEEL_RIGHT")
+    {
+        binding = {aasdk::proto::enums::ButtonCode::SCROLL_WHEEL, value == "WHEEL_LEFT" ? WheelDirection::LEFT : WheelDirection::RIGHT};
+        return true;
+    }
+
+    binding.wheelDirection = WheelDirection::NONE;
+    return aasdk::proto::enums::ButtonCode::Enum_Parse(value, &binding.code) && binding.code != aasdk::proto::enums::ButtonCode::SCROLL_WHEEL;
+}
+
+bool KeyMap::toBitIndex(aasdk::proto::enums::ButtonCode::Enum buttonCode, size_t& index)
+{
+    // key codes live below 0x100, the extended codes (SCROLL_WHEEL, MEDIA, ...) start at 0x10000
+    const uint32_t code = static_cast<uint32_t>(buttonCode);
+
+    if(code == aasdk::proto::enums::ButtonCode::NONE || (code & 0xFFFEFF00) != 0)
+    {
+        return false;
+    }
+
+    index = (code & 0xFF) | ((code >> 8) & 0x100);
+    return true;
+}
+
+}
+}
+}
+}
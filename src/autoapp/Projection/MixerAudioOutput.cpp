@@ -0,0 +1,90 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/Projection/MixerAudioOutput.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+MixerAudioOutput::MixerAudioOutput(AudioMixer::Pointer audioMixer, AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, float gain)
+    : audioMixer_(std::move(audioMixer))
+    , channelCount_(channelCount)
+    , sampleSize_(sampleSize)
+    , sampleRate_(sampleRate)
+    , gain_(gain)
+    , channelId_(audioMixer_->addChannel(type, channelCount, sampleRate, gain))
+{
+
+}
+
+bool MixerAudioOutput::open()
+{
+    return audioMixer_->open();
+}
+
+void MixerAudioOutput::write(aasdk::messenger::Timestamp::ValueType, const aasdk::common::DataConstBuffer& buffer)
+{
+    const auto frameSize = (sampleSize_ / 8) * channelCount_;
+    audioMixer_->write(channelId_, reinterpret_cast<const int16_t*>(buffer.cdata), buffer.size / frameSize);
+}
+
+void MixerAudioOutput::start()
+{
+    audioMixer_->start(channelId_);
+}
+
+void MixerAudioOutput::stop()
+{
+    audioMixer_->stop(channelId_);
+}
+
+void MixerAudioOutput::suspend()
+{
+    audioMixer_->suspend(channelId_);
+}
+
+void MixerAudioOutput::setGain(float gain)
+{
+    audioMixer_->setGain(channelId_, gain_ * gain);
+}
+
+uint32_t MixerAudioOutput::getSampleSize() const
+{
+    return sampleSize_;
+}
+
+uint32_t MixerAudioOutput::getChannelCount() const
+{
+    return channelCount_;
+}
+
+uint32_t MixerAudioOutput::getSampleRate() const
+{
+    return sampleRate_;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,170 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/NalParser.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OPENAUTO_NAL_NEON
+#endif
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr uint8_t NalParser::cNalSlice;
+constexpr uint8_t NalParser::cNalIDR;
+constexpr uint8_t NalParser::cNalSEI;
+constexpr uint8_t NalParser::cNalSPS;
+constexpr uint8_t NalParser::cNalPPS;
+constexpr uint8_t NalParser::cNalAUD;
+
+void NalParser::parse(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer, AccessUnits& accessUnits)
+{
+    const uint8_t* end = buffer.cdata + buffer.size;
+    const uint8_t* accessUnitBegin = buffer.cdata;
+
+    AccessUnit accessUnit{aasdk::common::DataConstBuffer(), timestamp, false, false, false, false, false, false};
+    const uint8_t* startCode = findStartCode(buffer.cdata, end);
+
+    // Only zero padding may precede the first start code.
+    accessUnit.hasError = std::any_of(buffer.cdata, startCode, [](uint8_t value) { return value != 0; });
+
+    while(startCode + 3 < end)
+    {
+        const uint8_t* nal = startCode + 3;
+        const uint8_t nalType = nal[0] & 0x1F;
+
+        if(accessUnit.hasSlice && startsAccessUnit(nalType, nal, end))
+        {
+            // a zero in front of the start code is its four byte form and belongs to the next unit
+            const uint8_t* boundary = startCode > accessUnitBegin && startCode[-1] == 0 ? startCode - 1 : startCode;
+            accessUnit.buffer = aasdk::common::DataConstBuffer(accessUnitBegin, boundary - accessUnitBegin);
+            accessUnits.push_back(accessUnit);
+
+            accessUnitBegin = boundary;
+            accessUnit = AccessUnit{aasdk::common::DataConstBuffer(), timestamp, false, false, false, false, false, false};
+        }
+
+        accessUnit.hasError = accessUnit.hasError || (nal[0] & 0x80) != 0;
+
+        if(nalType >= cNalSlice && nalType <= cNalIDR)
+        {
+            accessUnit.hasSlice = true;
+            accessUnit.isIDR = accessUnit.isIDR || nalType == cNalIDR;
+            accessUnit.isReference = accessUnit.isReference || (nal[0] & 0x60) != 0;
+        }
+        else if(nalType == cNalSPS)
+        {
+            accessUnit.hasSPS = true;
+        }
+        else if(nalType == cNalPPS)
+        {
+            accessUnit.hasPPS = true;
+        }
+
+        startCode = findStartCode(nal + 1, end);
+    }
+
+    if(end > accessUnitBegin)
+    {
+        accessUnit.buffer = aasdk::common::DataConstBuffer(accessUnitBegin, end - accessUnitBegin);
+        accessUnits.push_back(accessUnit);
+    }
+}
+
+const uint8_t* NalParser::findStartCode(const uint8_t* begin, const uint8_t* end)
+{
+    const uint8_t* current = begin;
+
+    // Compares 16 positions at once for 00 00 01 using three shifted loads,
+    // so every hit is exact and no candidate has to be re-checked.
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+
+    for(; current + 18 <= end; current += 16)
+    {
+        const __m128i first = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(current)), zero);
+        const __m128i second = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(current + 1)), zero);
+        const __m128i third = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(current + 2)), one);
+        const int mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(first, second), third));
+
+        if(mask != 0)
+        {
+            return current + __builtin_ctz(mask);
+        }
+    }
+#elif defined(OPENAUTO_NAL_NEON)
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+
+    for(; current + 18 <= end; current += 16)
+    {
+        const uint8x16_t first = vceqq_u8(vld1q_u8(current), zero);
+        const uint8x16_t second = vceqq_u8(vld1q_u8(current + 1), zero);
+        const uint8x16_t third = vceqq_u8(vld1q_u8(current + 2), one);
+        const uint64x2_t match = vreinterpretq_u64_u8(vandq_u8(vandq_u8(first, second), third));
+
+        if((vgetq_lane_u64(match, 0) | vgetq_lane_u64(match, 1)) != 0)
+        {
+            break;
+        }
+    }
+#endif
+
+    return findStartCodeScalar(current, end);
+}
+
+const uint8_t* NalParser::findStartCodeScalar(const uint8_t* begin, const uint8_t* end)
+{
+    for(const uint8_t* current = begin; current + 3 <= end; ++current)
+    {
+        if(current[2] == 1 && current[1] == 0 && current[0] == 0)
+        {
+            return current;
+        }
+    }
+
+    return end;
+}
+
+bool NalParser::startsAccessUnit(uint8_t nalType, const uint8_t* nal, const uint8_t* end)
+{
+    // H.264 7.4.1.2.3: after a slice, a new access unit begins with an AUD, SEI or parameter set,
+    // with NAL types 14 to 18, or with a slice whose first_mb_in_slice is 0 (its first ue(v) bit set).
+    if((nalType >= cNalSEI && nalType <= cNalAUD) || (nalType >= 14 && nalType <= 18))
+    {
+        return true;
+    }
+
+    return nalType >= cNalSlice && nalType <= cNalIDR && nal + 1 < end && (nal[1] & 0x80) != 0;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,166 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <f1x/openauto/autoapp/Projection/NightSensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProviderEventHandler.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr uint32_t NightSensorProvider::cPollInterval;
+
+NightSensorProvider::NightSensorProvider(boost::asio::io_service& ioService, std::string lightSensorPath)
+    : strand_(ioService)
+    , timer_(ioService)
+    , lightSensorPath_(std::move(lightSensorPath))
+    , eventHandler_(nullptr)
+    , reported_(false)
+    , isNight_(false)
+    , hasLocation_(false)
+    , latitude_(0.0)
+    , longitude_(0.0)
+{
+
+}
+
+void NightSensorProvider::start(ISensorProviderEventHandler& eventHandler)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), eventHandler = &eventHandler]() {
+        OPENAUTO_LOG(info) << "[NightSensorProvider] start, light sensor: " << (lightSensorPath_.empty() ? "none" : lightSensorPath_);
+        eventHandler_ = eventHandler;
+        reported_ = false;
+        this->evaluate();
+        this->schedule();
+    });
+}
+
+void NightSensorProvider::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[NightSensorProvider] stop.";
+        eventHandler_ = nullptr;
+        timer_.cancel();
+    });
+}
+
+bool NightSensorProvider::isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const
+{
+    return sensorType == aasdk::proto::enums::SensorType::NIGHT_DATA;
+}
+
+void NightSensorProvider::updateLocation(const LocationData& location)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), location]() {
+        hasLocation_ = true;
+        latitude_ = location.latitude / 1e7;
+        longitude_ = location.longitude / 1e7;
+    });
+}
+
+void NightSensorProvider::schedule()
+{
+    timer_.expires_from_now(boost::posix_time::milliseconds(cPollInterval));
+    timer_.async_wait(strand_.wrap(std::bind(&NightSensorProvider::onTimer, this->shared_from_this(), std::placeholders::_1)));
+}
+
+void NightSensorProvider::onTimer(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted && eventHandler_ != nullptr)
+    {
+        this->evaluate();
+        this->schedule();
+    }
+}
+
+void NightSensorProvider::evaluate()
+{
+    bool isNight = isNight_;
+    double illuminance = 0.0;
+    const std::time_t now = std::time(nullptr);
+
+    if(this->readIlluminance(illuminance))
+    {
+        // hysteresis keeps passing street lights and shadows from toggling the theme
+        isNight = isNight_ ? illuminance < cDayIlluminance : illuminance < cNightIlluminance;
+    }
+    else if(hasLocation_)
+    {
+        isNight = getSunElevation(now, latitude_, longitude_) < cSunsetElevation;
+    }
+    else
+    {
+        std::tm local = {};
+        localtime_r(&now, &local);
+        isNight = local.tm_hour < cDayStartHour || local.tm_hour >= cDayEndHour;
+    }
+
+    if(!reported_ || isNight != isNight_)
+    {
+        OPENAUTO_LOG(info) << "[NightSensorProvider] night mode: " << isNight;
+        reported_ = true;
+        isNight_ = isNight;
+        eventHandler_->onNightModeUpdate(isNight_);
+    }
+}
+
+bool NightSensorProvider::readIlluminance(double& illuminance) const
+{
+    if(lightSensorPath_.empty())
+    {
+        return false;
+    }
+
+    std::ifstream stream(lightSensorPath_);
+    return static_cast<bool>(stream >> illuminance);
+}
+
+double NightSensorProvider::getSunElevation(std::time_t time, double latitude, double longitude)
+{
+    // low precision solar position (Astronomical Almanac), good to about 0.01 degree for this century
+    const double toRadians = M_PI / 180.0;
+    const double days = time / 86400.0 - 10957.5;
+
+    const double meanAnomaly = (357.529 + 0.98560028 * days) * toRadians;
+    const double meanLongitude = 280.459 + 0.98564736 * days;
+    const double eclipticLongitude = (meanLongitude + 1.915 * std::sin(meanAnomaly) + 0.020 * std::sin(2.0 * meanAnomaly)) * toRadians;
+    const double obliquity = (23.439 - 0.00000036 * days) * toRadians;
+
+    const double declination = std::asin(std::sin(obliquity) * std::sin(eclipticLongitude));
+    const double rightAscension = std::atan2(std::cos(obliquity) * std::sin(eclipticLongitude), std::cos(eclipticLongitude));
+    const double siderealTime = (280.46061837 + 360.98564736629 * days + longitude) * toRadians;
+    const double hourAngle = siderealTime - rightAscension;
+
+    const double elevation = std::asin(std::sin(latitude * toRadians) * std::sin(declination)
+                                       + std::cos(latitude * toRadians) * std::cos(declination) * std::cos(hourAngle));
+    return elevation / toRadians;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,341 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <boost/algorithm/string.hpp>
+#include <f1x/openauto/autoapp/Projection/NmeaSensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/ISensorProviderEventHandler.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr uint32_t NmeaSensorProvider::cReconnectInterval;
+constexpr size_t NmeaSensorProvider::cMaxSentenceSize;
+
+NmeaSensorProvider::NmeaSensorProvider(boost::asio::io_service& ioService, std::string source)
+    : strand_(ioService)
+    , resolver_(ioService)
+    , socket_(ioService)
+    , descriptor_(ioService)
+    , reconnectTimer_(ioService)
+    , buffer_(cMaxSentenceSize * 16)
+    , source_(std::move(source))
+    , eventHandler_(nullptr)
+    , altitude_(0)
+    , accuracy_(0)
+{
+
+}
+
+void NmeaSensorProvider::start(ISensorProviderEventHandler& eventHandler)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), eventHandler = &eventHandler]() {
+        OPENAUTO_LOG(info) << "[NmeaSensorProvider] start, source: " << source_;
+        eventHandler_ = eventHandler;
+        this->open();
+    });
+}
+
+void NmeaSensorProvider::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[NmeaSensorProvider] stop.";
+        eventHandler_ = nullptr;
+
+        boost::system::error_code ec;
+        resolver_.cancel();
+        reconnectTimer_.cancel();
+        socket_.close(ec);
+        descriptor_.close(ec);
+    });
+}
+
+bool NmeaSensorProvider::isSensorSupported(aasdk::proto::enums::SensorType::Enum sensorType) const
+{
+    return sensorType == aasdk::proto::enums::SensorType::LOCATION;
+}
+
+void NmeaSensorProvider::updateLocation(const LocationData&)
+{
+
+}
+
+void NmeaSensorProvider::open()
+{
+    buffer_.consume(buffer_.size());
+
+    // anything that is not an absolute path and carries a port is a network endpoint
+    const auto separator = source_.rfind(':');
+    if(!source_.empty() && source_.front() != '/' && separator != std::string::npos)
+    {
+        this->openSocket(source_.substr(0, separator), source_.substr(separator + 1));
+    }
+    else
+    {
+        this->openDevice();
+    }
+}
+
+void NmeaSensorProvider::openSocket(const std::string& host, const std::string& port)
+{
+    resolver_.async_resolve(boost::asio::ip::tcp::resolver::query(host, port),
+                            strand_.wrap([this, self = this->shared_from_this()](const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoints) {
+        if(error)
+        {
+            this->onError("resolve", error);
+            return;
+        }
+
+        boost::asio::async_connect(socket_, endpoints, strand_.wrap([this, self = this->shared_from_this()](const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator) {
+            if(error)
+            {
+                this->onError("connect", error);
+                return;
+            }
+
+            // gpsd stays silent until a client asks for a watch, plain NMEA relays ignore the request
+            static const std::string watchRequest = "?WATCH={\"enable\":true,\"nmea\":true};\n";
+            boost::asio::async_write(socket_, boost::asio::buffer(watchRequest), strand_.wrap([this, self = this->shared_from_this()](const boost::system::error_code& error, size_t) {
+                if(error)
+                {
+                    this->onError("write", error);
+                    return;
+                }
+
+                this->read();
+            }));
+        }));
+    }));
+}
+
+void NmeaSensorProvider::openDevice()
+{
+    const int fd = ::open(source_.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK);
+
+    if(fd < 0)
+    {
+        this->onError("open", boost::system::error_code(errno, boost::system::system_category()));
+        return;
+    }
+
+    descriptor_.assign(fd);
+    this->read();
+}
+
+void NmeaSensorProvider::read()
+{
+    auto handler = strand_.wrap(std::bind(&NmeaSensorProvider::onRead, this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+
+    if(socket_.is_open())
+    {
+        boost::asio::async_read_until(socket_, buffer_, '\n', std::move(handler));
+    }
+    else
+    {
+        boost::asio::async_read_until(descriptor_, buffer_, '\n', std::move(handler));
+    }
+}
+
+void NmeaSensorProvider::onRead(const boost::system::error_code& error, size_t bytesTransferred)
+{
+    if(eventHandler_ == nullptr || error == boost::asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    if(error)
+    {
+        this->onError("read", error);
+        return;
+    }
+
+    std::string sentence(boost::asio::buffers_begin(buffer_.data()), boost::asio::buffers_begin(buffer_.data()) + bytesTransferred);
+    buffer_.consume(bytesTransferred);
+    boost::algorithm::trim_right(sentence);
+
+    if(sentence.size() <= cMaxSentenceSize)
+    {
+        this->handleSentence(sentence);
+    }
+
+    this->read();
+}
+
+void NmeaSensorProvider::onError(const std::string& what, const boost::system::error_code& error)
+{
+    OPENAUTO_LOG(error) << "[NmeaSensorProvider] " << what << " failed, source: " << source_ << ", error: " << error.message();
+
+    boost::system::error_code ec;
+    socket_.close(ec);
+    descriptor_.close(ec);
+    this->scheduleReconnect();
+}
+
+void NmeaSensorProvider::scheduleReconnect()
+{
+    if(eventHandler_ == nullptr)
+    {
+        return;
+    }
+
+    reconnectTimer_.expires_from_now(boost::posix_time::milliseconds(cReconnectInterval));
+    reconnectTimer_.async_wait(strand_.wrap([this, self = this->shared_from_this()](const boost::system::error_code& error) {
+        if(!error && eventHandler_ != nullptr)
+        {
+            this->open();
+        }
+    }));
+}
+
+void NmeaSensorProvider::handleSentence(const std::string& sentence)
+{
+    if(sentence.size() < 7 || sentence[0] != '$' || !verifyChecksum(sentence))
+    {
+        return;
+    }
+
+    // the talker id (GP, GN, GL, ...) is ignored, only the sentence type matters
+    const auto body = sentence.substr(1, sentence.find('*') - 1);
+    boost::split(fields_, body, boost::is_any_of(","));
+
+    if(fields_[0].size() != 5)
+    {
+        return;
+    }
+
+    const auto type = fields_[0].substr(2);
+    if(type == "RMC")
+    {
+        this->handleRMC();
+    }
+    else if(type == "GGA")
+    {
+        this->handleGGA();
+    }
+}
+
+void NmeaSensorProvider::handleRMC()
+{
+    // $xxRMC,time,status,lat,N/S,lon,E/W,speed over ground [kn],course [deg],date,...
+    if(fields_.size() < 10 || fields_[2] != "A")
+    {
+        return;
+    }
+
+    LocationData location;
+    if(!parseCoordinate(fields_[3], fields_[4], location.latitude) || !parseCoordinate(fields_[5], fields_[6], location.longitude))
+    {
+        return;
+    }
+
+    if(!parseTimestamp(fields_[1], fields_[9], location.timestamp))
+    {
+        location.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    location.accuracy = accuracy_;
+    location.altitude = altitude_;
+    location.speed = static_cast<int32_t>(std::lround(std::strtod(fields_[7].c_str(), nullptr) * 514.444));
+    location.bearing = static_cast<int32_t>(std::lround(std::strtod(fields_[8].c_str(), nullptr) * 1e6));
+
+    eventHandler_->onLocationUpdate(location);
+}
+
+void NmeaSensorProvider::handleGGA()
+{
+    // $xxGGA,time,lat,N/S,lon,E/W,fix quality,satellites,HDOP,altitude,M,...
+    if(fields_.size() < 10 || fields_[6].empty() || fields_[6] == "0")
+    {
+        return;
+    }
+
+    accuracy_ = static_cast<uint32_t>(std::lround(std::strtod(fields_[8].c_str(), nullptr) * cRangeError * 1000.0));
+    altitude_ = static_cast<int32_t>(std::lround(std::strtod(fields_[9].c_str(), nullptr) * 100.0));
+}
+
+bool NmeaSensorProvider::verifyChecksum(const std::string& sentence)
+{
+    const auto asterisk = sentence.find('*');
+    if(asterisk == std::string::npos || asterisk + 3 > sentence.size())
+    {
+        return false;
+    }
+
+    uint8_t checksum = 0;
+    for(size_t i = 1; i < asterisk; ++i)
+    {
+        checksum ^= static_cast<uint8_t>(sentence[i]);
+    }
+
+    return checksum == std::strtoul(sentence.substr(asterisk + 1, 2).c_str(), nullptr, 16);
+}
+
+bool NmeaSensorProvider::parseCoordinate(const std::string& value, const std::string& hemisphere, int32_t& coordinate)
+{
+    if(value.empty() || hemisphere.empty())
+    {
+        return false;
+    }
+
+    // (d)ddmm.mmmm
+    const double raw = std::strtod(value.c_str(), nullptr);
+    const double degrees = std::floor(raw / 100.0);
+    const double result = degrees + (raw - degrees * 100.0) / 60.0;
+
+    coordinate = static_cast<int32_t>(std::lround((hemisphere == "S" || hemisphere == "W" ? -result : result) * 1e7));
+    return true;
+}
+
+bool NmeaSensorProvider::parseTimestamp(const std::string& time, const std::string& date, uint64_t& timestamp)
+{
+    const auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    if(time.size() < 6 || date.size() != 6 || !std::all_of(time.begin(), time.begin() + 6, isDigit) || !std::all_of(date.begin(), date.end(), isDigit))
+    {
+        return false;
+    }
+
+    // hhmmss.sss and ddmmyy, both UTC
+    std::tm utc = {};
+    utc.tm_hour = std::stoi(time.substr(0, 2));
+    utc.tm_min = std::stoi(time.substr(2, 2));
+    utc.tm_sec = std::stoi(time.substr(4, 2));
+    utc.tm_mday = std::stoi(date.substr(0, 2));
+    utc.tm_mon = std::stoi(date.substr(2, 2)) - 1;
+    const int year = std::stoi(date.substr(4, 2));
+    utc.tm_year = year < 80 ? year + 100 : year;
+
+    const double fraction = time.size() > 6 ? std::strtod(time.c_str() + 6, nullptr) : 0.0;
+    timestamp = static_cast<uint64_t>(timegm(&utc)) * 1000 + static_cast<uint64_t>(std::lround(fraction * 1000.0));
+    return true;
+}
+
+}
+}
+}
+}
@@ -48,6 +48,8 @@ OMXVideoOutput::OMXVideoOutput(configuration::IConfiguration::Pointer configurat
     : VideoOutput(std::move(configuration))
     , isActive_(false)
     , portSettingsChanged_(false)
+    , dataLost_(false)
+    , decodeErrorsCount_(0)
     , client_(nullptr)
 {
     memset(components_, 0, sizeof(components_));
@@ -74,6 +76,8 @@ bool OMXVideoOutput::open()
         return false;
     }
 
+    ilclient_set_error_callback(client_, &OMXVideoOutput::onComponentError, this);
+
     if(!this->createComponents())
     {
         return false;
@@ -127,6 +131,7 @@ void OMXVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuf
     std::lock_guard<decltype(mutex_)> lock(mutex_);
 
     size_t writeSize = 0;
+    bool failed = false;
 
     while(isActive_ && writeSize < buffer.size)
     {
@@ -134,6 +139,7 @@ void OMXVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuf
 
         if(buf == nullptr)
         {
+            failed = true;
             break;
         }
         else
@@ -157,12 +163,14 @@ void OMXVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuf
 
                 if(ilclient_setup_tunnel(&tunnels_[0], 0, 0) != 0)
                 {
+                    failed = true;
                     break;
                 }
 
                 ilclient_change_component_state(components_[VideoComponent::SCHEDULER], OMX_StateExecuting);
                 if(ilclient_setup_tunnel(&tunnels_[1], 0, 1000) != 0)
                 {
+                    failed = true;
                     break;
                 }
 
@@ -171,10 +179,36 @@ void OMXVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuf
 
             if(OMX_EmptyThisBuffer(ILC_GET_HANDLE(components_[VideoComponent::DECODER]), buf) != OMX_ErrorNone)
             {
+                failed = true;
                 break;
             }
         }
     }
+
+    // A frame that did not make it to the decoder in full leaves it without a valid reference.
+    dataLost_ = failed;
+}
+
+float OMXVideoOutput::getBacklog() const
+{
+    return dataLost_ ? 1.0f : 0.0f;
+}
+
+uint64_t OMXVideoOutput::getDecodeErrorsCount() const
+{
+    return decodeErrorsCount_;
+}
+
+void OMXVideoOutput::onComponentError(void* userData, COMPONENT_T* component, OMX_U32 data)
+{
+    auto self = static_cast<OMXVideoOutput*>(userData);
+
+    // state transitions report OMX_ErrorSameState routinely, it says nothing about the stream
+    if(component == self->components_[VideoComponent::DECODER] && data != static_cast<OMX_U32>(OMX_ErrorSameState))
+    {
+        OPENAUTO_LOG(error) << "[OMXVideoOutput] decoder error: " << std::hex << data << std::dec;
+        ++self->decodeErrorsCount_;
+    }
 }
 
 void OMXVideoOutput::stop()
@@ -202,6 +236,12 @@ void OMXVideoOutput::stop()
     }
 }
 
+uint64_t OMXVideoOutput::getDecodePixelRate() const
+{
+    // VideoCore IV decodes H.264 in hardware up to 1080p30, independently of the CPU.
+    return 1920 * 1080 * 30;
+}
+
 bool OMXVideoOutput::createComponents()
 {
     if(ilclient_create_component(client_, &components_[VideoComponent::DECODER], "video_decode", static_cast<ILCLIENT_CREATE_FLAGS_T>(ILCLIENT_DISABLE_ALL_PORTS | ILCLIENT_ENABLE_INPUT_BUFFERS)) != 0)
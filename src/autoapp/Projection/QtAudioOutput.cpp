@@ -29,8 +29,11 @@ namespace autoapp
 namespace projection
 {
 
-QtAudioOutput::QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate)
-    : playbackStarted_(false)
+QtAudioOutput::QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference)
+    : resamplerQuality_(resamplerQuality)
+    , echoReference_(std::move(echoReference))
+    , echoReferenceSourceId_(echoReference_ != nullptr ? echoReference_->addSource() : 0)
+    , playbackStarted_(false)
 {
     audioFormat_.setChannelCount(channelCount);
     audioFormat_.setSampleRate(sampleRate);
@@ -43,6 +46,7 @@ QtAudioOutput::QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_
     connect(this, &QtAudioOutput::startPlayback, this, &QtAudioOutput::onStartPlayback);
     connect(this, &QtAudioOutput::suspendPlayback, this, &QtAudioOutput::onSuspendPlayback);
     connect(this, &QtAudioOutput::stopPlayback, this, &QtAudioOutput::onStopPlayback);
+    connect(this, &QtAudioOutput::volumeChanged, this, &QtAudioOutput::onVolumeChanged);
 
     QMetaObject::invokeMethod(this, "createAudioOutput", Qt::BlockingQueuedConnection);
 }
@@ -50,7 +54,33 @@ QtAudioOutput::QtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_
 void QtAudioOutput::createAudioOutput()
 {
     OPENAUTO_LOG(debug) << "[QtAudioOutput] create.";
-    audioOutput_ = std::make_unique<QAudioOutput>(QAudioDeviceInfo::defaultOutputDevice(), audioFormat_);
+
+    const auto deviceInfo = QAudioDeviceInfo::defaultOutputDevice();
+    auto deviceFormat = audioFormat_;
+
+    if(!deviceInfo.isFormatSupported(audioFormat_) && !deviceInfo.isNull())
+    {
+        const auto nearestFormat = deviceInfo.nearestFormat(audioFormat_);
+
+        if(nearestFormat.sampleRate() != audioFormat_.sampleRate())
+        {
+            OPENAUTO_LOG(info) << "[QtAudioOutput] Device does not support " << audioFormat_.sampleRate() << " Hz, resampling to " << nearestFormat.sampleRate() << " Hz.";
+            deviceFormat.setSampleRate(nearestFormat.sampleRate());
+            resampler_ = std::make_unique<Resampler>(audioFormat_.sampleRate(), deviceFormat.sampleRate(), audioFormat_.channelCount(), resamplerQuality_);
+        }
+    }
+
+    audioOutput_ = std::make_unique<QAudioOutput>(deviceInfo, deviceFormat);
+
+    if(echoReference_ != nullptr)
+    {
+        // QAudioOutput pulls from the buffer when it feeds the device, which is as close to the playout as Qt gets
+        const auto channelCount = deviceFormat.channelCount();
+        const auto sampleRate = deviceFormat.sampleRate();
+        audioBuffer_.setReadHandler([this, channelCount, sampleRate](const char* data, size_t size) {
+            echoReference_->write(echoReferenceSourceId_, reinterpret_cast<const int16_t*>(data), size / (sizeof(int16_t) * channelCount), channelCount, sampleRate);
+        });
+    }
 }
 
 bool QtAudioOutput::open()
@@ -60,7 +90,16 @@ bool QtAudioOutput::open()
 
 void QtAudioOutput::write(aasdk::messenger::Timestamp::ValueType, const aasdk::common::DataConstBuffer& buffer)
 {
-    audioBuffer_.write(reinterpret_cast<const char*>(buffer.cdata), buffer.size);
+    if(resampler_ != nullptr)
+    {
+        resampled_.clear();
+        resampler_->process(reinterpret_cast<const int16_t*>(buffer.cdata), buffer.size / (sizeof(int16_t) * audioFormat_.channelCount()), resampled_);
+        audioBuffer_.write(reinterpret_cast<const char*>(resampled_.data()), resampled_.size() * sizeof(int16_t));
+    }
+    else
+    {
+        audioBuffer_.write(reinterpret_cast<const char*>(buffer.cdata), buffer.size);
+    }
 }
 
 void QtAudioOutput::start()
@@ -78,6 +117,11 @@ void QtAudioOutput::suspend()
     emit suspendPlayback();
 }
 
+void QtAudioOutput::setGain(float gain)
+{
+    emit volumeChanged(gain);
+}
+
 uint32_t QtAudioOutput::getSampleSize() const
 {
     return audioFormat_.sampleSize();
@@ -93,11 +137,24 @@ uint32_t QtAudioOutput::getSampleRate() const
     return audioFormat_.sampleRate();
 }
 
+void QtAudioOutput::setSource(IAudioSource::Pointer source)
+{
+    // with a source QAudioOutput pulls from it instead of the buffer filled by write()
+    source_ = source;
+}
+
 void QtAudioOutput::onStartPlayback()
 {
     if(!playbackStarted_)
     {
-        audioOutput_->start(&audioBuffer_);
+        if(!source_.expired() && sourceDevice_ == nullptr)
+        {
+            const auto deviceFormat = audioOutput_->format();
+            sourceDevice_ = std::make_unique<AudioSourceDevice>(std::make_unique<AudioSourceReader>(source_, deviceFormat.sampleRate(), resamplerQuality_), deviceFormat.channelCount());
+            sourceDevice_->open(QIODevice::ReadOnly);
+        }
+
+        audioOutput_->start(sourceDevice_ != nullptr ? static_cast<QIODevice*>(sourceDevice_.get()) : &audioBuffer_);
         playbackStarted_ = true;
     }
     else
@@ -111,6 +168,11 @@ void QtAudioOutput::onSuspendPlayback()
     audioOutput_->suspend();
 }
 
+void QtAudioOutput::onVolumeChanged(qreal volume)
+{
+    audioOutput_->setVolume(volume);
+}
+
 void QtAudioOutput::onStopPlayback()
 {
     if(playbackStarted_)
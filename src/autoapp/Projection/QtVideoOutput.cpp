@@ -29,8 +29,12 @@ namespace autoapp
 namespace projection
 {
 
+constexpr size_t QtVideoOutput::cMaxBacklog;
+
 QtVideoOutput::QtVideoOutput(configuration::IConfiguration::Pointer configuration)
     : VideoOutput(std::move(configuration))
+    , videoBuffer_(SequentialBuffer::OverflowPolicy::REFUSE_WRITE)
+    , decodeErrorsCount_(0)
 {
     this->moveToThread(QApplication::instance()->thread());
     connect(this, &QtVideoOutput::startPlayback, this, &QtVideoOutput::onStartPlayback, Qt::QueuedConnection);
@@ -44,6 +48,7 @@ void QtVideoOutput::createVideoOutput()
     OPENAUTO_LOG(debug) << "[QtVideoOutput] create.";
     videoWidget_ = std::make_unique<QVideoWidget>();
     mediaPlayer_ = std::make_unique<QMediaPlayer>(nullptr, QMediaPlayer::StreamPlayback);
+    connect(mediaPlayer_.get(), static_cast<void(QMediaPlayer::*)(QMediaPlayer::Error)>(&QMediaPlayer::error), this, &QtVideoOutput::onMediaPlayerError);
 }
 
 
@@ -68,9 +73,26 @@ void QtVideoOutput::write(uint64_t, const aasdk::common::DataConstBuffer& buffer
     videoBuffer_.write(reinterpret_cast<const char*>(buffer.cdata), buffer.size);
 }
 
+float QtVideoOutput::getBacklog() const
+{
+    if(videoBuffer_.hasOverflowed())
+    {
+        return 1.0f;
+    }
+
+    // Capped below 1, which is reserved for lost data.
+    return std::min(0.99f, static_cast<float>(videoBuffer_.getBufferedSize()) / cMaxBacklog);
+}
+
+uint64_t QtVideoOutput::getDecodeErrorsCount() const
+{
+    return decodeErrorsCount_;
+}
+
 void QtVideoOutput::onStartPlayback()
 {
     videoWidget_->setAspectRatioMode(Qt::IgnoreAspectRatio);
+    videoWidget_->setAttribute(Qt::WA_AcceptTouchEvents);
     videoWidget_->setFocus();
     videoWidget_->setWindowFlags(Qt::WindowStaysOnTopHint);
     videoWidget_->setFullScreen(true);
@@ -87,6 +109,12 @@ void QtVideoOutput::onStopPlayback()
     mediaPlayer_->stop();
 }
 
+void QtVideoOutput::onMediaPlayerError(QMediaPlayer::Error error)
+{
+    OPENAUTO_LOG(error) << "[QtVideoOutput] media player error: " << error << ", " << mediaPlayer_->errorString().toStdString();
+    ++decodeErrorsCount_;
+}
+
 }
 }
 }
@@ -0,0 +1,211 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+#include <f1x/openauto/autoapp/Projection/DSPKernels.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+namespace
+{
+
+uint32_t greatestCommonDivisor(uint32_t a, uint32_t b)
+{
+    while(b != 0)
+    {
+        const auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+
+    for(int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+struct FilterDesign
+{
+    size_t tapsPerPhase;
+    double kaiserBeta;
+    double passband;
+};
+
+FilterDesign getFilterDesign(configuration::ResamplerQuality quality)
+{
+    switch(quality)
+    {
+    case configuration::ResamplerQuality::LOW:
+        return FilterDesign{12, 5.0, 0.85};
+
+    case configuration::ResamplerQuality::HIGH:
+        return FilterDesign{48, 10.0, 0.95};
+
+    default:
+        return FilterDesign{24, 8.0, 0.92};
+    }
+}
+
+}
+
+Resampler::Resampler(uint32_t inputSampleRate, uint32_t outputSampleRate, uint32_t channelCount, configuration::ResamplerQuality quality)
+    : inputSampleRate_(inputSampleRate)
+    , outputSampleRate_(outputSampleRate)
+    , channelCount_(channelCount)
+    , interpolation_(outputSampleRate / greatestCommonDivisor(inputSampleRate, outputSampleRate))
+    , decimation_(inputSampleRate / greatestCommonDivisor(inputSampleRate, outputSampleRate))
+    , tapsPerPhase_(getFilterDesign(quality).tapsPerPhase)
+    , inputIndex_(0)
+    , phase_(0)
+{
+    const auto filterDesign = getFilterDesign(quality);
+    this->designFilter(0.5 / std::max(interpolation_, decimation_) * filterDesign.passband, filterDesign.kaiserBeta);
+    this->reset();
+
+    // measured response and throughput of each design are reported by resamplerbench
+    OPENAUTO_LOG(info) << "[Resampler] " << inputSampleRate_ << " Hz -> " << outputSampleRate_ << " Hz"
+                       << ", channels: " << channelCount_
+                       << ", taps per phase: " << tapsPerPhase_
+                       << ", phases: " << interpolation_
+                       << ", kaiser beta: " << filterDesign.kaiserBeta;
+}
+
+void Resampler::designFilter(double cutoff, double kaiserBeta)
+{
+    // windowed-sinc prototype split into interpolation_ polyphase branches, each branch
+    // is stored time-reversed so that one output sample is a single contiguous dot product
+    const size_t prototypeLength = tapsPerPhase_ * interpolation_;
+    const double center = (prototypeLength - 1) / 2.0;
+    const double windowNormalization = besselI0(kaiserBeta);
+
+    phases_.assign(interpolation_, std::vector<float>(tapsPerPhase_, 0.0f));
+
+    for(size_t i = 0; i < prototypeLength; ++i)
+    {
+        const double t = i - center;
+        const double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        const double ratio = t / center;
+        const double window = besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNormalization;
+
+        phases_[i % interpolation_][tapsPerPhase_ - 1 - i / interpolation_] = static_cast<float>(sinc * window * interpolation_);
+    }
+}
+
+void Resampler::process(const int16_t* input, size_t frameCount, std::vector<float>& output)
+{
+    const size_t historyLength = tapsPerPhase_ - 1;
+
+    for(uint32_t channel = 0; channel < channelCount_; ++channel)
+    {
+        auto& history = history_[channel];
+        history.resize(historyLength + frameCount);
+
+        for(size_t frame = 0; frame < frameCount; ++frame)
+        {
+            history[historyLength + frame] = input[frame * channelCount_ + channel] * (1.0f / 32768.0f);
+        }
+    }
+
+    size_t inputIndex = inputIndex_;
+    uint32_t phase = phase_;
+
+    while(inputIndex < frameCount)
+    {
+        if(channelCount_ == 2)
+        {
+            float left;
+            float right;
+            dsp::dualDotProduct(phases_[phase].data(), history_[0].data() + inputIndex, history_[1].data() + inputIndex, tapsPerPhase_, left, right);
+            output.push_back(left);
+            output.push_back(right);
+        }
+        else
+        {
+            for(uint32_t channel = 0; channel < channelCount_; ++channel)
+            {
+                output.push_back(dsp::dotProduct(phases_[phase].data(), history_[channel].data() + inputIndex, tapsPerPhase_));
+            }
+        }
+
+        phase += decimation_;
+        inputIndex += phase / interpolation_;
+        phase %= interpolation_;
+    }
+
+    inputIndex_ = inputIndex - frameCount;
+    phase_ = phase;
+
+    for(auto& history : history_)
+    {
+        std::copy(history.end() - historyLength, history.end(), history.begin());
+        history.resize(historyLength);
+    }
+}
+
+void Resampler::process(const int16_t* input, size_t frameCount, std::vector<int16_t>& output)
+{
+    converted_.clear();
+    this->process(input, frameCount, converted_);
+
+    const size_t outputSize = output.size();
+    output.resize(outputSize + converted_.size());
+    dsp::convertToInt16(converted_.data(), output.data() + outputSize, converted_.size());
+}
+
+void Resampler::reset()
+{
+    history_.assign(channelCount_, std::vector<float>(tapsPerPhase_ - 1, 0.0f));
+    inputIndex_ = 0;
+    phase_ = 0;
+}
+
+uint32_t Resampler::getInputSampleRate() const
+{
+    return inputSampleRate_;
+}
+
+uint32_t Resampler::getOutputSampleRate() const
+{
+    return outputSampleRate_;
+}
+
+}
+}
+}
+}
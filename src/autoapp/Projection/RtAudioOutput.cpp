@@ -28,10 +28,16 @@ namespace autoapp
 namespace projection
 {
 
-RtAudioOutput::RtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate)
+RtAudioOutput::RtAudioOutput(uint32_t channelCount, uint32_t sampleSize, uint32_t sampleRate, configuration::ResamplerQuality resamplerQuality, EchoReference::Pointer echoReference)
     : channelCount_(channelCount)
     , sampleSize_(sampleSize)
     , sampleRate_(sampleRate)
+    , deviceSampleRate_(sampleRate)
+    , resamplerQuality_(resamplerQuality)
+    , gain_(1.0f)
+    , currentGain_(1.0f)
+    , echoReference_(std::move(echoReference))
+    , echoReferenceSourceId_(echoReference_ != nullptr ? echoReference_->addSource() : 0)
 {
     std::vector<RtAudio::Api> apis;
     RtAudio::getCompiledApi(apis);
@@ -51,10 +57,14 @@ bool RtAudioOutput::open()
 
         try
         {
+            deviceSampleRate_ = this->selectDeviceSampleRate(dac_->getDeviceInfo(parameters.deviceId));
+            resampler_ = deviceSampleRate_ != sampleRate_ ? std::make_unique<Resampler>(sampleRate_, deviceSampleRate_, channelCount_, resamplerQuality_) : nullptr;
+            sourceReader_ = !source_.expired() ? std::make_unique<AudioSourceReader>(source_, deviceSampleRate_, resamplerQuality_) : nullptr;
+
             RtAudio::StreamOptions streamOptions;
             streamOptions.flags = RTAUDIO_MINIMIZE_LATENCY | RTAUDIO_SCHEDULE_REALTIME;
-            uint32_t bufferFrames = sampleRate_ == 16000 ? 1024 : 2048; //according to the observation of audio packets
-            dac_->openStream(&parameters, nullptr, RTAUDIO_SINT16, sampleRate_, &bufferFrames, &RtAudioOutput::audioBufferReadHandler, static_cast<void*>(this), &streamOptions);
+            uint32_t bufferFrames = (sampleRate_ == 16000 ? 1024 : 2048) * deviceSampleRate_ / sampleRate_; //according to the observation of audio packets
+            dac_->openStream(&parameters, nullptr, RTAUDIO_SINT16, deviceSampleRate_, &bufferFrames, &RtAudioOutput::audioBufferReadHandler, static_cast<void*>(this), &streamOptions);
             return audioBuffer_.open(QIODevice::ReadWrite);
         }
         catch(const RtAudioError& e)
@@ -72,7 +82,16 @@ bool RtAudioOutput::open()
 
 void RtAudioOutput::write(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer)
 {
-    audioBuffer_.write(reinterpret_cast<const char*>(buffer.cdata), buffer.size);
+    if(resampler_ != nullptr)
+    {
+        resampled_.clear();
+        resampler_->process(reinterpret_cast<const int16_t*>(buffer.cdata), buffer.size / (sizeof(int16_t) * channelCount_), resampled_);
+        audioBuffer_.write(reinterpret_cast<const char*>(resampled_.data()), resampled_.size() * sizeof(int16_t));
+    }
+    else
+    {
+        audioBuffer_.write(reinterpret_cast<const char*>(buffer.cdata), buffer.size);
+    }
 }
 
 void RtAudioOutput::start()
@@ -102,11 +121,23 @@ void RtAudioOutput::stop()
     {
         dac_->closeStream();
     }
+
+    if(resampler_ != nullptr)
+    {
+        resampler_->reset();
+    }
 }
 
 void RtAudioOutput::suspend()
 {
-    //not needed
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    this->doSuspend();
+}
+
+void RtAudioOutput::setGain(float gain)
+{
+    gain_ = gain;
 }
 
 uint32_t RtAudioOutput::getSampleSize() const
@@ -124,6 +155,28 @@ uint32_t RtAudioOutput::getSampleRate() const
     return sampleRate_;
 }
 
+void RtAudioOutput::setSource(IAudioSource::Pointer source)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    // with a source the device callback pulls from it instead of the buffer filled by write()
+    source_ = source;
+}
+
+uint32_t RtAudioOutput::selectDeviceSampleRate(const RtAudio::DeviceInfo& deviceInfo) const
+{
+    const auto& sampleRates = deviceInfo.sampleRates;
+
+    if(sampleRates.empty() || std::find(sampleRates.begin(), sampleRates.end(), sampleRate_) != sampleRates.end())
+    {
+        return sampleRate_;
+    }
+
+    const uint32_t deviceSampleRate = deviceInfo.preferredSampleRate != 0 ? deviceInfo.preferredSampleRate : sampleRates.back();
+    OPENAUTO_LOG(info) << "[RtAudioOutput] Device does not support " << sampleRate_ << " Hz, resampling to " << deviceSampleRate << " Hz.";
+    return deviceSampleRate;
+}
+
 void RtAudioOutput::doSuspend()
 {
     if(dac_->isStreamOpen() && dac_->isStreamRunning())
@@ -145,11 +198,54 @@ int RtAudioOutput::audioBufferReadHandler(void* outputBuffer, void* inputBuffer,
     RtAudioOutput* self = static_cast<RtAudioOutput*>(userData);
     std::lock_guard<decltype(self->mutex_)> lock(self->mutex_);
 
-    const auto bufferSize = nBufferFrames * (self->sampleSize_ / 8) * self->channelCount_;
-    self->audioBuffer_.read(reinterpret_cast<char*>(outputBuffer), bufferSize);
+    if(self->sourceReader_ != nullptr)
+    {
+        self->sourceReader_->read(static_cast<int16_t*>(outputBuffer), nBufferFrames);
+    }
+    else
+    {
+        const auto bufferSize = nBufferFrames * (self->sampleSize_ / 8) * self->channelCount_;
+        const auto readSize = std::max<qint64>(0, self->audioBuffer_.read(reinterpret_cast<char*>(outputBuffer), bufferSize));
+        std::fill(static_cast<char*>(outputBuffer) + readSize, static_cast<char*>(outputBuffer) + bufferSize, 0);
+    }
+
+    self->applyGain(static_cast<int16_t*>(outputBuffer), nBufferFrames);
+
+    if(self->echoReference_ != nullptr)
+    {
+        self->echoReference_->write(self->echoReferenceSourceId_, static_cast<const int16_t*>(outputBuffer), nBufferFrames, self->channelCount_, self->deviceSampleRate_);
+    }
+
     return 0;
 }
 
+void RtAudioOutput::applyGain(int16_t* samples, size_t frameCount)
+{
+    const float targetGain = gain_;
+
+    if(currentGain_ == 1.0f && targetGain == 1.0f)
+    {
+        return;
+    }
+
+    // linear ramp towards the target gain, limited per frame to avoid audible steps
+    const float maxChange = cGainRampPerFrame * frameCount;
+    const float gainStep = std::max(-maxChange, std::min(maxChange, targetGain - currentGain_)) / frameCount;
+
+    for(size_t frame = 0; frame < frameCount; ++frame)
+    {
+        const float gain = currentGain_ + gainStep * frame;
+
+        for(uint32_t channel = 0; channel < channelCount_; ++channel)
+        {
+            auto& sample = samples[frame * channelCount_ + channel];
+            sample = static_cast<int16_t>(sample * gain);
+        }
+    }
+
+    currentGain_ += gainStep * frameCount;
+}
+
 }
 }
 }
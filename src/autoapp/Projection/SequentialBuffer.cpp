@@ -27,8 +27,10 @@ namespace autoapp
 namespace projection
 {
 
-SequentialBuffer::SequentialBuffer()
+SequentialBuffer::SequentialBuffer(OverflowPolicy overflowPolicy)
     : data_(aasdk::common::cStaticDataSize)
+    , overflowPolicy_(overflowPolicy)
+    , overflowed_(false)
 {
 }
 
@@ -57,6 +59,11 @@ qint64 SequentialBuffer::readData(char *data, qint64 maxlen)
     std::copy(data_.begin(), data_.begin() + len, data);
     data_.erase_begin(len);
 
+    if(readHandler_)
+    {
+        readHandler_(data, len);
+    }
+
     return len;
 }
 
@@ -64,6 +71,13 @@ qint64 SequentialBuffer::writeData(const char *data, qint64 len)
 {
     std::lock_guard<decltype(mutex_)> lock(mutex_);
 
+    // Inserting into a full circular buffer overwrites the oldest unread data.
+    overflowed_ = static_cast<size_t>(len) > data_.reserve();
+    if(overflowed_ && overflowPolicy_ == OverflowPolicy::REFUSE_WRITE)
+    {
+        return -1;
+    }
+
     data_.insert(data_.end(), data, data + len);
     emit readyRead();
     return len;
@@ -103,6 +117,27 @@ qint64 SequentialBuffer::bytesAvailable() const
     return QIODevice::bytesAvailable() + std::max<qint64>(1, data_.size());
 }
 
+size_t SequentialBuffer::getBufferedSize() const
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    return data_.size();
+}
+
+bool SequentialBuffer::hasOverflowed() const
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    return overflowed_;
+}
+
+void SequentialBuffer::setReadHandler(ReadHandler handler)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    readHandler_ = std::move(handler);
+}
+
 bool SequentialBuffer::canReadLine() const
 {
     return true;
@@ -0,0 +1,214 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_SHM
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <f1x/openauto/autoapp/Projection/SharedMemoryVideoOutput.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+SharedMemoryVideoOutput::SharedMemoryVideoOutput(configuration::IConfiguration::Pointer configuration)
+    : VideoOutput(std::move(configuration))
+    , isActive_(false)
+    , map_(nullptr)
+    , size_(0)
+    , header_(nullptr)
+    , timestamp_(0)
+    , decodeErrorsCount_(0)
+{
+
+}
+
+bool SharedMemoryVideoOutput::open()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    const auto name = configuration_->getSharedMemoryName();
+    OPENAUTO_LOG(info) << "[SharedMemoryVideoOutput] open, name: " << name;
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if(fd < 0)
+    {
+        OPENAUTO_LOG(error) << "[SharedMemoryVideoOutput] shm_open failed: " << strerror(errno);
+        return false;
+    }
+
+    const size_t dataOffset = (sizeof(openauto_shm_header) + 4095) & ~static_cast<size_t>(4095);
+    size_ = dataOffset + getSlotSize() * OPENAUTO_SHM_SLOTS;
+
+    void* map = MAP_FAILED;
+    if(ftruncate(fd, size_) == 0)
+    {
+        map = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        OPENAUTO_LOG(error) << "[SharedMemoryVideoOutput] mapping failed: " << strerror(errno);
+        return false;
+    }
+
+    map_ = static_cast<uint8_t*>(map);
+    header_ = static_cast<openauto_shm_header*>(map);
+
+    // a segment left by a previous session is reused as is, clients mapping it stay valid
+    if(__atomic_load_n(&header_->magic, __ATOMIC_ACQUIRE) != OPENAUTO_SHM_MAGIC || header_->version != OPENAUTO_SHM_VERSION ||
+       header_->slot_size != getSlotSize() || header_->data_offset != dataOffset)
+    {
+        __atomic_store_n(&header_->magic, 0, __ATOMIC_RELEASE);
+        memset(map_ + sizeof(header_->magic), 0, sizeof(openauto_shm_header) - sizeof(header_->magic));
+        header_->version = OPENAUTO_SHM_VERSION;
+        header_->format = OPENAUTO_SHM_FORMAT_I420;
+        header_->slot_count = OPENAUTO_SHM_SLOTS;
+        header_->slot_size = getSlotSize();
+        header_->data_offset = dataOffset;
+        __atomic_store_n(&header_->magic, OPENAUTO_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    if(!decoder_.open())
+    {
+        this->release();
+        return false;
+    }
+
+    isActive_ = true;
+    return true;
+}
+
+bool SharedMemoryVideoOutput::init()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    OPENAUTO_LOG(info) << "[SharedMemoryVideoOutput] init, state: " << isActive_;
+
+    if(isActive_)
+    {
+        __atomic_store_n(&header_->active, 1, __ATOMIC_RELEASE);
+    }
+
+    return isActive_;
+}
+
+void SharedMemoryVideoOutput::write(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    if(!isActive_)
+    {
+        return;
+    }
+
+    timestamp_ = timestamp;
+
+    if(!decoder_.decode(buffer, std::bind(&SharedMemoryVideoOutput::publishFrame, this, std::placeholders::_1)))
+    {
+        ++decodeErrorsCount_;
+    }
+}
+
+void SharedMemoryVideoOutput::stop()
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    OPENAUTO_LOG(info) << "[SharedMemoryVideoOutput] stop.";
+    this->release();
+}
+
+uint64_t SharedMemoryVideoOutput::getDecodeErrorsCount() const
+{
+    return decodeErrorsCount_;
+}
+
+void SharedMemoryVideoOutput::publishFrame(const AVFrame* frame)
+{
+    const uint32_t width = std::min<uint32_t>(frame->width, OPENAUTO_SHM_MAX_WIDTH);
+    const uint32_t height = std::min<uint32_t>(frame->height, OPENAUTO_SHM_MAX_HEIGHT);
+
+    // the newest slot and the one before it stay readable while this one is written
+    const uint32_t index = (__atomic_load_n(&header_->latest, __ATOMIC_RELAXED) + 1) % OPENAUTO_SHM_SLOTS;
+    auto& slot = header_->slots[index];
+    uint8_t* data = map_ + header_->data_offset + header_->slot_size * index;
+
+    const uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) | 1;
+    __atomic_store_n(&slot.sequence, sequence, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot.width = width;
+    slot.height = height;
+    slot.strides[0] = width;
+    slot.strides[1] = slot.strides[2] = (width + 1) / 2;
+    slot.offsets[0] = 0;
+    slot.offsets[1] = static_cast<uint64_t>(slot.strides[0]) * height;
+    slot.offsets[2] = slot.offsets[1] + static_cast<uint64_t>(slot.strides[1]) * ((height + 1) / 2);
+    slot.timestamp = timestamp_;
+    slot.frame_number = header_->frames_count + 1;
+
+    uint8_t* const planes[4] = {data + slot.offsets[0], data + slot.offsets[1], data + slot.offsets[2], nullptr};
+    const int strides[4] = {static_cast<int>(slot.strides[0]), static_cast<int>(slot.strides[1]), static_cast<int>(slot.strides[2]), 0};
+
+    if(!decoder_.convert(frame, AV_PIX_FMT_YUV420P, width, height, planes, strides))
+    {
+        ++decodeErrorsCount_;
+    }
+
+    __atomic_store_n(&slot.sequence, sequence + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&header_->latest, index, __ATOMIC_RELEASE);
+    __atomic_store_n(&header_->frames_count, slot.frame_number, __ATOMIC_RELEASE);
+}
+
+void SharedMemoryVideoOutput::release()
+{
+    isActive_ = false;
+    decoder_.close();
+
+    if(map_ != nullptr)
+    {
+        __atomic_store_n(&header_->active, 0, __ATOMIC_RELEASE);
+        munmap(map_, size_);
+        map_ = nullptr;
+        header_ = nullptr;
+    }
+}
+
+size_t SharedMemoryVideoOutput::getSlotSize()
+{
+    const size_t frameSize = OPENAUTO_SHM_MAX_WIDTH * OPENAUTO_SHM_MAX_HEIGHT * 3 / 2;
+    return (frameSize + 4095) & ~static_cast<size_t>(4095);
+}
+
+}
+}
+}
+}
+
+#endif
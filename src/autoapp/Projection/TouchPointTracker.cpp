@@ -0,0 +1,113 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Projection/TouchPointTracker.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+TouchEvent TouchPointTracker::press(int touchPointId, uint32_t x, uint32_t y)
+{
+    touchPoints_[touchPointId] = {x, y, this->allocatePointerId()};
+    return this->createEvent(touchPoints_.size() == 1 ? aasdk::proto::enums::TouchAction::PRESS : aasdk::proto::enums::TouchAction::POINTER_DOWN, touchPointId);
+}
+
+bool TouchPointTracker::move(int touchPointId, uint32_t x, uint32_t y)
+{
+    auto touchPoint = touchPoints_.find(touchPointId);
+
+    if(touchPoint == touchPoints_.end() || (touchPoint->second.x == x && touchPoint->second.y == y))
+    {
+        return false;
+    }
+
+    touchPoint->second.x = x;
+    touchPoint->second.y = y;
+    return true;
+}
+
+TouchEvent TouchPointTracker::release(int touchPointId)
+{
+    const auto event = this->createEvent(touchPoints_.size() == 1 ? aasdk::proto::enums::TouchAction::RELEASE : aasdk::proto::enums::TouchAction::POINTER_UP, touchPointId);
+    touchPoints_.erase(touchPointId);
+    return event;
+}
+
+TouchEvent TouchPointTracker::drag() const
+{
+    return this->createEvent(aasdk::proto::enums::TouchAction::DRAG, touchPoints_.empty() ? 0 : touchPoints_.begin()->first);
+}
+
+TouchEvent TouchPointTracker::cancel()
+{
+    const auto event = this->createEvent(aasdk::proto::enums::TouchAction::RELEASE, touchPoints_.empty() ? 0 : touchPoints_.begin()->first);
+    touchPoints_.clear();
+    return event;
+}
+
+bool TouchPointTracker::contains(int touchPointId) const
+{
+    return touchPoints_.count(touchPointId) != 0;
+}
+
+bool TouchPointTracker::empty() const
+{
+    return touchPoints_.empty();
+}
+
+TouchEvent TouchPointTracker::createEvent(aasdk::proto::enums::TouchAction::Enum type, int touchPointId) const
+{
+    TouchEvent event{type, 0, {}};
+    event.locations.reserve(touchPoints_.size());
+
+    for(const auto& touchPoint : touchPoints_)
+    {
+        if(touchPoint.first == touchPointId)
+        {
+            event.actionIndex = event.locations.size();
+        }
+
+        event.locations.push_back(touchPoint.second);
+    }
+
+    return event;
+}
+
+uint32_t TouchPointTracker::allocatePointerId() const
+{
+    uint32_t pointerId = 0;
+
+    while(std::any_of(touchPoints_.begin(), touchPoints_.end(), [pointerId](const std::pair<const int, TouchLocation>& touchPoint) { return touchPoint.second.pointerId == pointerId; }))
+    {
+        ++pointerId;
+    }
+
+    return pointerId;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,133 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <f1x/openauto/autoapp/Projection/NalParser.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+namespace ut
+{
+
+// Every start position and every range around it, so hits before, inside and across the 16-byte
+// blocks of the SIMD loop as well as in its scalar tail are compared with the reference.
+BOOST_AUTO_TEST_CASE(NalParser_FindStartCodeMatchesScalarAtEveryPosition)
+{
+    constexpr size_t cBufferSize = 64;
+
+    for(size_t position = 0; position + 3 <= cBufferSize; ++position)
+    {
+        std::vector<uint8_t> buffer(cBufferSize, 0xA5);
+        buffer[position] = 0;
+        buffer[position + 1] = 0;
+        buffer[position + 2] = 1;
+
+        for(size_t begin = 0; begin <= position + 1; ++begin)
+        {
+            for(size_t end = begin; end <= cBufferSize; ++end)
+            {
+                const auto* result = NalParser::findStartCode(buffer.data() + begin, buffer.data() + end);
+                const auto* expected = NalParser::findStartCodeScalar(buffer.data() + begin, buffer.data() + end);
+                BOOST_REQUIRE_MESSAGE(result == expected, "position: " << position << ", begin: " << begin << ", end: " << end);
+            }
+        }
+    }
+}
+
+// A start code split by a block boundary: 00 | 00 01, 00 00 | 01 and the zero run of a four byte code.
+BOOST_AUTO_TEST_CASE(NalParser_FindStartCodeAcrossBlockBoundary)
+{
+    for(size_t position = 12; position <= 17; ++position)
+    {
+        std::vector<uint8_t> buffer(48, 0xFF);
+        buffer[position - 1] = 0;
+        buffer[position] = 0;
+        buffer[position + 1] = 0;
+        buffer[position + 2] = 1;
+
+        const auto* result = NalParser::findStartCode(buffer.data(), buffer.data() + buffer.size());
+        BOOST_CHECK_EQUAL(result - buffer.data(), static_cast<ptrdiff_t>(position));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NalParser_FindStartCodeMatchesScalarOnRandomData)
+{
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<int> byteDistribution(0, 7);
+    std::uniform_int_distribution<size_t> sizeDistribution(0, 256);
+
+    for(size_t i = 0; i < 20000; ++i)
+    {
+        // mostly zeros and ones, so partial and overlapping start codes are frequent
+        std::vector<uint8_t> buffer(sizeDistribution(generator));
+        for(auto& value : buffer)
+        {
+            const auto symbol = byteDistribution(generator);
+            value = symbol < 4 ? 0 : (symbol < 6 ? 1 : static_cast<uint8_t>(symbol * 31));
+        }
+
+        std::uniform_int_distribution<size_t> beginDistribution(0, buffer.size());
+        const size_t begin = beginDistribution(generator);
+        std::uniform_int_distribution<size_t> endDistribution(begin, buffer.size());
+        const size_t end = endDistribution(generator);
+
+        for(const uint8_t* current = buffer.data() + begin; current < buffer.data() + end; ++current)
+        {
+            const auto* result = NalParser::findStartCode(current, buffer.data() + end);
+            BOOST_REQUIRE(result == NalParser::findStartCodeScalar(current, buffer.data() + end));
+            current = result;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NalParser_ParseSplitsAccessUnitsAtFirstSlice)
+{
+    const aasdk::common::Data data{0, 0, 0, 1, 0x67, 0x42,          // SPS
+                                   0, 0, 0, 1, 0x68, 0xCE,          // PPS
+                                   0, 0, 1, 0x65, 0x88, 0x84,       // IDR, first_mb_in_slice 0
+                                   0, 0, 1, 0x65, 0x40, 0x11,       // IDR, second slice of the picture
+                                   0, 0, 0, 1, 0x41, 0x9A, 0x02};   // non-IDR, first_mb_in_slice 0
+
+    NalParser::AccessUnits accessUnits;
+    NalParser::parse(42, aasdk::common::DataConstBuffer(data), accessUnits);
+
+    BOOST_REQUIRE_EQUAL(accessUnits.size(), 2u);
+
+    BOOST_CHECK_EQUAL(accessUnits[0].buffer.size, 24u);
+    BOOST_CHECK(accessUnits[0].hasSPS && accessUnits[0].hasPPS && accessUnits[0].isIDR && accessUnits[0].isReference);
+    BOOST_CHECK(!accessUnits[0].hasError);
+
+    BOOST_CHECK(accessUnits[1].buffer.cdata == data.data() + 24);
+    BOOST_CHECK_EQUAL(accessUnits[1].buffer.size, 7u);
+    BOOST_CHECK(accessUnits[1].hasSlice && !accessUnits[1].isIDR && !accessUnits[1].hasSPS);
+    BOOST_CHECK_EQUAL(accessUnits[1].timestamp, 42u);
+}
+
+}
+}
+}
+}
+}
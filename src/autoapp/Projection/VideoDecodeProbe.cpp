@@ -0,0 +1,180 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <f1x/openauto/autoapp/Projection/VideoDecodeProbe.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+constexpr size_t VideoDecodeProbe::cWidth;
+constexpr size_t VideoDecodeProbe::cHeight;
+constexpr size_t VideoDecodeProbe::cMacroblockSize;
+constexpr int64_t VideoDecodeProbe::cMinDuration;
+constexpr size_t VideoDecodeProbe::cMinFrames;
+
+namespace
+{
+
+std::once_flag probeStarted;
+std::shared_future<uint64_t> probeResult;
+
+}
+
+VideoDecodeProbe::VideoDecodeProbe()
+    : reference_(cWidth * cHeight)
+    , frame_(cWidth * cHeight)
+{
+    for(size_t i = 0; i < reference_.size(); ++i)
+    {
+        reference_[i] = static_cast<uint8_t>((i * 7) ^ (i >> 5));
+    }
+}
+
+uint64_t VideoDecodeProbe::run()
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    size_t frames = 0;
+
+    do
+    {
+        this->decodeFrame(static_cast<uint32_t>(frames + 1));
+        std::swap(reference_, frame_);
+        ++frames;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    while(frames < cMinFrames || elapsed < std::chrono::milliseconds(cMinDuration));
+
+    const auto microseconds = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    // Only luma is reconstructed; 4:2:0 chroma adds another half of the work.
+    const uint64_t pixelRate = static_cast<uint64_t>(frames * cWidth * cHeight * 1000000 / microseconds * 2 / 3);
+
+    OPENAUTO_LOG(info) << "[VideoDecodeProbe] frames: " << frames
+                       << ", time: " << microseconds << " us"
+                       << ", pixel rate: " << pixelRate;
+
+    return pixelRate;
+}
+
+void VideoDecodeProbe::startAsync()
+{
+    start(std::launch::async);
+}
+
+uint64_t VideoDecodeProbe::getPixelRate()
+{
+    start(std::launch::deferred);
+
+    // every caller waits through its own copy of the shared state
+    auto result = probeResult;
+    return result.get();
+}
+
+void VideoDecodeProbe::start(std::launch policy)
+{
+    std::call_once(probeStarted, [policy]() {
+        probeResult = std::async(policy, []() { return VideoDecodeProbe().run(); }).share();
+    });
+}
+
+void VideoDecodeProbe::decodeFrame(uint32_t seed)
+{
+    for(size_t y = 0; y < cHeight; y += cMacroblockSize)
+    {
+        for(size_t x = 0; x < cWidth; x += cMacroblockSize)
+        {
+            seed = seed * 1664525 + 1013904223;
+
+            const auto referenceX = std::min(cWidth - cMacroblockSize - 1, static_cast<size_t>(std::max<int64_t>(0, static_cast<int64_t>(x) + static_cast<int32_t>(seed >> 28) - 8)));
+            const auto referenceY = std::min(cHeight - cMacroblockSize - 1, static_cast<size_t>(std::max<int64_t>(0, static_cast<int64_t>(y) + static_cast<int32_t>((seed >> 24) & 0x0F) - 8)));
+
+            for(size_t blockY = 0; blockY < cMacroblockSize; blockY += 4)
+            {
+                for(size_t blockX = 0; blockX < cMacroblockSize; blockX += 4)
+                {
+                    this->reconstructBlock(&frame_[(y + blockY) * cWidth + x + blockX],
+                                           &reference_[(referenceY + blockY) * cWidth + referenceX + blockX],
+                                           cWidth, seed);
+                }
+            }
+        }
+    }
+}
+
+void VideoDecodeProbe::reconstructBlock(uint8_t* destination, const uint8_t* reference, size_t stride, uint32_t& seed)
+{
+    int32_t coefficients[16];
+
+    for(auto& coefficient : coefficients)
+    {
+        seed = seed * 1664525 + 1013904223;
+        coefficient = static_cast<int32_t>(seed >> 27) - 16;
+    }
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        int32_t* row = &coefficients[i * 4];
+        const int32_t e = row[0] + row[2];
+        const int32_t f = row[0] - row[2];
+        const int32_t g = (row[1] >> 1) - row[3];
+        const int32_t h = row[1] + (row[3] >> 1);
+        row[0] = e + h;
+        row[1] = f + g;
+        row[2] = f - g;
+        row[3] = e - h;
+    }
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        const int32_t e = coefficients[i] + coefficients[8 + i];
+        const int32_t f = coefficients[i] - coefficients[8 + i];
+        const int32_t g = (coefficients[4 + i] >> 1) - coefficients[12 + i];
+        const int32_t h = coefficients[4 + i] + (coefficients[12 + i] >> 1);
+        coefficients[i] = e + h;
+        coefficients[4 + i] = f + g;
+        coefficients[8 + i] = f - g;
+        coefficients[12 + i] = e - h;
+    }
+
+    for(size_t y = 0; y < 4; ++y)
+    {
+        for(size_t x = 0; x < 4; ++x)
+        {
+            const uint8_t* source = reference + y * stride + x;
+            const int32_t prediction = (source[0] + source[1] + source[stride] + source[stride + 1] + 2) >> 2;
+            const int32_t value = prediction + ((coefficients[y * 4 + x] + 32) >> 6);
+            destination[y * stride + x] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+        }
+    }
+}
+
+}
+}
+}
+}
@@ -0,0 +1,135 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef USE_AVCODEC
+
+#include <f1x/openauto/autoapp/Projection/VideoDecoder.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace projection
+{
+
+VideoDecoder::VideoDecoder()
+    : codecContext_(nullptr)
+    , packet_(nullptr)
+    , frame_(nullptr)
+    , swsContext_(nullptr)
+{
+
+}
+
+VideoDecoder::~VideoDecoder()
+{
+    this->close();
+}
+
+bool VideoDecoder::open()
+{
+    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    if(codec == nullptr)
+    {
+        OPENAUTO_LOG(error) << "[VideoDecoder] h264 decoder not available.";
+        return false;
+    }
+
+    codecContext_ = avcodec_alloc_context3(codec);
+    packet_ = av_packet_alloc();
+    frame_ = av_frame_alloc();
+
+    if(codecContext_ == nullptr || packet_ == nullptr || frame_ == nullptr)
+    {
+        this->close();
+        return false;
+    }
+
+    codecContext_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    codecContext_->thread_type = FF_THREAD_SLICE;
+    codecContext_->thread_count = 0;
+
+    if(avcodec_open2(codecContext_, codec, nullptr) < 0)
+    {
+        OPENAUTO_LOG(error) << "[VideoDecoder] h264 decoder open failed.";
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+void VideoDecoder::close()
+{
+    sws_freeContext(swsContext_);
+    swsContext_ = nullptr;
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+    avcodec_free_context(&codecContext_);
+}
+
+bool VideoDecoder::decode(const aasdk::common::DataConstBuffer& buffer, const FrameHandler& handler)
+{
+    if(codecContext_ == nullptr)
+    {
+        return false;
+    }
+
+    // libavcodec reads past the end of the packet, the padding has to be zeroed
+    packetData_.assign(buffer.cdata, buffer.cdata + buffer.size);
+    packetData_.resize(buffer.size + AV_INPUT_BUFFER_PADDING_SIZE, 0);
+    packet_->data = packetData_.data();
+    packet_->size = static_cast<int>(buffer.size);
+
+    if(avcodec_send_packet(codecContext_, packet_) < 0)
+    {
+        return false;
+    }
+
+    int result;
+    while((result = avcodec_receive_frame(codecContext_, frame_)) == 0)
+    {
+        handler(frame_);
+    }
+
+    return result == AVERROR(EAGAIN) || result == AVERROR_EOF;
+}
+
+bool VideoDecoder::convert(const AVFrame* frame, AVPixelFormat format, int width, int height, uint8_t* const planes[], const int strides[])
+{
+    swsContext_ = sws_getCachedContext(swsContext_, frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                       width, height, format, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+
+    if(swsContext_ == nullptr)
+    {
+        return false;
+    }
+
+    sws_scale(swsContext_, frame->data, frame->linesize, 0, frame->height, planes, strides);
+    return true;
+}
+
+}
+}
+}
+}
+
+#endif
@@ -17,6 +17,8 @@
 */
 
 #include <f1x/openauto/autoapp/Projection/VideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoDecodeProbe.hpp>
+#include <f1x/openauto/Common/Log.hpp>
 
 namespace f1x
 {
@@ -29,28 +31,134 @@ namespace projection
 
 VideoOutput::VideoOutput(configuration::IConfiguration::Pointer configuration)
     : configuration_(std::move(configuration))
+    , snapshot_(configuration_->getSnapshot())
 {
 
 }
 
 aasdk::proto::enums::VideoFPS::Enum VideoOutput::getVideoFPS() const
 {
-    return configuration_->getVideoFPS();
+    return snapshot_->videoFPS;
 }
 
 aasdk::proto::enums::VideoResolution::Enum VideoOutput::getVideoResolution() const
 {
-    return configuration_->getVideoResolution();
+    return snapshot_->videoResolution;
 }
 
 size_t VideoOutput::getScreenDPI() const
 {
-    return configuration_->getScreenDPI();
+    return snapshot_->screenDPI;
 }
 
 QRect VideoOutput::getVideoMargins() const
 {
-    return configuration_->getVideoMargins();
+    return snapshot_->videoMargins;
+}
+
+IVideoOutput::VideoConfigs VideoOutput::getVideoConfigs() const
+{
+    if(!snapshot_->videoAdaptiveConfigs)
+    {
+        return {this->createVideoConfig(this->getVideoResolution(), this->getVideoFPS())};
+    }
+
+    const auto decodePixelRate = this->getDecodePixelRate();
+    const auto configuredResolution = this->getVideoResolution();
+    const auto configuredFPS = this->getVideoFPS();
+    VideoConfigs videoConfigs;
+
+    // The configured resolution and fps are an upper bound, adapting only steps down from them.
+    // Candidates are visited in descending pixel rate, so the phone sees the most demanding
+    // config the decoder keeps up with first.
+    for(const auto resolution : {aasdk::proto::enums::VideoResolution::_1080p, aasdk::proto::enums::VideoResolution::_720p, aasdk::proto::enums::VideoResolution::_480p})
+    {
+        for(const auto fps : {aasdk::proto::enums::VideoFPS::_60, aasdk::proto::enums::VideoFPS::_30})
+        {
+            if(getVideoHeight(resolution) <= getVideoHeight(configuredResolution) && getFramesPerSecond(fps) <= getFramesPerSecond(configuredFPS)
+               && getPixelRate(resolution, fps) <= decodePixelRate)
+            {
+                videoConfigs.push_back(this->createVideoConfig(resolution, fps));
+            }
+        }
+    }
+
+    if(videoConfigs.empty())
+    {
+        videoConfigs.push_back(this->createVideoConfig(aasdk::proto::enums::VideoResolution::_480p, aasdk::proto::enums::VideoFPS::_30));
+    }
+
+    OPENAUTO_LOG(info) << "[VideoOutput] decode pixel rate: " << decodePixelRate << ", video configs: " << videoConfigs.size();
+    return videoConfigs;
+}
+
+float VideoOutput::getBacklog() const
+{
+    return 0.0f;
+}
+
+uint64_t VideoOutput::getDecodeErrorsCount() const
+{
+    return 0;
+}
+
+uint64_t VideoOutput::getDecodePixelRate() const
+{
+    return VideoDecodeProbe::getPixelRate();
+}
+
+VideoConfig VideoOutput::createVideoConfig(aasdk::proto::enums::VideoResolution::Enum resolution, aasdk::proto::enums::VideoFPS::Enum fps) const
+{
+    // DPI and margins are configured for the selected resolution and are
+    // scaled, so the projected UI keeps its physical size and aspect ratio.
+    const auto configuredResolution = this->getVideoResolution();
+    const auto configuredMargins = this->getVideoMargins();
+    const auto width = getVideoWidth(resolution);
+    const auto height = getVideoHeight(resolution);
+
+    VideoConfig videoConfig;
+    videoConfig.resolution = resolution;
+    videoConfig.fps = fps;
+    videoConfig.dpi = this->getScreenDPI() * height / getVideoHeight(configuredResolution);
+    videoConfig.margins = QRect(0, 0, configuredMargins.width() * width / getVideoWidth(configuredResolution),
+                                configuredMargins.height() * height / getVideoHeight(configuredResolution));
+    return videoConfig;
+}
+
+uint32_t VideoOutput::getVideoWidth(aasdk::proto::enums::VideoResolution::Enum resolution)
+{
+    switch(resolution)
+    {
+    case aasdk::proto::enums::VideoResolution::_720p:
+        return 1280;
+    case aasdk::proto::enums::VideoResolution::_1080p:
+        return 1920;
+    default:
+        return 800;
+    }
+}
+
+uint32_t VideoOutput::getVideoHeight(aasdk::proto::enums::VideoResolution::Enum resolution)
+{
+    switch(resolution)
+    {
+    case aasdk::proto::enums::VideoResolution::_720p:
+        return 720;
+    case aasdk::proto::enums::VideoResolution::_1080p:
+        return 1080;
+    default:
+        return 480;
+    }
+}
+
+uint32_t VideoOutput::getFramesPerSecond(aasdk::proto::enums::VideoFPS::Enum fps)
+{
+    return fps == aasdk::proto::enums::VideoFPS::_60 ? 60 : 30;
+}
+
+uint64_t VideoOutput::getPixelRate(aasdk::proto::enums::VideoResolution::Enum resolution, aasdk::proto::enums::VideoFPS::Enum fps)
+{
+    return static_cast<uint64_t>(getVideoWidth(resolution)) * getVideoHeight(resolution) * getFramesPerSecond(fps);
 }
 
 }
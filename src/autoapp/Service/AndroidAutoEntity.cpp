@@ -35,7 +35,8 @@ AndroidAutoEntity::AndroidAutoEntity(boost::asio::io_service& ioService,
                                      aasdk::messenger::IMessenger::Pointer messenger,
                                      configuration::IConfiguration::Pointer configuration,
                                      ServiceList serviceList,
-                                     IPinger::Pointer pinger)
+                                     IPinger::Pointer pinger,
+                                     IAudioFocusArbiter::Pointer audioFocusArbiter)
     : strand_(ioService)
     , cryptor_(std::move(cryptor))
     , transport_(std::move(transport))
@@ -44,6 +45,7 @@ AndroidAutoEntity::AndroidAutoEntity(boost::asio::io_service& ioService,
     , configuration_(std::move(configuration))
     , serviceList_(std::move(serviceList))
     , pinger_(std::move(pinger))
+    , audioFocusArbiter_(std::move(audioFocusArbiter))
     , eventHandler_(nullptr)
 {
 }
@@ -77,6 +79,7 @@ void AndroidAutoEntity::stop()
         eventHandler_ = nullptr;
         std::for_each(serviceList_.begin(), serviceList_.end(), std::bind(&IService::stop, std::placeholders::_1));
         pinger_->cancel();
+        audioFocusArbiter_->reset();
         messenger_->stop();
         transport_->stop();
         cryptor_->deinit();
@@ -181,9 +184,7 @@ void AndroidAutoEntity::onAudioFocusRequest(const aasdk::proto::messages::AudioF
 {
     OPENAUTO_LOG(info) << "[AndroidAutoEntity] requested audio focus, type: " << request.audio_focus_type();
 
-    aasdk::proto::enums::AudioFocusState::Enum audioFocusState =
-            request.audio_focus_type() == aasdk::proto::enums::AudioFocusType::RELEASE ? aasdk::proto::enums::AudioFocusState::LOSS
-                                                                                       : aasdk::proto::enums::AudioFocusState::GAIN;
+    const auto audioFocusState = audioFocusArbiter_->requestFocus(request.audio_focus_type());
 
     OPENAUTO_LOG(info) << "[AndroidAutoEntity] audio focus state: " << audioFocusState;
 
@@ -0,0 +1,109 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/Service/AudioFocusArbiter.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+AudioFocusArbiter::AudioFocusArbiter(float duckingGain)
+    : duckingGain_(duckingGain)
+    , audioFocusType_(aasdk::proto::enums::AudioFocusType::NONE)
+{
+
+}
+
+void AudioFocusArbiter::registerOutput(aasdk::messenger::ChannelId channelId, projection::FocusedAudioOutput::Pointer audioOutput)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    this->applyFocus(channelId, *audioOutput);
+    audioOutputs_[channelId] = audioOutput;
+}
+
+aasdk::proto::enums::AudioFocusState::Enum AudioFocusArbiter::requestFocus(aasdk::proto::enums::AudioFocusType::Enum audioFocusType)
+{
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+
+    audioFocusType_ = audioFocusType;
+
+    for(auto& audioOutput : audioOutputs_)
+    {
+        if(auto output = audioOutput.second.lock())
+        {
+            this->applyFocus(audioOutput.first, *output);
+        }
+    }
+
+    switch(audioFocusType)
+    {
+    case aasdk::proto::enums::AudioFocusType::RELEASE:
+        return aasdk::proto::enums::AudioFocusState::LOSS;
+
+    case aasdk::proto::enums::AudioFocusType::GAIN_TRANSIENT:
+    case aasdk::proto::enums::AudioFocusType::GAIN_NAVI:
+        return aasdk::proto::enums::AudioFocusState::GAIN_TRANSIENT;
+
+    default:
+        return aasdk::proto::enums::AudioFocusState::GAIN;
+    }
+}
+
+void AudioFocusArbiter::reset()
+{
+    this->requestFocus(aasdk::proto::enums::AudioFocusType::NONE);
+}
+
+void AudioFocusArbiter::applyFocus(aasdk::messenger::ChannelId channelId, projection::FocusedAudioOutput& audioOutput)
+{
+    // speech and system sounds are always audible, media yields to the transient owner
+    if(channelId != aasdk::messenger::ChannelId::MEDIA_AUDIO)
+    {
+        audioOutput.setFocus(true, 1.0f);
+        return;
+    }
+
+    switch(audioFocusType_)
+    {
+    case aasdk::proto::enums::AudioFocusType::GAIN_TRANSIENT:
+        OPENAUTO_LOG(info) << "[AudioFocusArbiter] media suspended.";
+        audioOutput.setFocus(false, 0.0f);
+        break;
+
+    case aasdk::proto::enums::AudioFocusType::GAIN_NAVI:
+        OPENAUTO_LOG(info) << "[AudioFocusArbiter] media ducked, gain: " << duckingGain_;
+        audioOutput.setFocus(true, duckingGain_);
+        break;
+
+    default:
+        audioOutput.setFocus(true, 1.0f);
+        break;
+    }
+}
+
+}
+}
+}
+}
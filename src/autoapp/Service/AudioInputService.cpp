@@ -29,10 +29,12 @@ namespace autoapp
 namespace service
 {
 
-AudioInputService::AudioInputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IAudioInput::Pointer audioInput)
+AudioInputService::AudioInputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IAudioInput::Pointer audioInput,
+                                     projection::IAudioInputProcessor::Pointer audioInputProcessor)
     : strand_(ioService)
     , channel_(std::make_shared<aasdk::channel::av::AVInputServiceChannel>(strand_, std::move(messenger)))
     , audioInput_(std::move(audioInput))
+    , audioInputProcessor_(std::move(audioInputProcessor))
     , session_(0)
 {
 
@@ -51,6 +53,7 @@ void AudioInputService::stop()
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[AudioInputService] stop.";
         audioInput_->stop();
+        audioInputProcessor_->reset();
     });
 }
 
@@ -114,6 +117,11 @@ void AudioInputService::onAVInputOpenRequest(const aasdk::proto::messages::AVInp
 
     if(request.open())
     {
+        // drops the far-end reference queued since the previous capture so it cannot skew the alignment
+        audioInputProcessor_->reset();
+        audioInputProcessor_->setEchoCancellationEnabled(request.ec());
+        audioInputProcessor_->setNoiseSuppressionEnabled(request.anc());
+
         auto startPromise = projection::IAudioInput::StartPromise::defer(strand_);
         startPromise->then(std::bind(&AudioInputService::onAudioInputOpenSucceed, this->shared_from_this()),
             [this, self = this->shared_from_this()]() {
@@ -133,6 +141,7 @@ void AudioInputService::onAVInputOpenRequest(const aasdk::proto::messages::AVInp
     else
     {
         audioInput_->stop();
+        audioInputProcessor_->reset();
 
         aasdk::proto::messages::AVInputOpenResponse response;
         response.set_session(session_);
@@ -173,6 +182,8 @@ void AudioInputService::onAudioInputOpenSucceed()
 
 void AudioInputService::onAudioInputDataReady(aasdk::common::Data data)
 {
+    audioInputProcessor_->process(data);
+
     auto sendPromise = aasdk::channel::SendPromise::defer(strand_);
     sendPromise->then(std::bind(&AudioInputService::readAudioInput, this->shared_from_this()),
                      std::bind(&AudioInputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
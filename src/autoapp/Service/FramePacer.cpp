@@ -0,0 +1,254 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <f1x/openauto/autoapp/Service/FramePacer.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+constexpr size_t FramePacer::cMaxQueueSize;
+constexpr uint64_t FramePacer::cMaxTimestampGap;
+constexpr uint32_t FramePacer::cDefaultFrameInterval;
+
+FramePacer::FramePacer(uint32_t latencyTarget)
+    : latencyTarget_(std::chrono::milliseconds(latencyTarget))
+{
+    this->reset();
+}
+
+bool FramePacer::isEnabled() const
+{
+    return latencyTarget_ > Clock::duration::zero();
+}
+
+void FramePacer::setLatencyTarget(uint32_t latencyTarget)
+{
+    latencyTarget_ = std::chrono::milliseconds(latencyTarget);
+
+    // queued frames keep their deadlines, the next frame re-anchors the schedule with the new latency
+    anchored_ = false;
+}
+
+void FramePacer::push(uint64_t timestamp, const aasdk::common::DataConstBuffer& buffer, bool droppable, Clock::time_point now)
+{
+    Clock::time_point deadline;
+
+    if(timestamp == 0)
+    {
+        // codec config carries no timestamp, it goes out together with whatever precedes it
+        deadline = frames_.empty() ? now : frames_.back().deadline;
+    }
+    else
+    {
+        if(!anchored_ || timestamp <= lastTimestamp_ || timestamp - lastTimestamp_ > cMaxTimestampGap)
+        {
+            this->anchor(timestamp, now);
+        }
+        else
+        {
+            frameInterval_ = std::chrono::microseconds(timestamp - lastTimestamp_);
+        }
+
+        lastTimestamp_ = timestamp;
+        deadline = anchorTime_ + std::chrono::microseconds(timestamp - anchorTimestamp_);
+
+        if(deadline < now)
+        {
+            ++lateFramesCount_;
+
+            if(droppable)
+            {
+                ++droppedFramesCount_;
+                return;
+            }
+
+            // the network fell behind the schedule, release this frame at once and give the
+            // frames after it a full latency budget again
+            this->anchor(timestamp, now);
+            deadline = now;
+        }
+    }
+
+    if(frames_.size() >= cMaxQueueSize)
+    {
+        // the phone clock runs faster than ours, pull the schedule in rather than grow the queue
+        // an overdue front frame is about to be released anyway, never push the schedule out
+        const auto shift = std::max(frames_.front().deadline - now, Clock::duration::zero());
+        anchorTime_ -= shift;
+        deadline -= shift;
+
+        for(auto& frame : frames_)
+        {
+            frame.deadline -= shift;
+        }
+    }
+
+    Frame frame;
+    frame.timestamp = timestamp;
+    frame.droppable = droppable;
+    frame.deadline = deadline;
+
+    if(!spareBuffers_.empty())
+    {
+        frame.data = std::move(spareBuffers_.back());
+        spareBuffers_.pop_back();
+    }
+
+    frame.data.assign(buffer.cdata, buffer.cdata + buffer.size);
+    frames_.push_back(std::move(frame));
+}
+
+const FramePacer::Frame* FramePacer::pop(Clock::time_point now)
+{
+    while(!frames_.empty() && frames_.front().deadline <= now)
+    {
+        auto& frame = frames_.front();
+
+        // the release itself came late (a stalled strand or decoder), catch up on droppable frames
+        const bool skip = frame.droppable && now - frame.deadline > frameInterval_;
+
+        spareBuffers_.push_back(std::move(currentFrame_.data));
+        currentFrame_ = std::move(frame);
+        frames_.pop_front();
+
+        if(skip)
+        {
+            ++droppedFramesCount_;
+            continue;
+        }
+
+        this->recordPresentation(currentFrame_.timestamp, now);
+        return &currentFrame_;
+    }
+
+    return nullptr;
+}
+
+bool FramePacer::isEmpty() const
+{
+    return frames_.empty();
+}
+
+FramePacer::Clock::time_point FramePacer::getNextDeadline() const
+{
+    return frames_.empty() ? Clock::time_point::max() : frames_.front().deadline;
+}
+
+void FramePacer::reset()
+{
+    while(!frames_.empty())
+    {
+        spareBuffers_.push_back(std::move(frames_.front().data));
+        frames_.pop_front();
+    }
+
+    anchored_ = false;
+    anchorTimestamp_ = 0;
+    lastTimestamp_ = 0;
+    frameInterval_ = std::chrono::microseconds(cDefaultFrameInterval);
+    presented_ = false;
+    lastPresentedTimestamp_ = 0;
+    presentedFramesCount_ = 0;
+    droppedFramesCount_ = 0;
+    lateFramesCount_ = 0;
+    judderCount_ = 0;
+    frameTimesCount_ = 0;
+    frameTimeMean_ = 0;
+    frameTimeM2_ = 0;
+}
+
+uint64_t FramePacer::getPresentedFramesCount() const
+{
+    return presentedFramesCount_;
+}
+
+uint64_t FramePacer::getDroppedFramesCount() const
+{
+    return droppedFramesCount_;
+}
+
+uint64_t FramePacer::getLateFramesCount() const
+{
+    return lateFramesCount_;
+}
+
+uint64_t FramePacer::getJudderCount() const
+{
+    return judderCount_;
+}
+
+double FramePacer::getFrameTimeMean() const
+{
+    return frameTimeMean_;
+}
+
+double FramePacer::getFrameTimeVariance() const
+{
+    return frameTimesCount_ > 1 ? frameTimeM2_ / (frameTimesCount_ - 1) : 0;
+}
+
+void FramePacer::anchor(uint64_t timestamp, Clock::time_point time)
+{
+    anchored_ = true;
+    anchorTimestamp_ = timestamp;
+    anchorTime_ = time + latencyTarget_;
+}
+
+void FramePacer::recordPresentation(uint64_t timestamp, Clock::time_point now)
+{
+    ++presentedFramesCount_;
+
+    if(timestamp == 0)
+    {
+        return;
+    }
+
+    if(presented_ && timestamp > lastPresentedTimestamp_ && timestamp - lastPresentedTimestamp_ <= cMaxTimestampGap)
+    {
+        const double frameTime = std::chrono::duration<double, std::milli>(now - lastPresentationTime_).count();
+        const double expectedFrameTime = (timestamp - lastPresentedTimestamp_) / 1000.0;
+
+        // a frame shown more than half a frame away from its slot is visible as judder
+        if(std::abs(frameTime - expectedFrameTime) > expectedFrameTime / 2)
+        {
+            ++judderCount_;
+        }
+
+        ++frameTimesCount_;
+        const double delta = frameTime - frameTimeMean_;
+        frameTimeMean_ += delta / frameTimesCount_;
+        frameTimeM2_ += delta * (frameTime - frameTimeMean_);
+    }
+
+    presented_ = true;
+    lastPresentedTimestamp_ = timestamp;
+    lastPresentationTime_ = now;
+}
+
+}
+}
+}
+}
@@ -16,8 +16,10 @@
 *  along with openauto. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
 #include <aasdk_proto/InputEventIndicationMessage.pb.h>
 #include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
 #include <f1x/openauto/autoapp/Service/InputService.hpp>
 
 namespace f1x
@@ -29,10 +31,28 @@ namespace autoapp
 namespace service
 {
 
-InputService::InputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice)
+constexpr uint32_t InputService::cLongPressTimeout;
+constexpr float InputService::cMaxAcceleration;
+
+InputService::InputService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice, configuration::IConfiguration::Pointer configuration)
     : strand_(ioService)
+    , coalescingTimer_(ioService)
+    , wheelTimer_(ioService)
+    , longPressTimer_(ioService)
     , channel_(std::make_shared<aasdk::channel::input::InputServiceChannel>(strand_, std::move(messenger)))
     , inputDevice_(std::move(inputDevice))
+    , configuration_(std::move(configuration))
+    , coalescingWindow_(configuration_->getTouchCoalescingWindow())
+    , wheelEventPending_(false)
+    , wheelDelta_(0.0f)
+    , wheelTimestamp_(0)
+    , buttonHeld_(false)
+    , longPressTriggered_(false)
+    , heldButtonCode_(aasdk::proto::enums::ButtonCode::NONE)
+    , dragEventPending_(false)
+    , pendingDragTimestamp_(0)
+    , touchEventsCount_(0)
+    , touchMessagesCount_(0)
 {
 
 }
@@ -41,6 +61,7 @@ void InputService::start()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[InputService] start.";
+        configuration_->subscribe({configuration::Configuration::cInputTouchCoalescingWindowKey}, this->shared_from_this());
         channel_->receive(this->shared_from_this());
     });
 }
@@ -49,7 +70,18 @@ void InputService::stop()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[InputService] stop.";
+        configuration_->unsubscribe(this->shared_from_this());
         inputDevice_->stop();
+        coalescingTimer_.cancel();
+        wheelTimer_.cancel();
+        longPressTimer_.cancel();
+        dragEventPending_ = false;
+        wheelEventPending_ = false;
+        wheelDelta_ = 0.0f;
+        buttonHeld_ = false;
+
+        OPENAUTO_LOG(info) << "[InputService] touch events received: " << touchEventsCount_
+                           << ", touch messages sent: " << touchMessagesCount_;
     });
 }
 
@@ -100,11 +132,10 @@ void InputService::onBindingRequest(const aasdk::proto::messages::BindingRequest
     OPENAUTO_LOG(info) << "[InputService] binding request, scan codes count: " << request.scan_codes_size();
 
     aasdk::proto::enums::Status::Enum status = aasdk::proto::enums::Status::OK;
-    const auto& supportedButtonCodes = inputDevice_->getSupportedButtonCodes();
 
     for(int i = 0; i < request.scan_codes_size(); ++i)
     {
-        if(std::find(supportedButtonCodes.begin(), supportedButtonCodes.end(), request.scan_codes(i)) == supportedButtonCodes.end())
+        if(!inputDevice_->isButtonCodeSupported(static_cast<aasdk::proto::enums::ButtonCode::Enum>(request.scan_codes(i))))
         {
             OPENAUTO_LOG(error) << "[InputService] binding request, scan code: " << request.scan_codes(i)
                                 << " is not supported.";
@@ -140,51 +171,210 @@ void InputService::onButtonEvent(const projection::ButtonEvent& event)
     auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch());
 
     strand_.dispatch([this, self = this->shared_from_this(), event = std::move(event), timestamp = std::move(timestamp)]() {
-        aasdk::proto::messages::InputEventIndication inputEventIndication;
-        inputEventIndication.set_timestamp(timestamp.count());
+        const int32_t tick = event.wheelDirection == projection::WheelDirection::LEFT ? -1 : 1;
 
         if(event.code == aasdk::proto::enums::ButtonCode::SCROLL_WHEEL)
         {
-            auto relativeEvent = inputEventIndication.mutable_relative_input_event()->add_relative_input_events();
-            relativeEvent->set_delta(event.wheelDirection == projection::WheelDirection::LEFT ? -1 : 1);
-            relativeEvent->set_scan_code(event.code);
+            // velocity based acceleration: ticks arriving faster than the threshold rate move further,
+            // the rate is computed per report so a multi-detent report is accelerated once
+            const auto interval = std::max<int64_t>(1, (timestamp - wheelTimestamp_).count());
+            const float ticksPerSecond = event.wheelTicks * 1e6f / interval;
+            const float acceleration = std::min(cMaxAcceleration, std::max(1.0f, ticksPerSecond / cAccelerationThreshold));
+            const float delta = tick * static_cast<float>(event.wheelTicks) * acceleration;
+            wheelTimestamp_ = timestamp;
+
+            if(coalescingWindow_ == 0)
+            {
+                this->sendRelativeEvent(static_cast<int32_t>(std::lround(delta)), timestamp);
+                return;
+            }
+
+            // ticks within one window are summed into a single relative event
+            if(!wheelEventPending_)
+            {
+                wheelEventPending_ = true;
+                wheelTimer_.expires_from_now(boost::posix_time::milliseconds(coalescingWindow_));
+                wheelTimer_.async_wait(strand_.wrap(std::bind(&InputService::onWheelTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+            }
+
+            wheelDelta_ += delta;
         }
         else
         {
-            auto buttonEvent = inputEventIndication.mutable_button_event()->add_button_events();
-            buttonEvent->set_meta(0);
-            buttonEvent->set_is_pressed(event.type == projection::ButtonEventType::PRESS);
-            buttonEvent->set_long_press(false);
-            buttonEvent->set_scan_code(event.code);
+            this->flushWheelTicks();
+
+            const bool pressed = event.type == projection::ButtonEventType::PRESS;
+
+            if(pressed)
+            {
+                buttonHeld_ = true;
+                longPressTriggered_ = false;
+                heldButtonCode_ = event.code;
+                longPressTimer_.expires_from_now(boost::posix_time::milliseconds(cLongPressTimeout));
+                longPressTimer_.async_wait(strand_.wrap(std::bind(&InputService::onLongPressTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+                this->sendButtonEvent(event.code, true, false, timestamp);
+            }
+            else
+            {
+                const bool longPress = buttonHeld_ && heldButtonCode_ == event.code && longPressTriggered_;
+
+                if(buttonHeld_ && heldButtonCode_ == event.code)
+                {
+                    buttonHeld_ = false;
+                    longPressTimer_.cancel();
+                }
+
+                this->sendButtonEvent(event.code, false, longPress, timestamp);
+            }
         }
-
-        auto promise = aasdk::channel::SendPromise::defer(strand_);
-        promise->then([]() {}, std::bind(&InputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
-        channel_->sendInputEventIndication(inputEventIndication, std::move(promise));
     });
 }
 
+void InputService::flushWheelTicks()
+{
+    if(wheelEventPending_)
+    {
+        const int32_t delta = static_cast<int32_t>(std::lround(wheelDelta_));
+
+        wheelEventPending_ = false;
+        wheelDelta_ = 0.0f;
+        wheelTimer_.cancel();
+
+        if(delta != 0)
+        {
+            this->sendRelativeEvent(delta, wheelTimestamp_);
+        }
+    }
+}
+
+void InputService::onWheelTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted)
+    {
+        this->flushWheelTicks();
+    }
+}
+
+void InputService::onLongPressTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted && buttonHeld_ && !longPressTriggered_)
+    {
+        longPressTriggered_ = true;
+
+        auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch());
+        this->sendButtonEvent(heldButtonCode_, true, true, timestamp);
+    }
+}
+
+void InputService::sendButtonEvent(aasdk::proto::enums::ButtonCode::Enum buttonCode, bool pressed, bool longPress, std::chrono::microseconds timestamp)
+{
+    aasdk::proto::messages::InputEventIndication inputEventIndication;
+    inputEventIndication.set_timestamp(timestamp.count());
+
+    auto buttonEvent = inputEventIndication.mutable_button_event()->add_button_events();
+    buttonEvent->set_meta(0);
+    buttonEvent->set_is_pressed(pressed);
+    buttonEvent->set_long_press(longPress);
+    buttonEvent->set_scan_code(buttonCode);
+
+    auto promise = aasdk::channel::SendPromise::defer(strand_);
+    promise->then([]() {}, std::bind(&InputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+    channel_->sendInputEventIndication(inputEventIndication, std::move(promise));
+}
+
+void InputService::sendRelativeEvent(int32_t delta, std::chrono::microseconds timestamp)
+{
+    aasdk::proto::messages::InputEventIndication inputEventIndication;
+    inputEventIndication.set_timestamp(timestamp.count());
+
+    auto relativeEvent = inputEventIndication.mutable_relative_input_event()->add_relative_input_events();
+    relativeEvent->set_delta(delta);
+    relativeEvent->set_scan_code(aasdk::proto::enums::ButtonCode::SCROLL_WHEEL);
+
+    auto promise = aasdk::channel::SendPromise::defer(strand_);
+    promise->then([]() {}, std::bind(&InputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+    channel_->sendInputEventIndication(inputEventIndication, std::move(promise));
+}
+
 void InputService::onTouchEvent(const projection::TouchEvent& event)
 {
     auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now().time_since_epoch());
 
     strand_.dispatch([this, self = this->shared_from_this(), event = std::move(event), timestamp = std::move(timestamp)]() {
-        aasdk::proto::messages::InputEventIndication inputEventIndication;
-        inputEventIndication.set_timestamp(timestamp.count());
+        ++touchEventsCount_;
 
-        auto touchEvent = inputEventIndication.mutable_touch_event();
-        touchEvent->set_touch_action(event.type);
-        auto touchLocation = touchEvent->add_touch_location();
-        touchLocation->set_x(event.x);
-        touchLocation->set_y(event.y);
-        touchLocation->set_pointer_id(0);
+        if(event.type == aasdk::proto::enums::TouchAction::DRAG && coalescingWindow_ > 0)
+        {
+            // drags within one window collapse into the latest position, presses and releases flush it first
+            if(!dragEventPending_)
+            {
+                coalescingTimer_.expires_from_now(boost::posix_time::milliseconds(coalescingWindow_));
+                coalescingTimer_.async_wait(strand_.wrap(std::bind(&InputService::onCoalescingTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+            }
+
+            dragEventPending_ = true;
+            pendingDragEvent_ = event;
+            pendingDragTimestamp_ = timestamp;
+        }
+        else
+        {
+            this->flushPendingDragEvent();
+            this->sendTouchEvent(event, timestamp);
+        }
+    });
+}
 
-        auto promise = aasdk::channel::SendPromise::defer(strand_);
-        promise->then([]() {}, std::bind(&InputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
-        channel_->sendInputEventIndication(inputEventIndication, std::move(promise));
+void InputService::onConfigurationChanged(const ChangedKeys&)
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        // a drag or wheel batch already pending is still flushed on the old window
+        coalescingWindow_ = configuration_->getTouchCoalescingWindow();
+        OPENAUTO_LOG(info) << "[InputService] coalescing window changed: " << coalescingWindow_ << " ms";
     });
 }
 
+void InputService::flushPendingDragEvent()
+{
+    if(dragEventPending_)
+    {
+        dragEventPending_ = false;
+        coalescingTimer_.cancel();
+        this->sendTouchEvent(pendingDragEvent_, pendingDragTimestamp_);
+    }
+}
+
+void InputService::onCoalescingTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted)
+    {
+        this->flushPendingDragEvent();
+    }
+}
+
+void InputService::sendTouchEvent(const projection::TouchEvent& event, std::chrono::microseconds timestamp)
+{
+    ++touchMessagesCount_;
+
+    aasdk::proto::messages::InputEventIndication inputEventIndication;
+    inputEventIndication.set_timestamp(timestamp.count());
+
+    auto touchEvent = inputEventIndication.mutable_touch_event();
+    touchEvent->set_touch_action(event.type);
+    touchEvent->set_action_index(event.actionIndex);
+
+    for(const auto& location : event.locations)
+    {
+        auto touchLocation = touchEvent->add_touch_location();
+        touchLocation->set_x(location.x);
+        touchLocation->set_y(location.y);
+        touchLocation->set_pointer_id(location.pointerId);
+    }
+
+    auto promise = aasdk::channel::SendPromise::defer(strand_);
+    promise->then([]() {}, std::bind(&InputService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+    channel_->sendInputEventIndication(inputEventIndication, std::move(promise));
+}
+
 }
 }
 }
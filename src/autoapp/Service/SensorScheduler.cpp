@@ -0,0 +1,162 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <f1x/openauto/autoapp/Service/SensorScheduler.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+SensorScheduler::SensorScheduler()
+    : samplesCount_(0)
+    , indicationsCount_(0)
+    , sensorEventsCount_(0)
+{
+
+}
+
+void SensorScheduler::setPolicy(aasdk::proto::enums::SensorType::Enum sensorType, const SensorPolicy& policy)
+{
+    sensors_[sensorType].policy = policy;
+}
+
+void SensorScheduler::start(aasdk::proto::enums::SensorType::Enum sensorType)
+{
+    auto& state = sensors_[sensorType];
+    state.started = true;
+    state.lastSent = TimePoint();
+}
+
+void SensorScheduler::reset()
+{
+    for(auto& sensor : sensors_)
+    {
+        sensor.second.started = false;
+        sensor.second.pending = false;
+        sensor.second.hasValue = false;
+        sensor.second.lastSent = TimePoint();
+    }
+}
+
+bool SensorScheduler::submit(aasdk::proto::enums::SensorType::Enum sensorType, double delta)
+{
+    ++samplesCount_;
+
+    auto& state = sensors_[sensorType];
+    state.hasValue = true;
+
+    if(!state.started || delta < state.policy.minDelta)
+    {
+        return false;
+    }
+
+    state.pending = true;
+    return true;
+}
+
+bool SensorScheduler::collect(TimePoint now, SensorTypes& sensorTypes)
+{
+    sensorTypes.clear();
+
+    const bool anyDue = std::any_of(sensors_.begin(), sensors_.end(), [now](const decltype(sensors_)::value_type& sensor) {
+        return getDueTime(sensor.second) <= now;
+    });
+
+    if(!anyDue)
+    {
+        return false;
+    }
+
+    const auto batchEnd = now + std::chrono::milliseconds(cBatchWindow);
+
+    for(auto& sensor : sensors_)
+    {
+        if(getDueTime(sensor.second) <= batchEnd)
+        {
+            sensor.second.pending = false;
+            sensor.second.lastSent = now;
+            sensorTypes.push_back(sensor.first);
+        }
+    }
+
+    ++indicationsCount_;
+    sensorEventsCount_ += sensorTypes.size();
+    return true;
+}
+
+bool SensorScheduler::getNextDeadline(TimePoint& deadline) const
+{
+    bool found = false;
+
+    for(const auto& sensor : sensors_)
+    {
+        const auto dueTime = getDueTime(sensor.second);
+
+        if(dueTime != TimePoint::max() && (!found || dueTime < deadline))
+        {
+            deadline = dueTime;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+uint64_t SensorScheduler::getSamplesCount() const
+{
+    return samplesCount_;
+}
+
+uint64_t SensorScheduler::getIndicationsCount() const
+{
+    return indicationsCount_;
+}
+
+uint64_t SensorScheduler::getSensorEventsCount() const
+{
+    return sensorEventsCount_;
+}
+
+SensorScheduler::TimePoint SensorScheduler::getDueTime(const SensorState& state)
+{
+    if(!state.started)
+    {
+        return TimePoint::max();
+    }
+    else if(state.pending)
+    {
+        return state.lastSent + std::chrono::milliseconds(state.policy.minInterval);
+    }
+    else if(state.hasValue && state.policy.heartbeat > 0)
+    {
+        return state.lastSent + std::chrono::milliseconds(state.policy.heartbeat);
+    }
+
+    return TimePoint::max();
+}
+
+}
+}
+}
+}
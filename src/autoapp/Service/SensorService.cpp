@@ -16,6 +16,9 @@
 *  along with openauto. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <aasdk_proto/DrivingStatusEnum.pb.h>
 #include <f1x/openauto/Common/Log.hpp>
 #include <f1x/openauto/autoapp/Service/SensorService.hpp>
@@ -29,17 +32,46 @@ namespace autoapp
 namespace service
 {
 
-SensorService::SensorService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger)
+namespace
+{
+
+// equirectangular approximation, plenty for the few meters that decide whether a fix is worth sending
+double getDistance(const projection::LocationData& a, const projection::LocationData& b)
+{
+    const double toRadians = M_PI / 180.0 / 1e7;
+    const double earthRadius = 6371000.0;
+    const double x = (b.longitude - a.longitude) * toRadians * std::cos((a.latitude + b.latitude) / 2.0 * toRadians);
+    const double y = (b.latitude - a.latitude) * toRadians;
+    return std::sqrt(x * x + y * y) * earthRadius;
+}
+
+}
+
+SensorService::SensorService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, SensorProviders sensorProviders)
     : strand_(ioService)
+    , updateTimer_(ioService)
     , channel_(std::make_shared<aasdk::channel::sensor::SensorServiceChannel>(strand_, std::move(messenger)))
+    , sensorProviders_(std::move(sensorProviders))
+    , updateTimerArmed_(false)
+    , isNight_(false)
 {
-
+    // minimum interval [ms], minimum delta [m, mm/s, flag], heartbeat [ms]
+    scheduler_.setPolicy(aasdk::proto::enums::SensorType::LOCATION, {100, 0.5, 1000});
+    scheduler_.setPolicy(aasdk::proto::enums::SensorType::CAR_SPEED, {100, 100.0, 1000});
+    scheduler_.setPolicy(aasdk::proto::enums::SensorType::NIGHT_DATA, {1000, 1.0, 0});
+    scheduler_.setPolicy(aasdk::proto::enums::SensorType::DRIVING_STATUS, {0, 0.0, 0});
 }
 
 void SensorService::start()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[SensorService] start.";
+
+        for(auto& sensorProvider : sensorProviders_)
+        {
+            sensorProvider->start(*this);
+        }
+
         channel_->receive(this->shared_from_this());
     });
 }
@@ -48,6 +80,18 @@ void SensorService::stop()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[SensorService] stop.";
+
+        for(auto& sensorProvider : sensorProviders_)
+        {
+            sensorProvider->stop();
+        }
+
+        updateTimer_.cancel();
+
+        OPENAUTO_LOG(info) << "[SensorService] samples received: " << scheduler_.getSamplesCount()
+                           << ", sensor events sent: " << scheduler_.getSensorEventsCount()
+                           << ", indications sent: " << scheduler_.getIndicationsCount();
+        scheduler_.reset();
     });
 }
 
@@ -60,8 +104,17 @@ void SensorService::fillFeatures(aasdk::proto::messages::ServiceDiscoveryRespons
 
     auto* sensorChannel = channelDescriptor->mutable_sensor_channel();
     sensorChannel->add_sensors()->set_type(aasdk::proto::enums::SensorType::DRIVING_STATUS);
-    //sensorChannel->add_sensors()->set_type(aasdk::proto::enums::SensorType::LOCATION);
     sensorChannel->add_sensors()->set_type(aasdk::proto::enums::SensorType::NIGHT_DATA);
+
+    if(this->isSensorAvailable(aasdk::proto::enums::SensorType::LOCATION))
+    {
+        sensorChannel->add_sensors()->set_type(aasdk::proto::enums::SensorType::LOCATION);
+    }
+
+    if(this->isSensorAvailable(aasdk::proto::enums::SensorType::CAR_SPEED))
+    {
+        sensorChannel->add_sensors()->set_type(aasdk::proto::enums::SensorType::CAR_SPEED);
+    }
 }
 
 void SensorService::onChannelOpenRequest(const aasdk::proto::messages::ChannelOpenRequest& request)
@@ -88,44 +141,187 @@ void SensorService::onSensorStartRequest(const aasdk::proto::messages::SensorSta
     response.set_status(aasdk::proto::enums::Status::OK);
 
     auto promise = aasdk::channel::SendPromise::defer(strand_);
+    promise->then(std::bind(&SensorService::onSensorStarted, this->shared_from_this(), request.sensor_type()),
+                  std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+
+    channel_->sendSensorStartResponse(response, std::move(promise));
+    channel_->receive(this->shared_from_this());
+}
+
+void SensorService::onLocationUpdate(const projection::LocationData& location)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), location]() {
+        location_ = location;
+
+        for(auto& sensorProvider : sensorProviders_)
+        {
+            sensorProvider->updateLocation(location);
+        }
+
+        this->submit(aasdk::proto::enums::SensorType::LOCATION);
+    });
+}
+
+void SensorService::onSpeedUpdate(int32_t speed)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), speed]() {
+        speed_ = speed;
+        this->submit(aasdk::proto::enums::SensorType::CAR_SPEED);
+    });
+}
+
+void SensorService::onNightModeUpdate(bool isNight)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), isNight]() {
+        isNight_ = isNight;
+        this->submit(aasdk::proto::enums::SensorType::NIGHT_DATA);
+    });
+}
+
+bool SensorService::isSensorAvailable(aasdk::proto::enums::SensorType::Enum sensorType) const
+{
+    return std::any_of(sensorProviders_.begin(), sensorProviders_.end(), [sensorType](const projection::ISensorProvider::Pointer& sensorProvider) {
+        return sensorProvider->isSensorSupported(sensorType);
+    });
+}
+
+void SensorService::onSensorStarted(aasdk::proto::enums::SensorType::Enum sensorType)
+{
+    scheduler_.start(sensorType);
 
-    if(request.sensor_type() == aasdk::proto::enums::SensorType::DRIVING_STATUS)
+    // the current value goes out right away, later samples are subject to the sensor policy
+    if(sensorType == aasdk::proto::enums::SensorType::DRIVING_STATUS || sensorType == aasdk::proto::enums::SensorType::NIGHT_DATA
+       || (sensorType == aasdk::proto::enums::SensorType::LOCATION && location_) || (sensorType == aasdk::proto::enums::SensorType::CAR_SPEED && speed_))
     {
-        promise->then(std::bind(&SensorService::sendDrivingStatusUnrestricted, this->shared_from_this()),
-                      std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+        scheduler_.submit(sensorType, std::numeric_limits<double>::infinity());
     }
-    else if(request.sensor_type() == aasdk::proto::enums::SensorType::NIGHT_DATA)
+
+    this->flush();
+}
+
+void SensorService::submit(aasdk::proto::enums::SensorType::Enum sensorType)
+{
+    if(scheduler_.submit(sensorType, this->getDelta(sensorType)))
     {
-        promise->then(std::bind(&SensorService::sendNightData, this->shared_from_this()),
-                      std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+        this->flush();
     }
-    else
+}
+
+double SensorService::getDelta(aasdk::proto::enums::SensorType::Enum sensorType) const
+{
+    switch(sensorType)
     {
-        promise->then([]() {}, std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+    case aasdk::proto::enums::SensorType::LOCATION:
+        return sentLocation_ ? getDistance(*location_, *sentLocation_) : std::numeric_limits<double>::infinity();
+
+    case aasdk::proto::enums::SensorType::CAR_SPEED:
+        return sentSpeed_ ? std::abs(*speed_ - *sentSpeed_) : std::numeric_limits<double>::infinity();
+
+    case aasdk::proto::enums::SensorType::NIGHT_DATA:
+        return sentNight_ != isNight_ ? 1.0 : 0.0;
+
+    default:
+        return std::numeric_limits<double>::infinity();
     }
+}
 
-    channel_->sendSensorStartResponse(response, std::move(promise));
-    channel_->receive(this->shared_from_this());
+void SensorService::flush()
+{
+    if(scheduler_.collect(std::chrono::steady_clock::now(), dueSensorTypes_))
+    {
+        // every due sensor travels in the same indication
+        aasdk::proto::messages::SensorEventIndication indication;
+        bool filled = false;
+
+        for(const auto& sensorType : dueSensorTypes_)
+        {
+            filled = this->fillIndication(sensorType, indication) || filled;
+        }
+
+        if(filled)
+        {
+            auto promise = aasdk::channel::SendPromise::defer(strand_);
+            promise->then([]() {}, std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
+            channel_->sendSensorEventIndication(indication, std::move(promise));
+        }
+    }
+
+    this->armUpdateTimer();
 }
 
-void SensorService::sendDrivingStatusUnrestricted()
+bool SensorService::fillIndication(aasdk::proto::enums::SensorType::Enum sensorType, aasdk::proto::messages::SensorEventIndication& indication)
 {
-    aasdk::proto::messages::SensorEventIndication indication;
-    indication.add_driving_status()->set_status(aasdk::proto::enums::DrivingStatus::UNRESTRICTED);
+    switch(sensorType)
+    {
+    case aasdk::proto::enums::SensorType::DRIVING_STATUS:
+        indication.add_driving_status()->set_status(aasdk::proto::enums::DrivingStatus::UNRESTRICTED);
+        return true;
 
-    auto promise = aasdk::channel::SendPromise::defer(strand_);
-    promise->then([]() {}, std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
-    channel_->sendSensorEventIndication(indication, std::move(promise));
+    case aasdk::proto::enums::SensorType::NIGHT_DATA:
+        indication.add_night_mode()->set_is_night(isNight_);
+        sentNight_ = isNight_;
+        return true;
+
+    case aasdk::proto::enums::SensorType::LOCATION:
+    {
+        if(!location_)
+        {
+            return false;
+        }
+
+        auto* gpsLocation = indication.add_gps_location();
+        gpsLocation->set_timestamp(location_->timestamp);
+        gpsLocation->set_latitude(location_->latitude);
+        gpsLocation->set_longitude(location_->longitude);
+        gpsLocation->set_accuracy(location_->accuracy);
+        gpsLocation->set_altitude(location_->altitude);
+        gpsLocation->set_speed(location_->speed);
+        gpsLocation->set_bearing(location_->bearing);
+        sentLocation_ = location_;
+        return true;
+    }
+
+    case aasdk::proto::enums::SensorType::CAR_SPEED:
+        if(!speed_)
+        {
+            return false;
+        }
+
+        indication.add_speed()->set_speed(*speed_);
+        sentSpeed_ = speed_;
+        return true;
+
+    default:
+        return false;
+    }
 }
 
-void SensorService::sendNightData()
+void SensorService::armUpdateTimer()
 {
-    aasdk::proto::messages::SensorEventIndication indication;
-    indication.add_night_mode()->set_is_night(false);
+    SensorScheduler::TimePoint deadline;
 
-    auto promise = aasdk::channel::SendPromise::defer(strand_);
-    promise->then([]() {}, std::bind(&SensorService::onChannelError, this->shared_from_this(), std::placeholders::_1));
-    channel_->sendSensorEventIndication(indication, std::move(promise));
+    if(!scheduler_.getNextDeadline(deadline) || (updateTimerArmed_ && updateTimerDeadline_ <= deadline))
+    {
+        return;
+    }
+
+    const auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+
+    updateTimerArmed_ = true;
+    updateTimerDeadline_ = deadline;
+    updateTimer_.expires_from_now(boost::posix_time::microseconds(std::max<int64_t>(0, timeout.count())));
+    updateTimer_.async_wait(strand_.wrap(std::bind(&SensorService::onUpdateTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+}
+
+void SensorService::onUpdateTimerExpired(const boost::system::error_code& error)
+{
+    if(error == boost::asio::error::operation_aborted)
+    {
+        return;
+    }
+
+    updateTimerArmed_ = false;
+    this->flush();
 }
 
 void SensorService::onChannelError(const aasdk::error::Error& e)
@@ -32,13 +32,25 @@
 #include <f1x/openauto/autoapp/Service/InputService.hpp>
 #include <f1x/openauto/autoapp/Projection/QtVideoOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/OMXVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/DRMVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/SharedMemoryVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/DumpingVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/RtAudioOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/QtAudioOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/AlsaAudioOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/QtAudioInput.hpp>
+#include <f1x/openauto/autoapp/Projection/AudioInputProcessor.hpp>
+#include <f1x/openauto/autoapp/Projection/MixerAudioOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/FocusedAudioOutput.hpp>
 #include <f1x/openauto/autoapp/Projection/InputDevice.hpp>
+#include <f1x/openauto/autoapp/Projection/EvdevInputDevice.hpp>
 #include <f1x/openauto/autoapp/Projection/LocalBluetoothDevice.hpp>
 #include <f1x/openauto/autoapp/Projection/RemoteBluetoothDevice.hpp>
 #include <f1x/openauto/autoapp/Projection/DummyBluetoothDevice.hpp>
+#include <f1x/openauto/autoapp/Projection/NightSensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/NmeaSensorProvider.hpp>
+#include <f1x/openauto/autoapp/Projection/CanSensorProvider.hpp>
 
 namespace f1x
 {
@@ -49,9 +61,10 @@ namespace autoapp
 namespace service
 {
 
-ServiceFactory::ServiceFactory(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration)
+ServiceFactory::ServiceFactory(boost::asio::io_service& ioService, configuration::IConfiguration::Pointer configuration, IAudioFocusArbiter::Pointer audioFocusArbiter)
     : ioService_(ioService)
     , configuration_(std::move(configuration))
+    , audioFocusArbiter_(std::move(audioFocusArbiter))
 {
 
 }
@@ -60,25 +73,40 @@ ServiceList ServiceFactory::create(aasdk::messenger::IMessenger::Pointer messeng
 {
     ServiceList serviceList;
 
+    auto echoReference(std::make_shared<projection::EchoReference>(16000));
     projection::IAudioInput::Pointer audioInput(new projection::QtAudioInput(1, 16, 16000), std::bind(&QObject::deleteLater, std::placeholders::_1));
-    serviceList.emplace_back(std::make_shared<AudioInputService>(ioService_, messenger, std::move(audioInput)));
-    this->createAudioServices(serviceList, messenger);
-    serviceList.emplace_back(std::make_shared<SensorService>(ioService_, messenger));
-    serviceList.emplace_back(this->createVideoService(messenger));
+    auto audioInputProcessor(std::make_shared<projection::AudioInputProcessor>(echoReference, audioInput->getSampleRate()));
+    serviceList.emplace_back(std::make_shared<AudioInputService>(ioService_, messenger, std::move(audioInput), std::move(audioInputProcessor)));
+    this->createAudioServices(serviceList, messenger, echoReference);
+    serviceList.emplace_back(this->createSensorService(messenger));
+
+    // the video service tells the input device which of the advertised configs the phone selected
+    auto inputDevice(this->createInputDevice());
+    serviceList.emplace_back(this->createVideoService(messenger, inputDevice));
     serviceList.emplace_back(this->createBluetoothService(messenger));
-    serviceList.emplace_back(this->createInputService(messenger));
+    serviceList.emplace_back(std::make_shared<InputService>(ioService_, messenger, std::move(inputDevice), configuration_));
 
     return serviceList;
 }
 
-IService::Pointer ServiceFactory::createVideoService(aasdk::messenger::IMessenger::Pointer messenger)
+IService::Pointer ServiceFactory::createVideoService(aasdk::messenger::IMessenger::Pointer messenger, projection::IInputDevice::Pointer inputDevice)
 {
 #ifdef USE_OMX
-    auto videoOutput(std::make_shared<projection::OMXVideoOutput>(configuration_));
+    projection::IVideoOutput::Pointer videoOutput(std::make_shared<projection::OMXVideoOutput>(configuration_));
+#elif defined(USE_SHM)
+    projection::IVideoOutput::Pointer videoOutput(std::make_shared<projection::SharedMemoryVideoOutput>(configuration_));
+#elif defined(USE_DRM)
+    projection::IVideoOutput::Pointer videoOutput(std::make_shared<projection::DRMVideoOutput>(configuration_));
 #else
     projection::IVideoOutput::Pointer videoOutput(new projection::QtVideoOutput(configuration_), std::bind(&QObject::deleteLater, std::placeholders::_1));
 #endif
-    return std::make_shared<VideoService>(ioService_, messenger, std::move(videoOutput));
+
+    if(!configuration_->getVideoDumpFile().empty())
+    {
+        videoOutput = std::make_shared<projection::DumpingVideoOutput>(std::move(videoOutput), configuration_->getVideoDumpFile());
+    }
+
+    return std::make_shared<VideoService>(ioService_, messenger, std::move(videoOutput), std::move(inputDevice), configuration_);
 }
 
 IService::Pointer ServiceFactory::createBluetoothService(aasdk::messenger::IMessenger::Pointer messenger)
@@ -102,56 +130,124 @@ IService::Pointer ServiceFactory::createBluetoothService(aasdk::messenger::IMess
     return std::make_shared<BluetoothService>(ioService_, messenger, std::move(bluetoothDevice));
 }
 
-IService::Pointer ServiceFactory::createInputService(aasdk::messenger::IMessenger::Pointer messenger)
+projection::IInputDevice::Pointer ServiceFactory::createInputDevice()
 {
-    QRect videoGeometry;
-    switch(configuration_->getVideoResolution())
+    // the configured resolution until the phone selects one of the advertised configs
+    QRect videoGeometry(0, 0, projection::VideoOutput::getVideoWidth(configuration_->getVideoResolution()),
+                        projection::VideoOutput::getVideoHeight(configuration_->getVideoResolution()));
+
+    QScreen* screen = QGuiApplication::primaryScreen();
+    QRect screenGeometry = screen == nullptr ? QRect(0, 0, 1, 1) : screen->geometry();
+    projection::IInputDevice::Pointer inputDevice;
+
+#ifdef __linux__
+    if(!configuration_->getEvdevDevices().empty())
     {
-    case aasdk::proto::enums::VideoResolution::_720p:
-        videoGeometry = QRect(0, 0, 1280, 720);
-        break;
+        inputDevice = std::make_shared<projection::EvdevInputDevice>(ioService_, configuration_, std::move(screenGeometry), std::move(videoGeometry));
+    }
+    else
+#endif
+    {
+        inputDevice = std::make_shared<projection::InputDevice>(*QApplication::instance(), configuration_, std::move(screenGeometry), std::move(videoGeometry));
+    }
 
-    case aasdk::proto::enums::VideoResolution::_1080p:
-        videoGeometry = QRect(0, 0, 1920, 1080);
-        break;
+    return inputDevice;
+}
 
-    default:
-        videoGeometry = QRect(0, 0, 800, 480);
-        break;
+IService::Pointer ServiceFactory::createSensorService(aasdk::messenger::IMessenger::Pointer messenger)
+{
+    SensorService::SensorProviders sensorProviders;
+    sensorProviders.emplace_back(std::make_shared<projection::NightSensorProvider>(ioService_, configuration_->getAmbientLightSensor()));
+
+    if(!configuration_->getNmeaSource().empty())
+    {
+        sensorProviders.emplace_back(std::make_shared<projection::NmeaSensorProvider>(ioService_, configuration_->getNmeaSource()));
     }
 
-    QScreen* screen = QGuiApplication::primaryScreen();
-    QRect screenGeometry = screen == nullptr ? QRect(0, 0, 1, 1) : screen->geometry();
-    projection::IInputDevice::Pointer inputDevice(std::make_shared<projection::InputDevice>(*QApplication::instance(), configuration_, std::move(screenGeometry), std::move(videoGeometry)));
+#ifdef __linux__
+    if(!configuration_->getCanInterface().empty())
+    {
+        sensorProviders.emplace_back(std::make_shared<projection::CanSensorProvider>(ioService_, configuration_->getCanInterface()));
+    }
+#endif
 
-    return std::make_shared<InputService>(ioService_, messenger, std::move(inputDevice));
+    return std::make_shared<SensorService>(ioService_, messenger, std::move(sensorProviders));
 }
 
-void ServiceFactory::createAudioServices(ServiceList& serviceList, aasdk::messenger::IMessenger::Pointer messenger)
+void ServiceFactory::createAudioServices(ServiceList& serviceList, aasdk::messenger::IMessenger::Pointer messenger, projection::EchoReference::Pointer echoReference)
 {
+    auto audioMixer = configuration_->audioMixerEnabled() ? this->createAudioMixer(echoReference) : nullptr;
+
     if(configuration_->musicAudioChannelEnabled())
     {
-        auto mediaAudioOutput = configuration_->getAudioOutputBackendType() == configuration::AudioOutputBackendType::RTAUDIO ?
-                    std::make_shared<projection::RtAudioOutput>(2, 16, 48000) :
-                    projection::IAudioOutput::Pointer(new projection::QtAudioOutput(2, 16, 48000), std::bind(&QObject::deleteLater, std::placeholders::_1));
-
-        serviceList.emplace_back(std::make_shared<MediaAudioService>(ioService_, messenger, std::move(mediaAudioOutput)));
+        auto mediaAudioOutput = this->createAudioOutput(projection::AudioMixerChannelType::MEDIA, 2, 48000, audioMixer, echoReference);
+        auto focusedAudioOutput = this->createFocusedAudioOutput(aasdk::messenger::ChannelId::MEDIA_AUDIO, std::move(mediaAudioOutput));
+        serviceList.emplace_back(std::make_shared<MediaAudioService>(ioService_, messenger, std::move(focusedAudioOutput)));
     }
 
     if(configuration_->speechAudioChannelEnabled())
     {
-        auto speechAudioOutput = configuration_->getAudioOutputBackendType() == configuration::AudioOutputBackendType::RTAUDIO ?
-                    std::make_shared<projection::RtAudioOutput>(1, 16, 16000) :
-                    projection::IAudioOutput::Pointer(new projection::QtAudioOutput(1, 16, 16000), std::bind(&QObject::deleteLater, std::placeholders::_1));
+        auto speechAudioOutput = this->createAudioOutput(projection::AudioMixerChannelType::SPEECH, 1, 16000, audioMixer, echoReference);
+        auto focusedAudioOutput = this->createFocusedAudioOutput(aasdk::messenger::ChannelId::SPEECH_AUDIO, std::move(speechAudioOutput));
+        serviceList.emplace_back(std::make_shared<SpeechAudioService>(ioService_, messenger, std::move(focusedAudioOutput)));
+    }
 
-        serviceList.emplace_back(std::make_shared<SpeechAudioService>(ioService_, messenger, std::move(speechAudioOutput)));
+    auto systemAudioOutput = this->createAudioOutput(projection::AudioMixerChannelType::SYSTEM, 1, 16000, audioMixer, echoReference);
+    auto focusedAudioOutput = this->createFocusedAudioOutput(aasdk::messenger::ChannelId::SYSTEM_AUDIO, std::move(systemAudioOutput));
+    serviceList.emplace_back(std::make_shared<SystemAudioService>(ioService_, messenger, std::move(focusedAudioOutput)));
+}
+
+projection::IAudioOutput::Pointer ServiceFactory::createFocusedAudioOutput(aasdk::messenger::ChannelId channelId, projection::IAudioOutput::Pointer audioOutput)
+{
+    auto focusedAudioOutput(std::make_shared<projection::FocusedAudioOutput>(std::move(audioOutput)));
+    audioFocusArbiter_->registerOutput(channelId, focusedAudioOutput);
+    return focusedAudioOutput;
+}
+
+projection::IAudioOutput::Pointer ServiceFactory::createAudioOutput(projection::AudioMixerChannelType type, uint32_t channelCount, uint32_t sampleRate, projection::AudioMixer::Pointer audioMixer,
+                                                                   projection::EchoReference::Pointer echoReference)
+{
+    if(audioMixer != nullptr)
+    {
+        return std::make_shared<projection::MixerAudioOutput>(std::move(audioMixer), type, channelCount, 16, sampleRate, 1.0f);
+    }
+    else
+    {
+        return this->createAudioBackendOutput(channelCount, sampleRate, std::move(echoReference), nullptr);
     }
+}
+
+projection::AudioMixer::Pointer ServiceFactory::createAudioMixer(projection::EchoReference::Pointer echoReference)
+{
+    // the mixer taps the echo reference itself, its output pulls the mix through the configured backend
+    auto audioMixer(std::make_shared<projection::AudioMixer>(48000, 0.25f, configuration_->getResamplerQuality(), std::move(echoReference)));
+    audioMixer->setOutput(this->createAudioBackendOutput(audioMixer->getChannelCount(), audioMixer->getSampleRate(), nullptr, audioMixer));
+    return audioMixer;
+}
 
-    auto systemAudioOutput = configuration_->getAudioOutputBackendType() == configuration::AudioOutputBackendType::RTAUDIO ?
-                std::make_shared<projection::RtAudioOutput>(1, 16, 16000) :
-                projection::IAudioOutput::Pointer(new projection::QtAudioOutput(1, 16, 16000), std::bind(&QObject::deleteLater, std::placeholders::_1));
+projection::IAudioOutput::Pointer ServiceFactory::createAudioBackendOutput(uint32_t channelCount, uint32_t sampleRate, projection::EchoReference::Pointer echoReference, projection::IAudioSource::Pointer source)
+{
+#ifdef USE_ALSA
+    if(configuration_->getAudioOutputBackendType() == configuration::AudioOutputBackendType::ALSA)
+    {
+        auto audioOutput(std::make_shared<projection::AlsaAudioOutput>(channelCount, 16, sampleRate, configuration_->getResamplerQuality(), std::move(echoReference)));
+        audioOutput->setSource(std::move(source));
+        return audioOutput;
+    }
+#endif
 
-    serviceList.emplace_back(std::make_shared<SystemAudioService>(ioService_, messenger, std::move(systemAudioOutput)));
+    if(configuration_->getAudioOutputBackendType() != configuration::AudioOutputBackendType::QT)
+    {
+        auto audioOutput(std::make_shared<projection::RtAudioOutput>(channelCount, 16, sampleRate, configuration_->getResamplerQuality(), std::move(echoReference)));
+        audioOutput->setSource(std::move(source));
+        return audioOutput;
+    }
+    else
+    {
+        auto audioOutput(new projection::QtAudioOutput(channelCount, 16, sampleRate, configuration_->getResamplerQuality(), std::move(echoReference)));
+        audioOutput->setSource(std::move(source));
+        return projection::IAudioOutput::Pointer(audioOutput, std::bind(&QObject::deleteLater, std::placeholders::_1));
+    }
 }
 
 }
@@ -0,0 +1,114 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <f1x/openauto/autoapp/Service/FramePacer.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+namespace ut
+{
+
+namespace
+{
+
+const aasdk::common::Data cFrameData(16, 0xA5);
+
+}
+
+BOOST_AUTO_TEST_CASE(FramePacer_LateReferenceFrameIsReleasedAtOnce)
+{
+    const auto start = FramePacer::Clock::time_point();
+    const auto latency = std::chrono::milliseconds(50);
+    FramePacer pacer(50);
+
+    pacer.push(1000000, aasdk::common::DataConstBuffer(cFrameData), false, start);
+    BOOST_CHECK(pacer.getNextDeadline() == start + latency);
+    BOOST_REQUIRE(pacer.pop(start + latency) != nullptr);
+
+    // 100 ms of stream time arriving 200 ms later is 50 ms past its slot
+    const auto late = start + std::chrono::milliseconds(200);
+    pacer.push(1100000, aasdk::common::DataConstBuffer(cFrameData), false, late);
+    BOOST_CHECK_EQUAL(pacer.getLateFramesCount(), 1u);
+    BOOST_CHECK(pacer.getNextDeadline() == late);
+    BOOST_REQUIRE(pacer.pop(late) != nullptr);
+
+    // the frame after it gets the full latency budget again
+    pacer.push(1116667, aasdk::common::DataConstBuffer(cFrameData), false, late);
+    BOOST_CHECK(pacer.getNextDeadline() == late + latency + std::chrono::microseconds(16667));
+}
+
+BOOST_AUTO_TEST_CASE(FramePacer_LateDroppableFrameIsSkipped)
+{
+    const auto start = FramePacer::Clock::time_point();
+    FramePacer pacer(50);
+
+    pacer.push(1000000, aasdk::common::DataConstBuffer(cFrameData), false, start);
+    pacer.push(1100000, aasdk::common::DataConstBuffer(cFrameData), true, start + std::chrono::milliseconds(200));
+
+    BOOST_CHECK_EQUAL(pacer.getDroppedFramesCount(), 1u);
+    BOOST_REQUIRE(pacer.pop(start + std::chrono::milliseconds(200)) != nullptr);
+    BOOST_CHECK(pacer.isEmpty());
+}
+
+// The queue is full while its front is already overdue, pulling the schedule in must not push it out.
+BOOST_AUTO_TEST_CASE(FramePacer_FullQueueWithOverdueFrontKeepsDeadlines)
+{
+    const auto start = FramePacer::Clock::time_point();
+    FramePacer pacer(50);
+
+    for(uint64_t i = 0; i < 16; ++i)
+    {
+        pacer.push(1000000 + i * 1000, aasdk::common::DataConstBuffer(cFrameData), false, start);
+    }
+
+    const auto firstDeadline = pacer.getNextDeadline();
+    const auto now = firstDeadline + std::chrono::milliseconds(10);
+    pacer.push(1016000, aasdk::common::DataConstBuffer(cFrameData), false, now);
+
+    BOOST_CHECK(pacer.getNextDeadline() == firstDeadline);
+}
+
+// The queue is full and its front is still ahead, the schedule is pulled in to release it now.
+BOOST_AUTO_TEST_CASE(FramePacer_FullQueuePullsScheduleIn)
+{
+    const auto start = FramePacer::Clock::time_point();
+    FramePacer pacer(50);
+
+    for(uint64_t i = 0; i < 16; ++i)
+    {
+        pacer.push(1000000 + i * 1000, aasdk::common::DataConstBuffer(cFrameData), false, start);
+    }
+
+    const auto now = start + std::chrono::milliseconds(20);
+    pacer.push(1016000, aasdk::common::DataConstBuffer(cFrameData), false, now);
+
+    BOOST_CHECK(pacer.getNextDeadline() == now);
+}
+
+}
+}
+}
+}
+}
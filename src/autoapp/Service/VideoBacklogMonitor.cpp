@@ -0,0 +1,159 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/Service/VideoBacklogMonitor.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace service
+{
+
+VideoBacklogMonitor::VideoBacklogMonitor()
+{
+    this->reset();
+}
+
+bool VideoBacklogMonitor::submit(VideoFrameType frameType, float backlog)
+{
+    ++framesCount_;
+
+    if(backlog >= cOverflow)
+    {
+        this->setState(State::RESYNC, backlog);
+    }
+    else if(state_ == State::NORMAL && backlog >= cHighWatermark)
+    {
+        this->setState(State::DEGRADED, backlog);
+    }
+
+    bool forward = true;
+
+    switch(frameType)
+    {
+    case VideoFrameType::IDR:
+        this->setState(backlog <= cLowWatermark ? State::NORMAL : State::DEGRADED, backlog);
+        break;
+
+    case VideoFrameType::REFERENCE:
+        forward = state_ != State::RESYNC;
+        break;
+
+    case VideoFrameType::NON_REFERENCE:
+        forward = state_ == State::NORMAL;
+        break;
+
+    case VideoFrameType::OTHER:
+        break;
+    }
+
+    if(!forward)
+    {
+        ++droppedFramesCount_;
+    }
+
+    return forward;
+}
+
+bool VideoBacklogMonitor::canAcknowledge(float backlog) const
+{
+    return backlog < cHighWatermark;
+}
+
+void VideoBacklogMonitor::requestResync()
+{
+    state_ = State::RESYNC;
+}
+
+bool VideoBacklogMonitor::isResyncing() const
+{
+    return state_ == State::RESYNC;
+}
+
+void VideoBacklogMonitor::reset()
+{
+    state_ = State::NORMAL;
+    framesCount_ = 0;
+    droppedFramesCount_ = 0;
+    degradationsCount_ = 0;
+}
+
+uint64_t VideoBacklogMonitor::getFramesCount() const
+{
+    return framesCount_;
+}
+
+uint64_t VideoBacklogMonitor::getDroppedFramesCount() const
+{
+    return droppedFramesCount_;
+}
+
+uint64_t VideoBacklogMonitor::getDegradationsCount() const
+{
+    return degradationsCount_;
+}
+
+VideoFrameType VideoBacklogMonitor::getFrameType(const projection::AccessUnit& accessUnit)
+{
+    if(accessUnit.isIDR)
+    {
+        return VideoFrameType::IDR;
+    }
+    else if(accessUnit.hasSlice)
+    {
+        return accessUnit.isReference ? VideoFrameType::REFERENCE : VideoFrameType::NON_REFERENCE;
+    }
+    else
+    {
+        return VideoFrameType::OTHER;
+    }
+}
+
+void VideoBacklogMonitor::setState(State state, float backlog)
+{
+    if(state == state_)
+    {
+        return;
+    }
+
+    if(state == State::DEGRADED && state_ == State::NORMAL)
+    {
+        ++degradationsCount_;
+        OPENAUTO_LOG(warning) << "[VideoBacklogMonitor] quality degraded, backlog: " << backlog << ", dropping non-reference frames until IDR.";
+    }
+    else if(state == State::RESYNC)
+    {
+        ++degradationsCount_;
+        OPENAUTO_LOG(warning) << "[VideoBacklogMonitor] video data lost, dropping frames until IDR.";
+    }
+    else if(state == State::NORMAL)
+    {
+        OPENAUTO_LOG(info) << "[VideoBacklogMonitor] quality restored, backlog: " << backlog;
+    }
+
+    state_ = state;
+}
+
+}
+}
+}
+}
@@ -16,7 +16,11 @@
 *  along with openauto. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cmath>
 #include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoOutput.hpp>
 #include <f1x/openauto/autoapp/Service/VideoService.hpp>
 
 namespace f1x
@@ -28,11 +32,33 @@ namespace autoapp
 namespace service
 {
 
-VideoService::VideoService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IVideoOutput::Pointer videoOutput)
+constexpr uint32_t VideoService::cAckPollInterval;
+constexpr uint32_t VideoService::cMaxAckDelay;
+constexpr uint32_t VideoService::cKeyframeRequestInterval;
+constexpr uint32_t VideoService::cMaxKeyframeRequestInterval;
+constexpr uint32_t VideoService::cMaxKeyframeRequests;
+
+VideoService::VideoService(boost::asio::io_service& ioService, aasdk::messenger::IMessenger::Pointer messenger, projection::IVideoOutput::Pointer videoOutput, projection::IInputDevice::Pointer inputDevice,
+                           configuration::IConfiguration::Pointer configuration)
     : strand_(ioService)
     , channel_(std::make_shared<aasdk::channel::av::VideoServiceChannel>(strand_, std::move(messenger)))
     , videoOutput_(std::move(videoOutput))
+    , inputDevice_(std::move(inputDevice))
+    , configuration_(std::move(configuration))
     , session_(-1)
+    , framePacer_(configuration_->getVideoLatencyTarget())
+    , pacingTimer_(ioService)
+    , ackTimer_(ioService)
+    , pendingAcks_(0)
+    , deferredAcksCount_(0)
+    , recoveryTimer_(ioService)
+    , recovering_(false)
+    , awaitingFirstIDR_(false)
+    , keyframeRequestsCount_(0)
+    , decodeErrorsCount_(0)
+    , recoveriesCount_(0)
+    , recoveryTimeTotal_(0)
+    , recoveryTimeMax_(0)
 {
 
 }
@@ -41,6 +67,7 @@ void VideoService::start()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
         OPENAUTO_LOG(info) << "[VideoService] start.";
+        configuration_->subscribe({configuration::Configuration::cVideoLatencyTargetKey}, this->shared_from_this());
         channel_->receive(this->shared_from_this());
     });
 }
@@ -48,7 +75,29 @@ void VideoService::start()
 void VideoService::stop()
 {
     strand_.dispatch([this, self = this->shared_from_this()]() {
-        OPENAUTO_LOG(info) << "[VideoService] stop.";
+        OPENAUTO_LOG(info) << "[VideoService] stop, frames: " << backlogMonitor_.getFramesCount()
+                           << ", dropped: " << backlogMonitor_.getDroppedFramesCount()
+                           << ", degradations: " << backlogMonitor_.getDegradationsCount()
+                           << ", deferred acks: " << deferredAcksCount_
+                           << ", recoveries: " << recoveriesCount_
+                           << ", avg recovery time: " << (recoveriesCount_ > 0 ? recoveryTimeTotal_ / static_cast<int64_t>(recoveriesCount_) : 0) << " ms"
+                           << ", max recovery time: " << recoveryTimeMax_ << " ms";
+
+        if(framePacer_.isEnabled())
+        {
+            OPENAUTO_LOG(info) << "[VideoService] pacing, presented: " << framePacer_.getPresentedFramesCount()
+                               << ", late: " << framePacer_.getLateFramesCount()
+                               << ", dropped: " << framePacer_.getDroppedFramesCount()
+                               << ", judder: " << framePacer_.getJudderCount()
+                               << ", frame time: " << framePacer_.getFrameTimeMean() << " ms"
+                               << ", frame time stddev: " << std::sqrt(framePacer_.getFrameTimeVariance()) << " ms";
+        }
+
+        configuration_->unsubscribe(this->shared_from_this());
+        framePacer_.reset();
+        pacingTimer_.cancel();
+        ackTimer_.cancel();
+        recoveryTimer_.cancel();
         videoOutput_->stop();
     });
 }
@@ -72,13 +121,33 @@ void VideoService::onChannelOpenRequest(const aasdk::proto::messages::ChannelOpe
 void VideoService::onAVChannelSetupRequest(const aasdk::proto::messages::AVChannelSetupRequest& request)
 {
     OPENAUTO_LOG(info) << "[VideoService] setup request, config index: " << request.config_index();
-    const aasdk::proto::enums::AVChannelSetupStatus::Enum status = videoOutput_->init() ? aasdk::proto::enums::AVChannelSetupStatus::OK : aasdk::proto::enums::AVChannelSetupStatus::FAIL;
+
+    const auto configIndex = request.config_index();
+    const bool isConfigValid = configIndex < videoConfigs_.size();
+
+    if(isConfigValid)
+    {
+        const auto& videoConfig = videoConfigs_[configIndex];
+        OPENAUTO_LOG(info) << "[VideoService] selected config, resolution: " << videoConfig.resolution
+                           << ", fps: " << videoConfig.fps
+                           << ", dpi: " << videoConfig.dpi;
+
+        // the phone renders its UI at the selected resolution, touches have to be mapped into the same space
+        inputDevice_->setDisplayGeometry(QRect(0, 0, projection::VideoOutput::getVideoWidth(videoConfig.resolution),
+                                               projection::VideoOutput::getVideoHeight(videoConfig.resolution)));
+    }
+    else
+    {
+        OPENAUTO_LOG(error) << "[VideoService] config index out of range, advertised configs: " << videoConfigs_.size();
+    }
+
+    const aasdk::proto::enums::AVChannelSetupStatus::Enum status = isConfigValid && videoOutput_->init() ? aasdk::proto::enums::AVChannelSetupStatus::OK : aasdk::proto::enums::AVChannelSetupStatus::FAIL;
     OPENAUTO_LOG(info) << "[VideoService] setup status: " << status;
 
     aasdk::proto::messages::AVChannelSetupResponse response;
     response.set_media_status(status);
     response.set_max_unacked(1);
-    response.add_configs(0);
+    response.add_configs(isConfigValid ? configIndex : 0);
 
     auto promise = aasdk::channel::SendPromise::defer(strand_);
     promise->then(std::bind(&VideoService::sendVideoFocusIndication, this->shared_from_this()),
@@ -91,38 +160,240 @@ void VideoService::onAVChannelStartIndication(const aasdk::proto::messages::AVCh
 {
     OPENAUTO_LOG(info) << "[VideoService] start indication, session: " << indication.session();
     session_ = indication.session();
+    backlogMonitor_.reset();
+    framePacer_.reset();
+    deferredAcksCount_ = 0;
+    recoveriesCount_ = 0;
+    recoveryTimeTotal_ = 0;
+    recoveryTimeMax_ = 0;
+    decodeErrorsCount_ = videoOutput_->getDecodeErrorsCount();
+
+    // Nothing decodes before the first IDR. The setup response has just sent a focus
+    // indication, so a keyframe is only asked for again if none shows up in time.
+    backlogMonitor_.requestResync();
+    recovering_ = true;
+    awaitingFirstIDR_ = true;
+    keyframeRequestsCount_ = 1;
+    recoveryTimestamp_ = std::chrono::steady_clock::now();
+    recoveryTimer_.expires_from_now(boost::posix_time::milliseconds(cKeyframeRequestInterval));
+    recoveryTimer_.async_wait(strand_.wrap(std::bind(&VideoService::onRecoveryTimerExpired, this->shared_from_this(), std::placeholders::_1)));
 
     channel_->receive(this->shared_from_this());
 }
 
 void VideoService::onAVMediaWithTimestampIndication(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer)
 {
-    videoOutput_->write(timestamp, buffer);
+    this->writeFrame(timestamp, buffer);
+    this->acknowledgeFrame();
+    channel_->receive(this->shared_from_this());
+}
 
-    aasdk::proto::messages::AVMediaAckIndication indication;
-    indication.set_session(session_);
-    indication.set_value(1);
+void VideoService::onAVMediaIndication(const aasdk::common::DataConstBuffer& buffer)
+{
+    this->writeFrame(0, buffer);
+    this->acknowledgeFrame();
+    channel_->receive(this->shared_from_this());
+}
 
-    auto promise = aasdk::channel::SendPromise::defer(strand_);
-    promise->then([]() {}, std::bind(&VideoService::onChannelError, this->shared_from_this(), std::placeholders::_1));
-    channel_->sendAVMediaAckIndication(indication, std::move(promise));
+void VideoService::writeFrame(aasdk::messenger::Timestamp::ValueType timestamp, const aasdk::common::DataConstBuffer& buffer)
+{
+    accessUnits_.clear();
+    projection::NalParser::parse(timestamp, buffer, accessUnits_);
+
+    const auto decodeErrorsCount = videoOutput_->getDecodeErrorsCount();
+    if(decodeErrorsCount != decodeErrorsCount_)
+    {
+        decodeErrorsCount_ = decodeErrorsCount;
+        this->startRecovery("decoder error");
+    }
+
+    for(const auto& accessUnit : accessUnits_)
+    {
+        if(accessUnit.hasError)
+        {
+            this->startRecovery("malformed access unit");
+            continue;
+        }
+
+        const auto frameType = VideoBacklogMonitor::getFrameType(accessUnit);
+        if(backlogMonitor_.submit(frameType, videoOutput_->getBacklog()))
+        {
+            this->presentFrame(accessUnit, frameType);
+        }
+
+        if(backlogMonitor_.isResyncing())
+        {
+            this->startRecovery("video data lost");
+        }
+        else if(recovering_)
+        {
+            this->finishRecovery();
+        }
+    }
+}
 
-    channel_->receive(this->shared_from_this());
+void VideoService::presentFrame(const projection::AccessUnit& accessUnit, VideoFrameType frameType)
+{
+    // frames still queued from before pacing was switched off go out first
+    if(!framePacer_.isEnabled() && framePacer_.isEmpty())
+    {
+        videoOutput_->write(accessUnit.timestamp, accessUnit.buffer);
+        return;
+    }
+
+    framePacer_.push(accessUnit.timestamp, accessUnit.buffer, frameType == VideoFrameType::NON_REFERENCE, FramePacer::Clock::now());
+    this->releaseFrames();
 }
 
-void VideoService::onAVMediaIndication(const aasdk::common::DataConstBuffer& buffer)
+void VideoService::releaseFrames()
+{
+    const auto now = FramePacer::Clock::now();
+
+    while(const auto frame = framePacer_.pop(now))
+    {
+        videoOutput_->write(frame->timestamp, aasdk::common::DataConstBuffer(frame->data));
+    }
+
+    if(!framePacer_.isEmpty())
+    {
+        const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(framePacer_.getNextDeadline() - now);
+        pacingTimer_.expires_from_now(boost::posix_time::microseconds(delay.count()));
+        pacingTimer_.async_wait(strand_.wrap(std::bind(&VideoService::onPacingTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+}
+
+void VideoService::onPacingTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted)
+    {
+        this->releaseFrames();
+    }
+}
+
+void VideoService::acknowledgeFrame()
+{
+    // The phone encodes the next frame only once the previous one is acked, so
+    // holding the ack back while the decoder is behind throttles the source.
+    if(++pendingAcks_ > 1)
+    {
+        return;
+    }
+
+    if(backlogMonitor_.canAcknowledge(videoOutput_->getBacklog()))
+    {
+        this->sendMediaAckIndication();
+    }
+    else
+    {
+        ++deferredAcksCount_;
+        ackDeferredTimestamp_ = std::chrono::steady_clock::now();
+        ackTimer_.expires_from_now(boost::posix_time::milliseconds(cAckPollInterval));
+        ackTimer_.async_wait(strand_.wrap(std::bind(&VideoService::onAckTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+}
+
+void VideoService::onAckTimerExpired(const boost::system::error_code& error)
+{
+    if(error == boost::asio::error::operation_aborted || pendingAcks_ == 0)
+    {
+        return;
+    }
+
+    const auto deferredTime = std::chrono::steady_clock::now() - ackDeferredTimestamp_;
+
+    if(backlogMonitor_.canAcknowledge(videoOutput_->getBacklog()) || deferredTime >= std::chrono::milliseconds(cMaxAckDelay))
+    {
+        this->sendMediaAckIndication();
+    }
+    else
+    {
+        ackTimer_.expires_from_now(boost::posix_time::milliseconds(cAckPollInterval));
+        ackTimer_.async_wait(strand_.wrap(std::bind(&VideoService::onAckTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+}
+
+void VideoService::startRecovery(const std::string& reason)
 {
-    videoOutput_->write(0, buffer);
+    backlogMonitor_.requestResync();
 
+    if(recovering_)
+    {
+        return;
+    }
+
+    OPENAUTO_LOG(warning) << "[VideoService] " << reason << ", discarding frames until IDR.";
+
+    recovering_ = true;
+    awaitingFirstIDR_ = false;
+    keyframeRequestsCount_ = 0;
+    recoveryTimestamp_ = std::chrono::steady_clock::now();
+    this->requestKeyframe();
+}
+
+void VideoService::requestKeyframe()
+{
+    // A phone that ignored this many requests will not answer the next one either. Frames are
+    // still discarded until an IDR arrives, but the focus is no longer toggled under the user.
+    if(keyframeRequestsCount_ >= cMaxKeyframeRequests)
+    {
+        OPENAUTO_LOG(error) << "[VideoService] no IDR after " << keyframeRequestsCount_ << " keyframe requests, giving up on requesting one.";
+        return;
+    }
+
+    // The phone answers a focus indication with a fresh IDR. If a plain repeat is
+    // ignored, losing and regaining focus forces the encoder to restart.
+    if(keyframeRequestsCount_++ > 0)
+    {
+        this->sendVideoFocusModeIndication(aasdk::proto::enums::VideoFocusMode::UNFOCUSED);
+    }
+
+    this->sendVideoFocusModeIndication(aasdk::proto::enums::VideoFocusMode::FOCUSED);
+
+    // every unanswered request doubles the wait for the next one
+    const uint32_t interval = std::min(cMaxKeyframeRequestInterval, cKeyframeRequestInterval << std::min<uint32_t>(keyframeRequestsCount_ - 1, 8));
+    recoveryTimer_.expires_from_now(boost::posix_time::milliseconds(interval));
+    recoveryTimer_.async_wait(strand_.wrap(std::bind(&VideoService::onRecoveryTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+}
+
+void VideoService::finishRecovery()
+{
+    recovering_ = false;
+    recoveryTimer_.cancel();
+
+    const auto recoveryTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - recoveryTimestamp_).count();
+
+    if(awaitingFirstIDR_)
+    {
+        OPENAUTO_LOG(info) << "[VideoService] first IDR after " << recoveryTime << " ms.";
+        return;
+    }
+
+    ++recoveriesCount_;
+    recoveryTimeTotal_ += recoveryTime;
+    recoveryTimeMax_ = std::max(recoveryTimeMax_, static_cast<int64_t>(recoveryTime));
+
+    OPENAUTO_LOG(info) << "[VideoService] recovered in " << recoveryTime << " ms, keyframe requests: " << keyframeRequestsCount_;
+}
+
+void VideoService::onRecoveryTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted && recovering_)
+    {
+        OPENAUTO_LOG(warning) << "[VideoService] no IDR yet, keyframe requests: " << keyframeRequestsCount_;
+        this->requestKeyframe();
+    }
+}
+
+void VideoService::sendMediaAckIndication()
+{
     aasdk::proto::messages::AVMediaAckIndication indication;
     indication.set_session(session_);
-    indication.set_value(1);
+    indication.set_value(pendingAcks_);
+    pendingAcks_ = 0;
 
     auto promise = aasdk::channel::SendPromise::defer(strand_);
     promise->then([]() {}, std::bind(&VideoService::onChannelError, this->shared_from_this(), std::placeholders::_1));
     channel_->sendAVMediaAckIndication(indication, std::move(promise));
-
-    channel_->receive(this->shared_from_this());
 }
 
 void VideoService::onChannelError(const aasdk::error::Error& e)
@@ -130,6 +401,15 @@ void VideoService::onChannelError(const aasdk::error::Error& e)
     OPENAUTO_LOG(error) << "[VideoService] channel error: " << e.what();
 }
 
+void VideoService::onConfigurationChanged(const ChangedKeys&)
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        const auto latencyTarget = configuration_->getVideoLatencyTarget();
+        OPENAUTO_LOG(info) << "[VideoService] latency target changed: " << latencyTarget << " ms";
+        framePacer_.setLatencyTarget(latencyTarget);
+    });
+}
+
 void VideoService::fillFeatures(aasdk::proto::messages::ServiceDiscoveryResponse& response)
 {
     OPENAUTO_LOG(info) << "[VideoService] fill features.";
@@ -141,14 +421,17 @@ void VideoService::fillFeatures(aasdk::proto::messages::ServiceDiscoveryResponse
     videoChannel->set_stream_type(aasdk::proto::enums::AVStreamType::VIDEO);
     videoChannel->set_available_while_in_call(true);
 
-    auto* videoConfig1 = videoChannel->add_video_configs();
-    videoConfig1->set_video_resolution(videoOutput_->getVideoResolution());
-    videoConfig1->set_video_fps(videoOutput_->getVideoFPS());
-
-    const auto& videoMargins = videoOutput_->getVideoMargins();
-    videoConfig1->set_margin_height(videoMargins.height());
-    videoConfig1->set_margin_width(videoMargins.width());
-    videoConfig1->set_dpi(videoOutput_->getScreenDPI());
+    videoConfigs_ = videoOutput_->getVideoConfigs();
+
+    for(const auto& videoConfig : videoConfigs_)
+    {
+        auto* videoConfigDescriptor = videoChannel->add_video_configs();
+        videoConfigDescriptor->set_video_resolution(videoConfig.resolution);
+        videoConfigDescriptor->set_video_fps(videoConfig.fps);
+        videoConfigDescriptor->set_margin_height(videoConfig.margins.height());
+        videoConfigDescriptor->set_margin_width(videoConfig.margins.width());
+        videoConfigDescriptor->set_dpi(videoConfig.dpi);
+    }
 }
 
 void VideoService::onVideoFocusRequest(const aasdk::proto::messages::VideoFocusRequest& request)
@@ -163,10 +446,15 @@ void VideoService::onVideoFocusRequest(const aasdk::proto::messages::VideoFocusR
 
 void VideoService::sendVideoFocusIndication()
 {
-    OPENAUTO_LOG(info) << "[VideoService] video focus indication.";
+    this->sendVideoFocusModeIndication(aasdk::proto::enums::VideoFocusMode::FOCUSED);
+}
+
+void VideoService::sendVideoFocusModeIndication(aasdk::proto::enums::VideoFocusMode::Enum focusMode)
+{
+    OPENAUTO_LOG(info) << "[VideoService] video focus indication, focus mode: " << focusMode;
 
     aasdk::proto::messages::VideoFocusIndication videoFocusIndication;
-    videoFocusIndication.set_focus_mode(aasdk::proto::enums::VideoFocusMode::FOCUSED);
+    videoFocusIndication.set_focus_mode(focusMode);
     videoFocusIndication.set_unrequested(false);
 
     auto promise = aasdk::channel::SendPromise::defer(strand_);
@@ -0,0 +1,230 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/TCP/AutoConnector.hpp>
+#include <f1x/openauto/autoapp/TCP/SocketTuner.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace tcp
+{
+
+constexpr uint16_t AutoConnector::cPort;
+constexpr time_t AutoConnector::cStaggerDelay;
+constexpr time_t AutoConnector::cAttemptTimeout;
+
+AutoConnector::Attempt::Attempt(boost::asio::io_service& ioService, const std::string& address)
+    : address(address)
+    , socket(std::make_shared<boost::asio::ip::tcp::socket>(ioService))
+    , timer(ioService)
+{
+
+}
+
+AutoConnector::AutoConnector(boost::asio::io_service& ioService, aasdk::tcp::ITCPWrapper& tcpWrapper, configuration::IConfiguration::Pointer configuration)
+    : ioService_(ioService)
+    , strand_(ioService)
+    , tcpWrapper_(tcpWrapper)
+    , configuration_(std::move(configuration))
+    , staggerTimer_(ioService)
+{
+
+}
+
+void AutoConnector::connect(Addresses addresses, Promise::Pointer promise)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), addresses = std::move(addresses), promise = std::move(promise)]() mutable {
+        if(promise_ != nullptr)
+        {
+            promise->reject(aasdk::error::Error(aasdk::error::ErrorCode::OPERATION_IN_PROGRESS));
+            return;
+        }
+
+        promise_ = std::move(promise);
+        pendingAddresses_.clear();
+        knownAddresses_.clear();
+        lastError_ = boost::system::error_code();
+        startTimestamp_ = std::chrono::steady_clock::now();
+
+        for(const auto& address : addresses)
+        {
+            this->enqueueAddress(address);
+        }
+
+        OPENAUTO_LOG(info) << "[AutoConnector] racing " << pendingAddresses_.size() << " addresses.";
+        this->startNextAttempt();
+    });
+}
+
+void AutoConnector::addAddress(const std::string& address)
+{
+    strand_.dispatch([this, self = this->shared_from_this(), address]() {
+        if(promise_ == nullptr)
+        {
+            return;
+        }
+
+        const bool idle = pendingAddresses_.empty();
+        this->enqueueAddress(address);
+
+        // Stagger timer is armed only while addresses are pending, so an
+        // address discovered after the queue drained has to be started here.
+        if(idle && !pendingAddresses_.empty())
+        {
+            this->startNextAttempt();
+        }
+    });
+}
+
+void AutoConnector::cancel()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        this->abortAttempts();
+
+        if(promise_ != nullptr)
+        {
+            promise_->reject(aasdk::error::Error(aasdk::error::ErrorCode::OPERATION_ABORTED));
+            promise_.reset();
+        }
+    });
+}
+
+void AutoConnector::enqueueAddress(const std::string& address)
+{
+    if(!address.empty() && knownAddresses_.insert(address).second)
+    {
+        pendingAddresses_.push_back(address);
+    }
+}
+
+void AutoConnector::startNextAttempt()
+{
+    while(!pendingAddresses_.empty())
+    {
+        auto attempt = std::make_shared<Attempt>(ioService_, pendingAddresses_.front());
+        pendingAddresses_.pop_front();
+
+        try
+        {
+            SocketTuner(configuration_->getTCPTuningProfile()).prepare(*attempt->socket, attempt->address);
+            tcpWrapper_.asyncConnect(*attempt->socket, attempt->address, cPort,
+                                     strand_.wrap(std::bind(&AutoConnector::onConnected, this->shared_from_this(), std::placeholders::_1, attempt)));
+        }
+        catch(const boost::system::system_error& se)
+        {
+            OPENAUTO_LOG(warning) << "[AutoConnector] skipping address: " << attempt->address << ", error: " << se.what();
+            lastError_ = se.code();
+            continue;
+        }
+
+        attempt->timer.expires_from_now(boost::posix_time::milliseconds(cAttemptTimeout));
+        attempt->timer.async_wait(strand_.wrap(std::bind(&AutoConnector::onAttemptTimeout, this->shared_from_this(), std::placeholders::_1, attempt)));
+        attempts_.push_back(std::move(attempt));
+        break;
+    }
+
+    if(!pendingAddresses_.empty())
+    {
+        staggerTimer_.expires_from_now(boost::posix_time::milliseconds(cStaggerDelay));
+        staggerTimer_.async_wait(strand_.wrap(std::bind(&AutoConnector::onStaggerTimerExpired, this->shared_from_this(), std::placeholders::_1)));
+    }
+    else if(attempts_.empty())
+    {
+        this->rejectPromise();
+    }
+}
+
+void AutoConnector::onStaggerTimerExpired(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted && promise_ != nullptr)
+    {
+        this->startNextAttempt();
+    }
+}
+
+void AutoConnector::onAttemptTimeout(const boost::system::error_code& error, Attempt::Pointer attempt)
+{
+    if(error != boost::asio::error::operation_aborted)
+    {
+        lastError_ = boost::asio::error::timed_out;
+        tcpWrapper_.close(*attempt->socket);
+    }
+}
+
+void AutoConnector::onConnected(const boost::system::error_code& error, Attempt::Pointer attempt)
+{
+    attempt->timer.cancel();
+    attempts_.remove(attempt);
+
+    if(promise_ == nullptr)
+    {
+        tcpWrapper_.close(*attempt->socket);
+    }
+    else if(!error)
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTimestamp_);
+        OPENAUTO_LOG(info) << "[AutoConnector] connected to " << attempt->address << " in " << elapsed.count() << " ms.";
+
+        this->abortAttempts();
+        promise_->resolve(attempt->socket);
+        promise_.reset();
+    }
+    else
+    {
+        if(error != boost::asio::error::operation_aborted)
+        {
+            lastError_ = error;
+        }
+
+        OPENAUTO_LOG(debug) << "[AutoConnector] " << attempt->address << " failed: " << error.message();
+        this->startNextAttempt();
+    }
+}
+
+void AutoConnector::abortAttempts()
+{
+    staggerTimer_.cancel();
+    pendingAddresses_.clear();
+
+    for(const auto& attempt : attempts_)
+    {
+        attempt->timer.cancel();
+        tcpWrapper_.close(*attempt->socket);
+    }
+
+    attempts_.clear();
+}
+
+void AutoConnector::rejectPromise()
+{
+    OPENAUTO_LOG(info) << "[AutoConnector] no address reachable, last error: " << lastError_.message();
+
+    staggerTimer_.cancel();
+    promise_->reject(aasdk::error::Error());
+    promise_.reset();
+}
+
+}
+}
+}
+}
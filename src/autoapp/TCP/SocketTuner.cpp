@@ -0,0 +1,139 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/TCP/SocketTuner.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace tcp
+{
+
+SocketTuner::SocketTuner(const configuration::TCPTuningProfile& profile)
+    : profile_(profile)
+{
+
+}
+
+void SocketTuner::prepare(boost::asio::ip::tcp::socket& socket, const std::string& address) const
+{
+    if(profile_.receiveBufferSize == 0)
+    {
+        return;
+    }
+
+    // an address that does not parse is left to the connect, which reports it
+    boost::system::error_code ec;
+    const auto ipAddress = boost::asio::ip::address::from_string(address, ec);
+    if(ec)
+    {
+        return;
+    }
+
+    if(!socket.is_open())
+    {
+        socket.open(ipAddress.is_v6() ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), ec);
+        if(ec)
+        {
+            OPENAUTO_LOG(warning) << "[SocketTuner] failed to open socket: " << ec.message();
+            return;
+        }
+    }
+
+    socket.set_option(boost::asio::socket_base::receive_buffer_size(profile_.receiveBufferSize), ec);
+    if(ec)
+    {
+        OPENAUTO_LOG(warning) << "[SocketTuner] failed to set SO_RCVBUF: " << ec.message();
+        return;
+    }
+
+    // Linux doubles the request for its bookkeeping and caps it at net.core.rmem_max
+    boost::asio::socket_base::receive_buffer_size receiveBufferSize;
+    socket.get_option(receiveBufferSize, ec);
+
+    OPENAUTO_LOG(info) << "[SocketTuner] receive buffer requested: " << profile_.receiveBufferSize
+                       << ", applied: " << (ec ? 0 : receiveBufferSize.value());
+}
+
+void SocketTuner::apply(boost::asio::ip::tcp::socket& socket) const
+{
+    boost::system::error_code ec;
+
+    socket.set_option(boost::asio::ip::tcp::no_delay(profile_.noDelay), ec);
+    if(ec)
+    {
+        OPENAUTO_LOG(warning) << "[SocketTuner] failed to set TCP_NODELAY: " << ec.message();
+    }
+
+    socket.set_option(boost::asio::socket_base::keep_alive(profile_.keepAlive), ec);
+    if(ec)
+    {
+        OPENAUTO_LOG(warning) << "[SocketTuner] failed to set SO_KEEPALIVE: " << ec.message();
+    }
+
+#ifdef __linux__
+    if(profile_.keepAlive)
+    {
+        this->setIntOption(socket, IPPROTO_TCP, TCP_KEEPIDLE, profile_.keepAliveIdle, "TCP_KEEPIDLE");
+        this->setIntOption(socket, IPPROTO_TCP, TCP_KEEPINTVL, profile_.keepAliveInterval, "TCP_KEEPINTVL");
+        this->setIntOption(socket, IPPROTO_TCP, TCP_KEEPCNT, profile_.keepAliveCount, "TCP_KEEPCNT");
+    }
+
+    // The kernel drops back to delayed acks on its own, so this only covers
+    // the start of the session where the phone probes the link.
+    if(profile_.quickAck)
+    {
+        this->setIntOption(socket, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+    }
+
+    if(profile_.busyPoll > 0)
+    {
+        this->setIntOption(socket, SOL_SOCKET, SO_BUSY_POLL, profile_.busyPoll, "SO_BUSY_POLL");
+    }
+#endif
+
+    boost::asio::socket_base::receive_buffer_size receiveBufferSize;
+    socket.get_option(receiveBufferSize, ec);
+
+    OPENAUTO_LOG(info) << "[SocketTuner] nodelay: " << profile_.noDelay
+                       << ", quick ack: " << profile_.quickAck
+                       << ", receive buffer: " << (ec ? 0 : receiveBufferSize.value())
+                       << ", keepalive: " << profile_.keepAlive
+                       << ", busy poll: " << profile_.busyPoll;
+}
+
+void SocketTuner::setIntOption(boost::asio::ip::tcp::socket& socket, int level, int name, int value, const char* label) const
+{
+    if(setsockopt(socket.native_handle(), level, name, &value, sizeof(value)) != 0)
+    {
+        OPENAUTO_LOG(warning) << "[SocketTuner] failed to set " << label << ", errno: " << errno;
+    }
+}
+
+}
+}
+}
+}
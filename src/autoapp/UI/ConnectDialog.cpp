@@ -1,5 +1,6 @@
 #include <QMessageBox>
 #include <f1x/openauto/autoapp/UI/ConnectDialog.hpp>
+#include <f1x/openauto/autoapp/TCP/SocketTuner.hpp>
 #include "ui_connectdialog.h"
 
 namespace f1x
@@ -11,10 +12,11 @@ namespace autoapp
 namespace ui
 {
 
-ConnectDialog::ConnectDialog(boost::asio::io_service& ioService, aasdk::tcp::ITCPWrapper& tcpWrapper, openauto::autoapp::configuration::IRecentAddressesList& recentAddressesList, QWidget *parent)
+ConnectDialog::ConnectDialog(boost::asio::io_service& ioService, aasdk::tcp::ITCPWrapper& tcpWrapper, openauto::autoapp::configuration::IConfiguration::Pointer configuration, openauto::autoapp::configuration::IRecentAddressesList& recentAddressesList, QWidget *parent)
     : QDialog(parent)
     , ioService_(ioService)
     , tcpWrapper_(tcpWrapper)
+    , configuration_(std::move(configuration))
     , recentAddressesList_(recentAddressesList)
     , ui_(new Ui::ConnectDialog)
 {
@@ -46,6 +48,7 @@ void ConnectDialog::onConnectButtonClicked()
 
     try
     {
+        openauto::autoapp::tcp::SocketTuner(configuration_->getTCPTuningProfile()).prepare(*socket, ipAddress);
         tcpWrapper_.asyncConnect(*socket, ipAddress, 5277, std::bind(&ConnectDialog::connectHandler, this, std::placeholders::_1, ipAddress, socket));
     }
     catch(const boost::system::system_error& se)
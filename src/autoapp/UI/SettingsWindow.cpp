@@ -45,6 +45,10 @@ SettingsWindow::SettingsWindow(configuration::IConfiguration::Pointer configurat
     connect(ui_->pushButtonSelectAll, &QPushButton::clicked, std::bind(&SettingsWindow::setButtonCheckBoxes, this, true));
     connect(ui_->pushButtonResetToDefaults, &QPushButton::clicked, this, &SettingsWindow::onResetToDefaults);
     connect(ui_->pushButtonShowBindings, &QPushButton::clicked, this, &SettingsWindow::onShowBindings);
+
+#ifndef USE_ALSA
+    ui_->radioButtonAlsaAudio->hide();
+#endif
 }
 
 SettingsWindow::~SettingsWindow()
@@ -97,7 +101,30 @@ void SettingsWindow::onSave()
 
     configuration_->setMusicAudioChannelEnabled(ui_->checkBoxMusicAudioChannel->isChecked());
     configuration_->setSpeechAudioChannelEnabled(ui_->checkBoxSpeechAudioChannel->isChecked());
-    configuration_->setAudioOutputBackendType(ui_->radioButtonRtAudio->isChecked() ? configuration::AudioOutputBackendType::RTAUDIO : configuration::AudioOutputBackendType::QT);
+
+    if(ui_->radioButtonAlsaAudio->isChecked())
+    {
+        configuration_->setAudioOutputBackendType(configuration::AudioOutputBackendType::ALSA);
+    }
+    else
+    {
+        configuration_->setAudioOutputBackendType(ui_->radioButtonRtAudio->isChecked() ? configuration::AudioOutputBackendType::RTAUDIO : configuration::AudioOutputBackendType::QT);
+    }
+
+    configuration_->setAudioMixerEnabled(ui_->checkBoxAudioMixer->isChecked());
+
+    if(ui_->radioButtonResamplerLow->isChecked())
+    {
+        configuration_->setResamplerQuality(configuration::ResamplerQuality::LOW);
+    }
+    else if(ui_->radioButtonResamplerHigh->isChecked())
+    {
+        configuration_->setResamplerQuality(configuration::ResamplerQuality::HIGH);
+    }
+    else
+    {
+        configuration_->setResamplerQuality(configuration::ResamplerQuality::MEDIUM);
+    }
 
     configuration_->save();
     this->close();
@@ -154,6 +181,13 @@ void SettingsWindow::load()
     const auto& audioOutputBackendType = configuration_->getAudioOutputBackendType();
     ui_->radioButtonRtAudio->setChecked(audioOutputBackendType == configuration::AudioOutputBackendType::RTAUDIO);
     ui_->radioButtonQtAudio->setChecked(audioOutputBackendType == configuration::AudioOutputBackendType::QT);
+    ui_->radioButtonAlsaAudio->setChecked(audioOutputBackendType == configuration::AudioOutputBackendType::ALSA);
+    ui_->checkBoxAudioMixer->setChecked(configuration_->audioMixerEnabled());
+
+    const auto& resamplerQuality = configuration_->getResamplerQuality();
+    ui_->radioButtonResamplerLow->setChecked(resamplerQuality == configuration::ResamplerQuality::LOW);
+    ui_->radioButtonResamplerMedium->setChecked(resamplerQuality == configuration::ResamplerQuality::MEDIUM);
+    ui_->radioButtonResamplerHigh->setChecked(resamplerQuality == configuration::ResamplerQuality::HIGH);
 }
 
 void SettingsWindow::loadButtonCheckBoxes()
@@ -0,0 +1,209 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <poll.h>
+#include <f1x/openauto/autoapp/USB/USBEventLoop.hpp>
+#include <f1x/openauto/Common/Log.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+
+USBEventLoop::Watch::Watch(boost::asio::io_service& ioService, int fd, short events)
+    : descriptor(ioService, fd)
+    , events(events)
+{
+
+}
+
+USBEventLoop::USBEventLoop(boost::asio::io_service& ioService, IUSBEventWrapper::Pointer usbEventWrapper)
+    : ioService_(ioService)
+    , strand_(ioService)
+    , timeoutTimer_(ioService)
+    , usbEventWrapper_(std::move(usbEventWrapper))
+    , running_(false)
+    , wakeupsCount_(0)
+{
+
+}
+
+void USBEventLoop::start()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[USBEventLoop] start.";
+
+        {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            running_ = true;
+        }
+
+        // descriptors opened later (e.g. for every claimed device) are reported through the notifiers
+        usbEventWrapper_->setPollfdNotifiers(&USBEventLoop::onPollfdAdded, &USBEventLoop::onPollfdRemoved, this);
+
+        const auto pollfds = usbEventWrapper_->getPollfds();
+
+        {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            for(const auto& pollfd : pollfds)
+            {
+                this->addWatch(pollfd.fd, pollfd.events);
+            }
+        }
+
+        this->handleEvents();
+    });
+}
+
+void USBEventLoop::stop()
+{
+    strand_.dispatch([this, self = this->shared_from_this()]() {
+        OPENAUTO_LOG(info) << "[USBEventLoop] stop, wakeups: " << wakeupsCount_;
+        usbEventWrapper_->setPollfdNotifiers(nullptr, nullptr, nullptr);
+        timeoutTimer_.cancel();
+
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        running_ = false;
+
+        while(!watches_.empty())
+        {
+            this->removeWatch(watches_.begin()->first);
+        }
+    });
+}
+
+void USBEventLoop::onPollfdAdded(int fd, short events, void* userData)
+{
+    auto* self = static_cast<USBEventLoop*>(userData);
+    std::lock_guard<decltype(self->mutex_)> lock(self->mutex_);
+    self->addWatch(fd, events);
+}
+
+void USBEventLoop::onPollfdRemoved(int fd, void* userData)
+{
+    // libusb closes the descriptor right after this returns and the number can be reused at once,
+    // so it has to leave the reactor now rather than from a handler queued behind the reuse
+    auto* self = static_cast<USBEventLoop*>(userData);
+    std::lock_guard<decltype(self->mutex_)> lock(self->mutex_);
+    self->removeWatch(fd);
+}
+
+void USBEventLoop::addWatch(int fd, short events)
+{
+    if(!running_ || watches_.count(fd) > 0)
+    {
+        return;
+    }
+
+    auto watch(std::make_shared<Watch>(ioService_, fd, events));
+    watches_.emplace(fd, watch);
+    this->wait(std::move(watch));
+}
+
+void USBEventLoop::removeWatch(int fd)
+{
+    auto it = watches_.find(fd);
+    if(it != watches_.end())
+    {
+        // the descriptor belongs to libusb, it is only detached from the reactor
+        boost::system::error_code ec;
+        it->second->descriptor.cancel(ec);
+        it->second->descriptor.release();
+        watches_.erase(it);
+    }
+}
+
+void USBEventLoop::wait(WatchPointer watch)
+{
+    auto handler = strand_.wrap(std::bind(&USBEventLoop::onReady, this->shared_from_this(), watch, std::placeholders::_1));
+
+    // usbfs signals completed URBs as writable, the event pipe and hotplug monitor as readable
+    if(watch->events & POLLOUT)
+    {
+        watch->descriptor.async_write_some(boost::asio::null_buffers(), std::bind(handler, std::placeholders::_1));
+    }
+    else
+    {
+        watch->descriptor.async_read_some(boost::asio::null_buffers(), std::bind(handler, std::placeholders::_1));
+    }
+}
+
+void USBEventLoop::onReady(WatchPointer watch, const boost::system::error_code& error)
+{
+    {
+        std::lock_guard<decltype(mutex_)> lock(mutex_);
+        if(error == boost::asio::error::operation_aborted || !running_ || !watch->descriptor.is_open())
+        {
+            return;
+        }
+
+        if(error)
+        {
+            OPENAUTO_LOG(error) << "[USBEventLoop] wait failed, fd: " << watch->descriptor.native_handle() << ", error: " << error.message();
+        }
+    }
+
+    // the notifiers may be called from here, so the mutex must not be held
+    this->handleEvents();
+
+    // libusb may have dropped the descriptor while handling its events
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    if(running_ && watch->descriptor.is_open())
+    {
+        this->wait(std::move(watch));
+    }
+}
+
+void USBEventLoop::handleEvents()
+{
+    ++wakeupsCount_;
+
+    timeval zero{0, 0};
+    usbEventWrapper_->handleEventsTimeoutCompleted(&zero, nullptr);
+    this->armTimeout();
+}
+
+void USBEventLoop::armTimeout()
+{
+    // transfer timeouts are reported through a timerfd on Linux, other platforms need the next deadline polled
+    timeval timeout;
+    if(usbEventWrapper_->pollfdsHandleTimeouts() != 0 || usbEventWrapper_->getNextTimeout(&timeout) != 1)
+    {
+        return;
+    }
+
+    timeoutTimer_.expires_from_now(boost::posix_time::seconds(timeout.tv_sec) + boost::posix_time::microseconds(timeout.tv_usec));
+    timeoutTimer_.async_wait(strand_.wrap(std::bind(&USBEventLoop::onTimeout, this->shared_from_this(), std::placeholders::_1)));
+}
+
+void USBEventLoop::onTimeout(const boost::system::error_code& error)
+{
+    if(error != boost::asio::error::operation_aborted && running_)
+    {
+        this->handleEvents();
+    }
+}
+
+}
+}
+}
+}
@@ -0,0 +1,77 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <f1x/openauto/autoapp/USB/USBEventWrapper.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+
+USBEventWrapper::USBEventWrapper(libusb_context* usbContext)
+    : usbContext_(usbContext)
+{
+
+}
+
+void USBEventWrapper::setPollfdNotifiers(libusb_pollfd_added_cb addedCallback, libusb_pollfd_removed_cb removedCallback, void* userData)
+{
+    libusb_set_pollfd_notifiers(usbContext_, addedCallback, removedCallback, userData);
+}
+
+IUSBEventWrapper::Pollfds USBEventWrapper::getPollfds()
+{
+    Pollfds result;
+
+    const libusb_pollfd** pollfds = libusb_get_pollfds(usbContext_);
+    if(pollfds != nullptr)
+    {
+        for(size_t i = 0; pollfds[i] != nullptr; ++i)
+        {
+            result.push_back(*pollfds[i]);
+        }
+
+        libusb_free_pollfds(pollfds);
+    }
+
+    return result;
+}
+
+int USBEventWrapper::handleEventsTimeoutCompleted(timeval* timeout, int* completed)
+{
+    return libusb_handle_events_timeout_completed(usbContext_, timeout, completed);
+}
+
+int USBEventWrapper::pollfdsHandleTimeouts()
+{
+    return libusb_pollfds_handle_timeouts(usbContext_);
+}
+
+int USBEventWrapper::getNextTimeout(timeval* timeout)
+{
+    return libusb_get_next_timeout(usbContext_, timeout);
+}
+
+}
+}
+}
+}
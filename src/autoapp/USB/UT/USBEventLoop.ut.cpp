@@ -0,0 +1,218 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+#include <f1x/openauto/autoapp/USB/USBEventLoop.hpp>
+#include <f1x/openauto/autoapp/USB/UT/USBEventWrapper.mock.hpp>
+
+namespace f1x
+{
+namespace openauto
+{
+namespace autoapp
+{
+namespace usb
+{
+namespace ut
+{
+
+class Pipe
+{
+public:
+    Pipe()
+    {
+        BOOST_REQUIRE(::pipe(fds_) == 0);
+    }
+
+    ~Pipe()
+    {
+        this->close();
+    }
+
+    void close()
+    {
+        for(auto& fd : fds_)
+        {
+            if(fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    int getReadFd() const
+    {
+        return fds_[0];
+    }
+
+    void signal()
+    {
+        const char byte = 0;
+        BOOST_REQUIRE(::write(fds_[1], &byte, 1) == 1);
+    }
+
+    void drain()
+    {
+        char buffer[16];
+        ::pollfd pollfd{fds_[0], POLLIN, 0};
+
+        while(::poll(&pollfd, 1, 0) == 1 && ::read(fds_[0], buffer, sizeof(buffer)) > 0);
+    }
+
+private:
+    int fds_[2];
+};
+
+class USBEventLoopUnitTest
+{
+protected:
+    USBEventLoopUnitTest()
+        : usbEventWrapperMock_(std::make_shared<USBEventWrapperMock>())
+        , usbEventLoop_(std::make_shared<USBEventLoop>(ioService_, usbEventWrapperMock_))
+    {
+
+    }
+
+    // runs the io_service until the expected number of libusb wakeups happened or the timeout passed
+    bool waitForWakeups(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(1))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while(usbEventWrapperMock_->handleEventsCount < count && std::chrono::steady_clock::now() < deadline)
+        {
+            ioService_.poll();
+            ioService_.reset();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return usbEventWrapperMock_->handleEventsCount >= count;
+    }
+
+    void runPending()
+    {
+        ioService_.poll();
+        ioService_.reset();
+    }
+
+    boost::asio::io_service ioService_;
+    std::shared_ptr<USBEventWrapperMock> usbEventWrapperMock_;
+    USBEventLoop::Pointer usbEventLoop_;
+};
+
+BOOST_FIXTURE_TEST_CASE(USBEventLoop_HandlesEventsWhenInitialPollfdIsReady, USBEventLoopUnitTest)
+{
+    Pipe pipe;
+    usbEventWrapperMock_->pollfds.push_back(libusb_pollfd{pipe.getReadFd(), POLLIN});
+    usbEventWrapperMock_->onHandleEvents = [&pipe]() { pipe.drain(); };
+
+    usbEventLoop_->start();
+    this->runPending();
+    BOOST_CHECK_EQUAL(usbEventWrapperMock_->handleEventsCount, 1u);
+    BOOST_CHECK(usbEventWrapperMock_->addedCallback != nullptr);
+    BOOST_CHECK(usbEventWrapperMock_->removedCallback != nullptr);
+
+    pipe.signal();
+    BOOST_CHECK(this->waitForWakeups(2));
+
+    usbEventLoop_->stop();
+    this->runPending();
+}
+
+BOOST_FIXTURE_TEST_CASE(USBEventLoop_ReleasesRemovedPollfdBeforeItIsReused, USBEventLoopUnitTest)
+{
+    usbEventLoop_->start();
+    this->runPending();
+
+    auto firstPipe = std::make_unique<Pipe>();
+    const int fd = firstPipe->getReadFd();
+    usbEventWrapperMock_->addedCallback(fd, POLLIN, usbEventWrapperMock_->userData);
+
+    // libusb closes the descriptor as soon as the notifier returns, before any handler can run
+    usbEventWrapperMock_->removedCallback(fd, usbEventWrapperMock_->userData);
+    firstPipe.reset();
+
+    Pipe secondPipe;
+    BOOST_REQUIRE_EQUAL(secondPipe.getReadFd(), fd);
+    usbEventWrapperMock_->onHandleEvents = [&secondPipe]() { secondPipe.drain(); };
+    usbEventWrapperMock_->addedCallback(secondPipe.getReadFd(), POLLIN, usbEventWrapperMock_->userData);
+
+    const auto wakeupsCount = usbEventWrapperMock_->handleEventsCount;
+    secondPipe.signal();
+    BOOST_CHECK(this->waitForWakeups(wakeupsCount + 1));
+
+    usbEventLoop_->stop();
+    this->runPending();
+}
+
+BOOST_FIXTURE_TEST_CASE(USBEventLoop_PollfdCanBeRemovedWhileHandlingEvents, USBEventLoopUnitTest)
+{
+    Pipe pipe;
+    usbEventWrapperMock_->pollfds.push_back(libusb_pollfd{pipe.getReadFd(), POLLIN});
+
+    usbEventLoop_->start();
+    this->runPending();
+
+    usbEventWrapperMock_->onHandleEvents = [this, &pipe]() {
+        pipe.drain();
+        usbEventWrapperMock_->removedCallback(pipe.getReadFd(), usbEventWrapperMock_->userData);
+    };
+
+    pipe.signal();
+    BOOST_CHECK(this->waitForWakeups(2));
+
+    // the watch is gone, further data on the descriptor does not wake libusb up
+    pipe.signal();
+    this->waitForWakeups(3, std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(usbEventWrapperMock_->handleEventsCount, 2u);
+
+    usbEventLoop_->stop();
+    this->runPending();
+}
+
+BOOST_FIXTURE_TEST_CASE(USBEventLoop_StopDetachesWithoutClosingDescriptors, USBEventLoopUnitTest)
+{
+    Pipe pipe;
+    usbEventWrapperMock_->pollfds.push_back(libusb_pollfd{pipe.getReadFd(), POLLIN});
+
+    usbEventLoop_->start();
+    this->runPending();
+    usbEventLoop_->stop();
+    this->runPending();
+
+    BOOST_CHECK(usbEventWrapperMock_->addedCallback == nullptr);
+    BOOST_CHECK(usbEventWrapperMock_->removedCallback == nullptr);
+
+    // the descriptor belongs to libusb and stays open
+    BOOST_CHECK(::fcntl(pipe.getReadFd(), F_GETFD) != -1);
+
+    pipe.signal();
+    this->waitForWakeups(2, std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(usbEventWrapperMock_->handleEventsCount, 1u);
+}
+
+}
+}
+}
+}
+}
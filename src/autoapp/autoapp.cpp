@@ -19,6 +19,7 @@
 #include <thread>
 #include <QApplication>
 #include <f1x/aasdk/USB/USBHub.hpp>
+#include <f1x/aasdk/USB/USBWrapper.hpp>
 #include <f1x/aasdk/USB/ConnectedAccessoriesEnumerator.hpp>
 #include <f1x/aasdk/USB/AccessoryModeQueryChain.hpp>
 #include <f1x/aasdk/USB/AccessoryModeQueryChainFactory.hpp>
@@ -29,33 +30,22 @@
 #include <f1x/openauto/autoapp/Configuration/RecentAddressesList.hpp>
 #include <f1x/openauto/autoapp/Service/AndroidAutoEntityFactory.hpp>
 #include <f1x/openauto/autoapp/Service/ServiceFactory.hpp>
+#include <f1x/openauto/autoapp/Service/AudioFocusArbiter.hpp>
 #include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationWatcher.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoDecodeProbe.hpp>
 #include <f1x/openauto/autoapp/UI/MainWindow.hpp>
 #include <f1x/openauto/autoapp/UI/SettingsWindow.hpp>
 #include <f1x/openauto/autoapp/UI/ConnectDialog.hpp>
+#include <f1x/openauto/autoapp/USB/USBEventLoop.hpp>
+#include <f1x/openauto/autoapp/USB/USBEventWrapper.hpp>
+#include <f1x/openauto/autoapp/TCP/AutoConnector.hpp>
 #include <f1x/openauto/Common/Log.hpp>
 
 namespace aasdk = f1x::aasdk;
 namespace autoapp = f1x::openauto::autoapp;
 using ThreadPool = std::vector<std::thread>;
 
-void startUSBWorkers(boost::asio::io_service& ioService, libusb_context* usbContext, ThreadPool& threadPool)
-{
-    auto usbWorker = [&ioService, usbContext]() {
-        timeval libusbEventTimeout{180, 0};
-
-        while(!ioService.stopped())
-        {
-            libusb_handle_events_timeout_completed(usbContext, &libusbEventTimeout, nullptr);
-        }
-    };
-
-    threadPool.emplace_back(usbWorker);
-    threadPool.emplace_back(usbWorker);
-    threadPool.emplace_back(usbWorker);
-    threadPool.emplace_back(usbWorker);
-}
-
 void startIOServiceWorkers(boost::asio::io_service& ioService, ThreadPool& threadPool)
 {
     auto ioServiceWorker = [&ioService]() {
@@ -80,14 +70,27 @@ int main(int argc, char* argv[])
     boost::asio::io_service ioService;
     boost::asio::io_service::work work(ioService);
     std::vector<std::thread> threadPool;
-    startUSBWorkers(ioService, usbContext, threadPool);
     startIOServiceWorkers(ioService, threadPool);
 
+    auto usbEventLoop(std::make_shared<autoapp::usb::USBEventLoop>(ioService, std::make_shared<autoapp::usb::USBEventWrapper>(usbContext)));
+    usbEventLoop->start();
+
     QApplication qApplication(argc, argv);
     autoapp::ui::MainWindow mainWindow;
     mainWindow.setWindowFlags(Qt::WindowStaysOnTopHint);
 
     auto configuration = std::make_shared<autoapp::configuration::Configuration>();
+#ifndef USE_OMX
+    // the software decode probe takes a while, it runs now instead of on an io thread during service discovery
+    if(configuration->getVideoAdaptiveConfigs())
+    {
+        autoapp::projection::VideoDecodeProbe::startAsync();
+    }
+#endif
+#ifdef __linux__
+    auto configurationWatcher(std::make_shared<autoapp::configuration::ConfigurationWatcher>(ioService, configuration, autoapp::configuration::Configuration::cConfigFileName));
+    configurationWatcher->start();
+#endif
     autoapp::ui::SettingsWindow settingsWindow(configuration);
     settingsWindow.setWindowFlags(Qt::WindowStaysOnTopHint);
 
@@ -95,7 +98,7 @@ int main(int argc, char* argv[])
     recentAddressesList.read();
 
     aasdk::tcp::TCPWrapper tcpWrapper;
-    autoapp::ui::ConnectDialog connectDialog(ioService, tcpWrapper, recentAddressesList);
+    autoapp::ui::ConnectDialog connectDialog(ioService, tcpWrapper, configuration, recentAddressesList);
     connectDialog.setWindowFlags(Qt::WindowStaysOnTopHint);
 
     QObject::connect(&mainWindow, &autoapp::ui::MainWindow::exit, []() { std::exit(0); });
@@ -108,25 +111,33 @@ int main(int argc, char* argv[])
         qApplication.setOverrideCursor(cursor);
     });
 
+    mainWindow.setAttribute(Qt::WA_AcceptTouchEvents);
     mainWindow.showFullScreen();
 
     aasdk::usb::USBWrapper usbWrapper(usbContext);
     aasdk::usb::AccessoryModeQueryFactory queryFactory(usbWrapper, ioService);
     aasdk::usb::AccessoryModeQueryChainFactory queryChainFactory(usbWrapper, ioService, queryFactory);
-    autoapp::service::ServiceFactory serviceFactory(ioService, configuration);
-    autoapp::service::AndroidAutoEntityFactory androidAutoEntityFactory(ioService, configuration, serviceFactory);
+    auto audioFocusArbiter(std::make_shared<autoapp::service::AudioFocusArbiter>(0.3f));
+    autoapp::service::ServiceFactory serviceFactory(ioService, configuration, audioFocusArbiter);
+    autoapp::service::AndroidAutoEntityFactory androidAutoEntityFactory(ioService, configuration, serviceFactory, audioFocusArbiter);
 
     auto usbHub(std::make_shared<aasdk::usb::USBHub>(usbWrapper, ioService, queryChainFactory));
     auto connectedAccessoriesEnumerator(std::make_shared<aasdk::usb::ConnectedAccessoriesEnumerator>(usbWrapper, ioService, queryChainFactory));
-    auto app = std::make_shared<autoapp::App>(ioService, usbWrapper, tcpWrapper, androidAutoEntityFactory, std::move(usbHub), std::move(connectedAccessoriesEnumerator));
+    auto autoConnector(std::make_shared<autoapp::tcp::AutoConnector>(ioService, tcpWrapper, configuration));
+    auto app = std::make_shared<autoapp::App>(ioService, configuration, usbWrapper, tcpWrapper, androidAutoEntityFactory, std::move(usbHub), std::move(connectedAccessoriesEnumerator), std::move(autoConnector));
 
     QObject::connect(&connectDialog, &autoapp::ui::ConnectDialog::connectionSucceed, [&app](auto socket) {
         app->start(std::move(socket));
     });
 
     app->waitForUSBDevice();
+    app->autoConnect(recentAddressesList.getList());
 
     auto result = qApplication.exec();
+#ifdef __linux__
+    configurationWatcher->stop();
+#endif
+    usbEventLoop->stop();
     std::for_each(threadPool.begin(), threadPool.end(), std::bind(&std::thread::join, std::placeholders::_1));
 
     libusb_exit(usbContext);
@@ -0,0 +1,130 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <time.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
+#include <f1x/openauto/autoapp/Configuration/ConfigurationView.hpp>
+
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+constexpr size_t cDefaultReads = 10000000;
+constexpr size_t cDefaultThreads = 4;
+
+int64_t getThreadCpuTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+// Every reader thread builds its own reader, like every strand owns its own view. The CPU time
+// of one read averaged over all threads is returned in nanoseconds, so more readers than cores
+// do not count each other's time slices.
+template<typename ReaderFactory>
+double measure(size_t threadsCount, size_t reads, ReaderFactory createReader)
+{
+    std::atomic<uint64_t> sink(0);
+    std::atomic<int64_t> elapsed(0);
+    std::vector<std::thread> threads;
+
+    for(size_t i = 0; i < threadsCount; ++i)
+    {
+        threads.emplace_back([&]() {
+            auto reader = createReader();
+            uint64_t sum = 0;
+
+            const auto start = getThreadCpuTime();
+            for(size_t read = 0; read < reads; ++read)
+            {
+                sum += reader();
+            }
+
+            elapsed += getThreadCpuTime() - start;
+            sink += sum;
+        });
+    }
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return sink.load() == 0 ? 0 : static_cast<double>(elapsed.load()) / (threadsCount * reads);
+}
+
+void run(autoapp::configuration::IConfiguration::Pointer configuration, size_t threadsCount, size_t reads)
+{
+    const double getter = measure(threadsCount, reads, [&]() {
+        return [&]() { return configuration->getTouchCoalescingWindow(); };
+    });
+
+    const double snapshot = measure(threadsCount, reads, [&]() {
+        return [&]() { return configuration->getSnapshot()->screenDPI; };
+    });
+
+    const double view = measure(threadsCount, reads, [&]() {
+        return [view = autoapp::configuration::ConfigurationView(configuration)]() mutable {
+            view.refresh();
+            return view.get().screenDPI;
+        };
+    });
+
+    printf("%zu thread(s): getter %.1f ns, getSnapshot() %.1f ns, ConfigurationView %.1f ns per read\n",
+           threadsCount, getter, snapshot, view);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::error);
+
+    if(argc > 3)
+    {
+        printf("usage: %s [<reads per thread> [<threads>]]\n", argv[0]);
+        printf("Measures one configuration read on an event path: a getter of IConfiguration, a field of\n");
+        printf("getSnapshot() and a field of a ConfigurationView refreshed before the read. The getter and\n");
+        printf("getSnapshot() take and drop a reference to the shared snapshot on every read, the view only\n");
+        printf("loads the version. Runs with one reader and with the given number of concurrent readers.\n");
+        return 2;
+    }
+
+    const size_t reads = argc >= 2 ? std::stoul(argv[1]) : cDefaultReads;
+    const size_t threadsCount = argc == 3 ? std::stoul(argv[2]) : cDefaultThreads;
+
+    auto configuration = std::make_shared<autoapp::configuration::Configuration>();
+    run(configuration, 1, reads);
+
+    if(threadsCount > 1)
+    {
+        run(configuration, threadsCount, reads);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <f1x/openauto/autoapp/Projection/NalParser.hpp>
+
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+typedef const uint8_t* (*FindStartCode)(const uint8_t* begin, const uint8_t* end);
+
+constexpr size_t cDefaultMegabytes = 64;
+constexpr size_t cFrameSize = 100 * 1024;
+constexpr size_t cDenseNalSize = 32;
+constexpr size_t cRepeats = 5;
+
+// Slice payload with emulation prevention applied, so 00 00 0x (x <= 3) never appears inside a NAL unit.
+void appendNal(std::vector<uint8_t>& stream, uint8_t header, size_t size, std::mt19937& generator)
+{
+    std::uniform_int_distribution<int> distribution(0, 255);
+    const uint8_t startCode[] = {0, 0, 0, 1};
+    stream.insert(stream.end(), startCode, startCode + sizeof(startCode));
+    stream.push_back(header);
+
+    size_t zeros = 0;
+    for(size_t i = 0; i < size; ++i)
+    {
+        // compressed data is close to uniform, with extra zeros to exercise the emulation prevention
+        uint8_t value = i % 97 < 8 ? 0 : static_cast<uint8_t>(distribution(generator));
+
+        if(zeros >= 2 && value <= 3)
+        {
+            stream.push_back(3);
+            zeros = 0;
+        }
+
+        stream.push_back(value);
+        zeros = value == 0 ? zeros + 1 : 0;
+    }
+
+    // a trailing zero would merge with the next start code
+    if(stream.back() == 0)
+    {
+        stream.push_back(0x80);
+    }
+}
+
+std::vector<uint8_t> createStream(size_t size, size_t nalSize)
+{
+    std::mt19937 generator(1);
+    std::vector<uint8_t> stream;
+    stream.reserve(size + size / 8);
+
+    while(stream.size() < size)
+    {
+        appendNal(stream, 0x41, nalSize, generator);
+    }
+
+    return stream;
+}
+
+double measureScan(const std::vector<uint8_t>& stream, FindStartCode findStartCode, size_t& startCodes)
+{
+    const auto* end = stream.data() + stream.size();
+    double bestSeconds = 1e9;
+
+    for(size_t repeat = 0; repeat < cRepeats; ++repeat)
+    {
+        startCodes = 0;
+        const auto begin = std::chrono::steady_clock::now();
+
+        for(const auto* current = findStartCode(stream.data(), end); current != end; current = findStartCode(current + 3, end))
+        {
+            ++startCodes;
+        }
+
+        bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+
+    return stream.size() / bestSeconds / 1e9;
+}
+
+// Media indications carry one frame each, so the stream is parsed frame by frame like VideoService does.
+double measureParse(size_t megabytes, size_t& accessUnitsCount)
+{
+    std::mt19937 generator(2);
+    std::vector<std::vector<uint8_t>> frames;
+    size_t totalSize = 0;
+
+    while(totalSize < megabytes * 1024 * 1024)
+    {
+        std::vector<uint8_t> frame;
+        appendNal(frame, 0x41, cFrameSize / 2, generator);
+        appendNal(frame, 0x41, cFrameSize / 2, generator);
+        frame[5] |= 0x80;
+        totalSize += frame.size();
+        frames.push_back(std::move(frame));
+    }
+
+    autoapp::projection::NalParser::AccessUnits accessUnits;
+    double bestSeconds = 1e9;
+
+    for(size_t repeat = 0; repeat < cRepeats; ++repeat)
+    {
+        accessUnitsCount = 0;
+        const auto begin = std::chrono::steady_clock::now();
+
+        for(const auto& frame : frames)
+        {
+            accessUnits.clear();
+            autoapp::projection::NalParser::parse(0, f1x::aasdk::common::DataConstBuffer(frame), accessUnits);
+            accessUnitsCount += accessUnits.size();
+        }
+
+        bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+
+    return totalSize / bestSeconds / 1e9;
+}
+
+const char* getSimdName()
+{
+#if defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#else
+    return "none";
+#endif
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc > 2)
+    {
+        printf("usage: %s [<megabytes>]\n", argv[0]);
+        printf("Measures the start code scan of the NAL parser against its scalar reference on frame-like\n");
+        printf("data and on dense start codes, and the parsing of 100 KB frames into access units.\n");
+        return 2;
+    }
+
+    const size_t megabytes = argc == 2 ? std::stoul(argv[1]) : cDefaultMegabytes;
+    printf("SIMD: %s, best of %zu runs over %zu MiB\n", getSimdName(), cRepeats, megabytes);
+
+    const std::vector<std::pair<const char*, std::vector<uint8_t>>> streams{
+        {"frame-like", createStream(megabytes * 1024 * 1024, cFrameSize)},
+        {"dense", createStream(megabytes * 1024 * 1024, cDenseNalSize)}
+    };
+
+    for(const auto& stream : streams)
+    {
+        size_t simdStartCodes;
+        size_t scalarStartCodes;
+        const double simd = measureScan(stream.second, &autoapp::projection::NalParser::findStartCode, simdStartCodes);
+        const double scalar = measureScan(stream.second, &autoapp::projection::NalParser::findStartCodeScalar, scalarStartCodes);
+
+        printf("  scan %-10s: %.2f GB/s, scalar %.2f GB/s, start codes: %zu%s\n", stream.first, simd, scalar, simdStartCodes,
+               simdStartCodes == scalarStartCodes ? "" : " (MISMATCH with scalar)");
+    }
+
+    size_t accessUnitsCount;
+    const double parse = measureParse(megabytes, accessUnitsCount);
+    printf("  parse frames    : %.2f GB/s, access units: %zu\n", parse, accessUnitsCount);
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <f1x/openauto/autoapp/Projection/Resampler.hpp>
+
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+struct Conversion
+{
+    uint32_t inputSampleRate;
+    uint32_t outputSampleRate;
+};
+
+struct Response
+{
+    double passbandEdge;
+    double passbandRipple;
+    double cutoff;
+    double stopbandEdge;
+    double stopbandAttenuation;
+    double transitionAttenuation;
+};
+
+constexpr size_t cBlockFrames = 1024;
+constexpr double cToneAmplitude = 32000.0;
+constexpr size_t cToneCount = 400;
+constexpr double cPassbandTolerance = 0.1;
+
+const char* getQualityName(autoapp::configuration::ResamplerQuality quality)
+{
+    switch(quality)
+    {
+    case autoapp::configuration::ResamplerQuality::LOW:
+        return "low";
+    case autoapp::configuration::ResamplerQuality::HIGH:
+        return "high";
+    default:
+        return "medium";
+    }
+}
+
+// Converts ten seconds of noise in blocks of the size the audio outputs see and reports the real-time factor.
+void measureThroughput(const Conversion& conversion, uint32_t channelCount, autoapp::configuration::ResamplerQuality quality)
+{
+    const size_t frameCount = conversion.inputSampleRate * 10;
+    std::vector<int16_t> input(frameCount * channelCount);
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<int> distribution(-16384, 16384);
+    std::generate(input.begin(), input.end(), [&]() { return static_cast<int16_t>(distribution(generator)); });
+
+    autoapp::projection::Resampler resampler(conversion.inputSampleRate, conversion.outputSampleRate, channelCount, quality);
+    std::vector<int16_t> output;
+    output.reserve(cBlockFrames * channelCount * (conversion.outputSampleRate / conversion.inputSampleRate + 2));
+    size_t outputFrameCount = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t offset = 0; offset + cBlockFrames <= frameCount; offset += cBlockFrames)
+    {
+        output.clear();
+        resampler.process(input.data() + offset * channelCount, cBlockFrames, output);
+        outputFrameCount += output.size() / channelCount;
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("  %u ch throughput: %.1f Mframes/s, %.1f ns per output frame, %.0fx real time\n",
+           channelCount, outputFrameCount / elapsed / 1e6, elapsed * 1e9 / outputFrameCount,
+           outputFrameCount / elapsed / conversion.outputSampleRate);
+}
+
+// Feeds one tone through a fresh resampler. The output is least-squares fitted with a sinusoid at the tone
+// frequency, the fit gives the gain and everything left over (aliases, images, noise) is the leakage.
+void measureTone(const Conversion& conversion, autoapp::configuration::ResamplerQuality quality, double frequency, double& gain, double& leakage)
+{
+    const size_t frameCount = conversion.inputSampleRate / 2;
+    std::vector<int16_t> input(frameCount);
+    for(size_t i = 0; i < frameCount; ++i)
+    {
+        input[i] = static_cast<int16_t>(std::lround(cToneAmplitude * std::sin(2.0 * M_PI * frequency * i / conversion.inputSampleRate)));
+    }
+
+    autoapp::projection::Resampler resampler(conversion.inputSampleRate, conversion.outputSampleRate, 1, quality);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+
+    // skips the filter warm-up at the start
+    const size_t skip = output.size() / 4;
+    const double outputFrequency = frequency < conversion.outputSampleRate / 2.0 ? frequency : 0.0;
+    double sinSin = 0.0, cosCos = 0.0, sinCos = 0.0, sinOut = 0.0, cosOut = 0.0;
+
+    for(size_t i = skip; i < output.size(); ++i)
+    {
+        const double phase = 2.0 * M_PI * outputFrequency * i / conversion.outputSampleRate;
+        const double s = std::sin(phase);
+        const double c = std::cos(phase);
+        sinSin += s * s;
+        cosCos += c * c;
+        sinCos += s * c;
+        sinOut += s * output[i];
+        cosOut += c * output[i];
+    }
+
+    double a = 0.0;
+    double b = 0.0;
+    const double determinant = sinSin * cosCos - sinCos * sinCos;
+    if(outputFrequency > 0.0 && determinant > 0.0)
+    {
+        a = (sinOut * cosCos - cosOut * sinCos) / determinant;
+        b = (cosOut * sinSin - sinOut * sinCos) / determinant;
+    }
+
+    double residualPower = 0.0;
+    for(size_t i = skip; i < output.size(); ++i)
+    {
+        const double phase = 2.0 * M_PI * outputFrequency * i / conversion.outputSampleRate;
+        const double residual = output[i] - a * std::sin(phase) - b * std::cos(phase);
+        residualPower += residual * residual;
+    }
+    residualPower /= output.size() - skip;
+
+    const double inputAmplitude = cToneAmplitude / 32768.0;
+    gain = std::sqrt(a * a + b * b) / inputAmplitude;
+    leakage = residualPower / (inputAmplitude * inputAmplitude / 2.0);
+}
+
+// Sweeps tones over the input band. The passband edge is the last tone within 0.1 dB, the transition band is
+// taken as symmetric around the lower Nyquist frequency, everything beyond it is stopband. Stopband tones of a
+// downsampler alias, passband tones of an upsampler produce images there, the worst leakage of either is
+// the stopband attenuation. Tones between the passband and the stopband leak into the transition band,
+// their worst leakage is reported separately.
+Response measureResponse(const Conversion& conversion, autoapp::configuration::ResamplerQuality quality)
+{
+    const double inputNyquist = conversion.inputSampleRate / 2.0;
+    const double nyquist = std::min(conversion.inputSampleRate, conversion.outputSampleRate) / 2.0;
+    std::vector<double> frequencies(cToneCount);
+    std::vector<double> gains(cToneCount);
+    std::vector<double> leakages(cToneCount);
+
+    for(size_t i = 0; i < cToneCount; ++i)
+    {
+        frequencies[i] = inputNyquist * (i + 0.5) / cToneCount;
+        measureTone(conversion, quality, frequencies[i], gains[i], leakages[i]);
+    }
+
+    Response response{0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    bool passband = true;
+
+    for(size_t i = 0; i < cToneCount && frequencies[i] < nyquist; ++i)
+    {
+        const double gain = 20.0 * std::log10(std::max(gains[i], 1e-12));
+        passband = passband && std::abs(gain) <= cPassbandTolerance;
+
+        if(passband)
+        {
+            response.passbandEdge = frequencies[i];
+            response.passbandRipple = std::max(response.passbandRipple, std::abs(gain));
+        }
+
+        if(gain >= -3.0)
+        {
+            response.cutoff = frequencies[i];
+        }
+    }
+
+    response.stopbandEdge = 2.0 * nyquist - response.passbandEdge;
+    const bool upsampling = conversion.outputSampleRate > conversion.inputSampleRate;
+    double worstStopbandLeakage = 0.0;
+    double worstTransitionLeakage = 0.0;
+
+    for(size_t i = 0; i < cToneCount; ++i)
+    {
+        const bool stopbandTone = upsampling ? frequencies[i] <= response.passbandEdge : frequencies[i] >= response.stopbandEdge;
+
+        if(stopbandTone)
+        {
+            worstStopbandLeakage = std::max(worstStopbandLeakage, leakages[i]);
+        }
+        else if(frequencies[i] > response.passbandEdge)
+        {
+            worstTransitionLeakage = std::max(worstTransitionLeakage, leakages[i]);
+        }
+    }
+
+    response.stopbandAttenuation = worstStopbandLeakage > 0.0 ? -10.0 * std::log10(worstStopbandLeakage) : 0.0;
+    response.transitionAttenuation = worstTransitionLeakage > 0.0 ? -10.0 * std::log10(worstTransitionLeakage) : 0.0;
+
+    return response;
+}
+
+void runBenchmark(const Conversion& conversion, autoapp::configuration::ResamplerQuality quality)
+{
+    printf("%u Hz -> %u Hz, quality: %s\n", conversion.inputSampleRate, conversion.outputSampleRate, getQualityName(quality));
+
+    measureThroughput(conversion, 1, quality);
+    measureThroughput(conversion, 2, quality);
+
+    const auto response = measureResponse(conversion, quality);
+    printf("  passband:   0 - %.0f Hz, ripple %.3f dB\n", response.passbandEdge, response.passbandRipple);
+    printf("  -3 dB:      %.0f Hz\n", response.cutoff);
+    printf("  transition: %.0f - %.0f Hz, aliasing attenuation %.1f dB\n", response.passbandEdge, response.stopbandEdge, response.transitionAttenuation);
+
+    if(response.stopbandAttenuation > 0.0)
+    {
+        printf("  stopband:   from %.0f Hz, attenuation %.1f dB\n", response.stopbandEdge, response.stopbandAttenuation);
+    }
+    else
+    {
+        printf("  stopband:   from %.0f Hz, beyond the input band\n", response.stopbandEdge);
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+
+    if(argc == 2 || argc > 4)
+    {
+        printf("usage: %s [<input rate> <output rate> [low|medium|high]]\n", argv[0]);
+        printf("Without arguments the conversions used by the audio outputs are measured at every quality.\n");
+        printf("The 16-bit test signal puts a floor of about 95 dB under the measured attenuation.\n");
+        return 2;
+    }
+
+    std::vector<Conversion> conversions;
+    std::vector<autoapp::configuration::ResamplerQuality> qualities{autoapp::configuration::ResamplerQuality::LOW,
+                                                                    autoapp::configuration::ResamplerQuality::MEDIUM,
+                                                                    autoapp::configuration::ResamplerQuality::HIGH};
+
+    if(argc >= 3)
+    {
+        conversions.push_back(Conversion{static_cast<uint32_t>(std::stoul(argv[1])), static_cast<uint32_t>(std::stoul(argv[2]))});
+
+        if(argc == 4)
+        {
+            const std::string qualityName = argv[3];
+            qualities.erase(std::remove_if(qualities.begin(), qualities.end(), [&](auto quality) { return qualityName != getQualityName(quality); }), qualities.end());
+        }
+    }
+    else
+    {
+        conversions = {{16000, 48000}, {16000, 44100}, {48000, 44100}, {44100, 48000}};
+    }
+
+    for(const auto& conversion : conversions)
+    {
+        for(const auto& quality : qualities)
+        {
+            runBenchmark(conversion, quality);
+        }
+    }
+
+    return 0;
+}
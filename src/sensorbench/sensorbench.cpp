@@ -0,0 +1,156 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <f1x/openauto/autoapp/Service/SensorScheduler.hpp>
+
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+struct SimulatedSensor
+{
+    const char* name;
+    aasdk::proto::enums::SensorType::Enum sensorType;
+    autoapp::service::SensorPolicy policy;
+    uint32_t rate;      // samples per second
+    double step;        // standard deviation of the change between two samples
+    double value;
+    double sentValue;
+    uint64_t samplesCount;
+    uint64_t eventsCount;
+};
+
+constexpr uint32_t cDefaultDuration = 60;
+constexpr uint32_t cDefaultImuRate = 100;
+
+// Drives the scheduler the way SensorService does, on a simulated millisecond clock: a sample that the
+// scheduler accepts triggers a flush, and a flush also happens whenever the next deadline has passed.
+void runBenchmark(uint32_t duration, uint32_t imuRate)
+{
+    std::vector<SimulatedSensor> sensors{
+        {"accel", aasdk::proto::enums::SensorType::ACCEL, {50, 0.02, 1000}, imuRate, 0.05, 0.0, 0.0, 0, 0},
+        {"gyro", aasdk::proto::enums::SensorType::GYRO, {50, 0.02, 1000}, imuRate, 0.05, 0.0, 0.0, 0, 0},
+        {"location", aasdk::proto::enums::SensorType::LOCATION, {100, 0.5, 1000}, 10, 1.5, 0.0, 0.0, 0, 0},
+        {"speed", aasdk::proto::enums::SensorType::CAR_SPEED, {100, 100.0, 1000}, 20, 60.0, 0.0, 0.0, 0, 0}
+    };
+
+    autoapp::service::SensorScheduler scheduler;
+    autoapp::service::SensorScheduler::SensorTypes dueSensorTypes;
+
+    for(auto& sensor : sensors)
+    {
+        scheduler.setPolicy(sensor.sensorType, sensor.policy);
+        scheduler.start(sensor.sensorType);
+    }
+
+    std::mt19937 generator(1);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    const autoapp::service::SensorScheduler::TimePoint start;
+    uint64_t schedulingTime = 0;
+
+    auto flush = [&](autoapp::service::SensorScheduler::TimePoint now) {
+        if(scheduler.collect(now, dueSensorTypes))
+        {
+            for(const auto& sensorType : dueSensorTypes)
+            {
+                for(auto& sensor : sensors)
+                {
+                    if(sensor.sensorType == sensorType)
+                    {
+                        sensor.sentValue = sensor.value;
+                        ++sensor.eventsCount;
+                    }
+                }
+            }
+        }
+    };
+
+    for(uint32_t millisecond = 0; millisecond < duration * 1000; ++millisecond)
+    {
+        const auto now = start + std::chrono::milliseconds(millisecond);
+        const auto begin = std::chrono::steady_clock::now();
+
+        for(auto& sensor : sensors)
+        {
+            if((static_cast<uint64_t>(millisecond) * sensor.rate) % 1000 < sensor.rate)
+            {
+                sensor.value += sensor.step * distribution(generator);
+                ++sensor.samplesCount;
+
+                if(scheduler.submit(sensor.sensorType, std::abs(sensor.value - sensor.sentValue)))
+                {
+                    flush(now);
+                }
+            }
+        }
+
+        autoapp::service::SensorScheduler::TimePoint deadline;
+        if(scheduler.getNextDeadline(deadline) && deadline <= now)
+        {
+            flush(now);
+        }
+
+        schedulingTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    printf("%u s, IMU at %u Hz\n", duration, imuRate);
+
+    for(const auto& sensor : sensors)
+    {
+        printf("  %-8s %3u Hz: %7llu samples, %6llu events sent\n", sensor.name, sensor.rate,
+               static_cast<unsigned long long>(sensor.samplesCount), static_cast<unsigned long long>(sensor.eventsCount));
+    }
+
+    const double samplesCount = static_cast<double>(scheduler.getSamplesCount());
+    printf("  samples in: %llu (%.0f/s), indications out: %llu (%.1f/s), sensor events out: %llu, %.2f events per indication\n",
+           static_cast<unsigned long long>(scheduler.getSamplesCount()), samplesCount / duration,
+           static_cast<unsigned long long>(scheduler.getIndicationsCount()), static_cast<double>(scheduler.getIndicationsCount()) / duration,
+           static_cast<unsigned long long>(scheduler.getSensorEventsCount()),
+           static_cast<double>(scheduler.getSensorEventsCount()) / std::max<uint64_t>(1, scheduler.getIndicationsCount()));
+    printf("  without batching: %.0f indications/s, scheduling cost: %.0f ns per sample\n",
+           samplesCount / duration, schedulingTime / std::max(1.0, samplesCount));
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc > 3)
+    {
+        printf("usage: %s [<seconds> [<imu rate>]]\n", argv[0]);
+        printf("Feeds simulated accelerometer and gyroscope samples (default %u Hz), 10 Hz GPS and 20 Hz speed\n", cDefaultImuRate);
+        printf("through the sensor scheduler and reports what would be sent. GPS and speed use the SensorService\n");
+        printf("policies, the IMU sensors are limited to 20 Hz with a small minimum delta.\n");
+        return 2;
+    }
+
+    const uint32_t duration = argc >= 2 ? static_cast<uint32_t>(std::stoul(argv[1])) : cDefaultDuration;
+    const uint32_t imuRate = argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : cDefaultImuRate;
+
+    runBenchmark(duration, imuRate);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <new>
+#include <f1x/openauto/shmclient/SharedMemoryLayout.h>
+#include <f1x/openauto/shmclient/SharedMemoryClient.h>
+
+struct openauto_shm_client
+{
+    const uint8_t* map;
+    size_t size;
+    const openauto_shm_header* header;
+    uint64_t lastFrameNumber;
+};
+
+openauto_shm_client* openauto_shm_open(const char* name)
+{
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat status;
+    if(fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(openauto_shm_header))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void* map = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    const auto header = static_cast<const openauto_shm_header*>(map);
+    const bool valid = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == OPENAUTO_SHM_MAGIC &&
+                       header->version == OPENAUTO_SHM_VERSION &&
+                       header->slot_count == OPENAUTO_SHM_SLOTS &&
+                       header->data_offset + header->slot_size * header->slot_count <= static_cast<uint64_t>(status.st_size);
+
+    auto client = valid ? new(std::nothrow) openauto_shm_client : nullptr;
+    if(client == nullptr)
+    {
+        munmap(map, status.st_size);
+        return nullptr;
+    }
+
+    client->map = static_cast<const uint8_t*>(map);
+    client->size = status.st_size;
+    client->header = header;
+    client->lastFrameNumber = 0;
+    return client;
+}
+
+void openauto_shm_close(openauto_shm_client* client)
+{
+    if(client != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(client->map), client->size);
+        delete client;
+    }
+}
+
+int openauto_shm_is_active(const openauto_shm_client* client)
+{
+    return __atomic_load_n(&client->header->active, __ATOMIC_ACQUIRE) != 0;
+}
+
+int openauto_shm_acquire(openauto_shm_client* client, openauto_shm_frame* frame)
+{
+    const auto header = client->header;
+
+    if(__atomic_load_n(&header->frames_count, __ATOMIC_ACQUIRE) == client->lastFrameNumber)
+    {
+        return 0;
+    }
+
+    const uint32_t index = __atomic_load_n(&header->latest, __ATOMIC_ACQUIRE);
+    if(index >= OPENAUTO_SHM_SLOTS)
+    {
+        return 0;
+    }
+
+    const auto& slot = header->slots[index];
+    const uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+
+    // odd means the writer lapped the reader and is refilling this slot already
+    if(sequence & 1)
+    {
+        return 0;
+    }
+
+    const uint8_t* data = client->map + header->data_offset + header->slot_size * index;
+
+    frame->format = header->format;
+    frame->width = slot.width;
+    frame->height = slot.height;
+    frame->frame_number = slot.frame_number;
+    frame->timestamp = slot.timestamp;
+    frame->slot = index;
+    frame->sequence = sequence;
+
+    for(int i = 0; i < 3; ++i)
+    {
+        frame->planes[i] = data + (slot.offsets[i] < header->slot_size ? slot.offsets[i] : 0);
+        frame->strides[i] = slot.strides[i];
+    }
+
+    if(!openauto_shm_validate(client, frame))
+    {
+        return 0;
+    }
+
+    client->lastFrameNumber = frame->frame_number;
+    return 1;
+}
+
+int openauto_shm_validate(const openauto_shm_client* client, const openauto_shm_frame* frame)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&client->header->slots[frame->slot].sequence, __ATOMIC_RELAXED) == frame->sequence;
+}
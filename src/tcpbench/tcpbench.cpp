@@ -0,0 +1,173 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <f1x/openauto/autoapp/TCP/SocketTuner.hpp>
+
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+constexpr size_t cDefaultRoundTrips = 200;
+constexpr size_t cDefaultMegabytes = 512;
+constexpr size_t cHeaderSize = 4;
+constexpr size_t cPayloadSize = 100;
+constexpr size_t cChunkSize = 65536;
+
+// The head unit connects to the phone, so the tuned socket is the client. The listening side plays the
+// phone and is left at the kernel defaults.
+void connect(boost::asio::io_service& ioService, const autoapp::configuration::TCPTuningProfile& profile,
+             boost::asio::ip::tcp::socket& headUnit, boost::asio::ip::tcp::socket& phone)
+{
+    boost::asio::ip::tcp::acceptor acceptor(ioService, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+    autoapp::tcp::SocketTuner tuner(profile);
+    tuner.prepare(headUnit, "127.0.0.1");
+    headUnit.connect(acceptor.local_endpoint());
+    acceptor.accept(phone);
+    tuner.apply(headUnit);
+}
+
+// The head unit sends a frame as header and payload in two writes, like the messenger does, and waits for
+// a one byte reply. With Nagle the payload is held back until the header is acknowledged.
+double measureRoundTrip(const autoapp::configuration::TCPTuningProfile& profile, size_t roundTrips)
+{
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::socket headUnit(ioService);
+    boost::asio::ip::tcp::socket phone(ioService);
+    connect(ioService, profile, headUnit, phone);
+
+    std::thread phoneThread([&phone, roundTrips]() {
+        std::vector<uint8_t> frame(cHeaderSize + cPayloadSize);
+        const uint8_t reply = 0;
+
+        for(size_t i = 0; i < roundTrips; ++i)
+        {
+            boost::asio::read(phone, boost::asio::buffer(frame));
+            boost::asio::write(phone, boost::asio::buffer(&reply, 1));
+        }
+    });
+
+    const std::vector<uint8_t> header(cHeaderSize);
+    const std::vector<uint8_t> payload(cPayloadSize);
+    uint8_t reply;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    for(size_t i = 0; i < roundTrips; ++i)
+    {
+        boost::asio::write(headUnit, boost::asio::buffer(header));
+        boost::asio::write(headUnit, boost::asio::buffer(payload));
+        boost::asio::read(headUnit, boost::asio::buffer(&reply, 1));
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    phoneThread.join();
+
+    return static_cast<double>(elapsed) / roundTrips;
+}
+
+// The phone streams as fast as it can, the head unit reads in chunks the size of a video frame burst.
+double measureThroughput(const autoapp::configuration::TCPTuningProfile& profile, size_t megabytes)
+{
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::socket headUnit(ioService);
+    boost::asio::ip::tcp::socket phone(ioService);
+    connect(ioService, profile, headUnit, phone);
+
+    const size_t totalSize = megabytes * 1024 * 1024;
+
+    std::thread phoneThread([&phone, totalSize]() {
+        const std::vector<uint8_t> chunk(cChunkSize);
+
+        for(size_t written = 0; written < totalSize; written += chunk.size())
+        {
+            boost::asio::write(phone, boost::asio::buffer(chunk, std::min(chunk.size(), totalSize - written)));
+        }
+    });
+
+    std::vector<uint8_t> chunk(cChunkSize);
+    size_t received = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    while(received < totalSize)
+    {
+        received += headUnit.read_some(boost::asio::buffer(chunk));
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    phoneThread.join();
+
+    return static_cast<double>(totalSize) / std::max<int64_t>(1, elapsed);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+
+    if(argc > 3)
+    {
+        printf("usage: %s [<round trips> [<megabytes>]]\n", argv[0]);
+        printf("Measures the effect of the TCP tuning profile over loopback: the round trip of a small frame\n");
+        printf("written as header and payload, with and without TCP_NODELAY, and the bulk read throughput\n");
+        printf("with the kernel default receive buffer and the configured one. Loopback has no real RTT, so\n");
+        printf("the receive buffer matters much less here than over Wi-Fi.\n");
+        return 2;
+    }
+
+    const size_t roundTrips = argc >= 2 ? std::stoul(argv[1]) : cDefaultRoundTrips;
+    const size_t megabytes = argc == 3 ? std::stoul(argv[2]) : cDefaultMegabytes;
+
+    autoapp::configuration::TCPTuningProfile tuned;
+    autoapp::configuration::TCPTuningProfile untuned = tuned;
+    untuned.noDelay = false;
+    untuned.quickAck = false;
+    untuned.receiveBufferSize = 0;
+
+    try
+    {
+        const double nagleRoundTrip = measureRoundTrip(untuned, roundTrips);
+        const double noDelayRoundTrip = measureRoundTrip(tuned, roundTrips);
+        printf("round trip over %zu frames: %.1f us with Nagle, %.1f us with TCP_NODELAY\n", roundTrips, nagleRoundTrip, noDelayRoundTrip);
+
+        const double defaultThroughput = measureThroughput(untuned, megabytes);
+        const double tunedThroughput = measureThroughput(tuned, megabytes);
+        printf("read throughput over %zu MiB: %.0f MB/s with the default buffer, %.0f MB/s with a %u byte request\n",
+               megabytes, defaultThroughput, tunedThroughput, tuned.receiveBufferSize);
+    }
+    catch(const boost::system::system_error& se)
+    {
+        printf("error: %s\n", se.what());
+        return 1;
+    }
+
+    return 0;
+}
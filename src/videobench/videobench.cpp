@@ -0,0 +1,313 @@
+/*
+*  This file is part of openauto project.
+*  Copyright (C) 2018 f1x.studio (Michal Szwaj)
+*
+*  openauto is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 3 of the License, or
+*  (at your option) any later version.
+
+*  openauto is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with openauto. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <QApplication>
+#include <f1x/openauto/Common/Log.hpp>
+#include <f1x/openauto/autoapp/Configuration/Configuration.hpp>
+#include <f1x/openauto/autoapp/Projection/DumpingVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/NullVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/QtVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/OMXVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/DRMVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/SharedMemoryVideoOutput.hpp>
+#include <f1x/openauto/autoapp/Projection/VideoDecoder.hpp>
+
+namespace aasdk = f1x::aasdk;
+namespace autoapp = f1x::openauto::autoapp;
+
+namespace
+{
+
+struct Record
+{
+    uint64_t timestamp;
+    aasdk::common::Data payload;
+};
+
+#ifdef USE_AVCODEC
+// Decodes and discards, the cost of software decoding without any presentation.
+class DecodeOnlyVideoOutput: public autoapp::projection::NullVideoOutput
+{
+public:
+    using NullVideoOutput::NullVideoOutput;
+
+    bool open() override
+    {
+        return decoder_.open();
+    }
+
+    void write(uint64_t, const aasdk::common::DataConstBuffer& buffer) override
+    {
+        if(!decoder_.decode(buffer, [](const AVFrame*) {}))
+        {
+            ++decodeErrorsCount_;
+        }
+    }
+
+    void stop() override
+    {
+        decoder_.close();
+    }
+
+    uint64_t getDecodeErrorsCount() const override
+    {
+        return decodeErrorsCount_;
+    }
+
+private:
+    autoapp::projection::VideoDecoder decoder_;
+    uint64_t decodeErrorsCount_ = 0;
+};
+#endif
+
+constexpr uint64_t cMaxRecordSize = 16 * 1024 * 1024;
+
+uint64_t getLittleEndian(const uint8_t* source, size_t size)
+{
+    uint64_t value = 0;
+    for(size_t i = 0; i < size; ++i)
+    {
+        value |= static_cast<uint64_t>(source[i]) << (i * 8);
+    }
+    return value;
+}
+
+// A dump cut short by a crash or a full disk is replayed up to its last complete record.
+bool readDump(const std::string& path, std::vector<Record>& records, uint64_t& droppedRecordsCount)
+{
+    using autoapp::projection::DumpingVideoOutput;
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == nullptr)
+    {
+        OPENAUTO_LOG(error) << "[videobench] cannot open " << path;
+        return false;
+    }
+
+    uint8_t header[12];
+    const bool valid = fread(header, 1, 8, file) == 8 &&
+                       getLittleEndian(header, 4) == DumpingVideoOutput::cMagic &&
+                       getLittleEndian(header + 4, 4) >= 1 && getLittleEndian(header + 4, 4) <= DumpingVideoOutput::cVersion;
+
+    if(!valid)
+    {
+        OPENAUTO_LOG(error) << "[videobench] " << path << " is not a valid video dump.";
+        fclose(file);
+        return false;
+    }
+
+    droppedRecordsCount = 0;
+    bool truncated = false;
+
+    while(true)
+    {
+        const auto headerSize = fread(header, 1, sizeof(header), file);
+        if(headerSize != sizeof(header))
+        {
+            truncated = headerSize != 0;
+            break;
+        }
+
+        const auto size = getLittleEndian(header + 8, 4);
+        if(size == DumpingVideoOutput::cDroppedRecordsMarker)
+        {
+            droppedRecordsCount += getLittleEndian(header, 8);
+            continue;
+        }
+        else if(size > cMaxRecordSize)
+        {
+            OPENAUTO_LOG(warning) << "[videobench] " << path << " is corrupted after " << records.size() << " records.";
+            break;
+        }
+
+        Record record;
+        record.timestamp = getLittleEndian(header, 8);
+        record.payload.resize(size);
+        if(fread(record.payload.data(), 1, record.payload.size(), file) != record.payload.size())
+        {
+            truncated = true;
+            break;
+        }
+
+        records.push_back(std::move(record));
+    }
+
+    fclose(file);
+
+    if(truncated)
+    {
+        OPENAUTO_LOG(warning) << "[videobench] " << path << " is truncated after " << records.size() << " records.";
+    }
+
+    return !records.empty();
+}
+
+autoapp::projection::IVideoOutput::Pointer createVideoOutput(const std::string& name, autoapp::configuration::IConfiguration::Pointer configuration)
+{
+    using namespace autoapp::projection;
+
+    if(name == "null")
+    {
+        return std::make_shared<NullVideoOutput>(std::move(configuration));
+    }
+    else if(name == "qt")
+    {
+        return IVideoOutput::Pointer(new QtVideoOutput(std::move(configuration)), std::bind(&QObject::deleteLater, std::placeholders::_1));
+    }
+#ifdef USE_AVCODEC
+    else if(name == "avcodec")
+    {
+        return std::make_shared<DecodeOnlyVideoOutput>(std::move(configuration));
+    }
+#endif
+#ifdef USE_OMX
+    else if(name == "omx")
+    {
+        return std::make_shared<OMXVideoOutput>(std::move(configuration));
+    }
+#endif
+#ifdef USE_DRM
+    else if(name == "drm")
+    {
+        return std::make_shared<DRMVideoOutput>(std::move(configuration));
+    }
+#endif
+#ifdef USE_SHM
+    else if(name == "shm")
+    {
+        return std::make_shared<SharedMemoryVideoOutput>(std::move(configuration));
+    }
+#endif
+
+    return nullptr;
+}
+
+double getCpuTime()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()))];
+}
+
+// Writes every record as fast as the output takes it. Outputs that decode asynchronously report
+// a backlog, the replay waits for it to drain rather than overrunning the output.
+int runBenchmark(const std::string& path, const std::string& outputName)
+{
+    std::vector<Record> records;
+    uint64_t droppedRecordsCount = 0;
+    if(!readDump(path, records, droppedRecordsCount))
+    {
+        return 1;
+    }
+
+    auto videoOutput = createVideoOutput(outputName, std::make_shared<autoapp::configuration::Configuration>());
+    if(videoOutput == nullptr)
+    {
+        OPENAUTO_LOG(error) << "[videobench] unknown or unsupported output: " << outputName;
+        return 1;
+    }
+
+    if(!videoOutput->open() || !videoOutput->init())
+    {
+        OPENAUTO_LOG(error) << "[videobench] " << outputName << " output cannot be opened.";
+        return 1;
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(records.size());
+    size_t bytesCount = 0;
+
+    const auto cpuTimeStart = getCpuTime();
+    const auto start = std::chrono::steady_clock::now();
+
+    for(const auto& record : records)
+    {
+        const auto waitStart = std::chrono::steady_clock::now();
+        while(videoOutput->getBacklog() >= 0.5f && videoOutput->getBacklog() < 1.0f &&
+              std::chrono::steady_clock::now() - waitStart < std::chrono::seconds(1))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const auto writeStart = std::chrono::steady_clock::now();
+        videoOutput->write(record.timestamp, aasdk::common::DataConstBuffer(record.payload));
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - writeStart).count());
+        bytesCount += record.payload.size();
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto cpuTime = getCpuTime() - cpuTimeStart;
+    const auto decodeErrorsCount = videoOutput->getDecodeErrorsCount();
+    videoOutput->stop();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("output:           %s\n", outputName.c_str());
+    printf("frames:           %zu (%.1f MB)\n", records.size(), bytesCount / 1e6);
+    printf("dropped in dump:  %llu\n", static_cast<unsigned long long>(droppedRecordsCount));
+    printf("elapsed:          %.3f s\n", elapsed);
+    printf("throughput:       %.1f fps, %.1f Mbit/s\n", records.size() / elapsed, bytesCount * 8 / elapsed / 1e6);
+    printf("latency p50:      %.3f ms\n", getPercentile(latencies, 0.5));
+    printf("latency p90:      %.3f ms\n", getPercentile(latencies, 0.9));
+    printf("latency p99:      %.3f ms\n", getPercentile(latencies, 0.99));
+    printf("latency max:      %.3f ms\n", latencies.back());
+    printf("cpu per frame:    %.3f ms\n", cpuTime * 1000 / records.size());
+    printf("decode errors:    %llu\n", static_cast<unsigned long long>(decodeErrorsCount));
+
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    QApplication qApplication(argc, argv);
+
+    if(argc < 2)
+    {
+        printf("usage: %s <video dump> [null|qt|avcodec|omx|drm|shm]\n", argv[0]);
+        printf("Video dumps are recorded by autoapp when Video.DumpFile is set, one numbered file per session.\n");
+        return 2;
+    }
+
+    const std::string path = argv[1];
+    const std::string outputName = argc > 2 ? argv[2] : "null";
+
+    // the Qt output needs the application event loop, the replay runs beside it
+    int result = 0;
+    std::thread benchmark([&]() {
+        result = runBenchmark(path, outputName);
+        QMetaObject::invokeMethod(&qApplication, "quit", Qt::QueuedConnection);
+    });
+
+    qApplication.exec();
+    benchmark.join();
+
+    return result;
+}